@@ -0,0 +1,196 @@
+/*
+ * Small benchmark harness shared by the programs in ./bench.
+ *
+ * A case is timed in samples, each sample is a batch of ops timed with one
+ * pair of clock reads. ns/op and ops/s come from the total, p50/p99 from the
+ * per-op latency of the samples. Results are written as one JSON document.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#pragma once
+
+/*
+ * Clock & Heap
+ */
+static inline double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static inline int64_t bench_heap_bytes(void)
+{
+    // bytes handed out by malloc including chunk overhead, 0 when unknown
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    return (int64_t)(mi.uordblks + mi.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+static inline int bench_dtlb_open(void)
+{
+    // counter of the dTLB load misses of this thread in user space, -1 when
+    // there is none (no PMU in a VM, perf_event_paranoid)
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static inline uint64_t bench_counter_read(int fd)
+{
+    uint64_t ret = 0;
+#if defined(__linux__)
+    if (fd < 0 || read(fd, &ret, sizeof(ret)) != sizeof(ret))
+        ret = 0;
+#endif
+    return ret;
+}
+
+static inline uint64_t bench_rand(uint64_t *state)
+{
+    // xorshift64*
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Result
+ */
+typedef struct
+{
+    const char *container;
+    const char *op;
+    uint32_t dsize;
+    uint64_t len;
+    uint32_t threads; // 0 for single threaded benches
+    uint64_t tlb_misses; // dTLB load misses over all samples, 0 when not counted
+    uint64_t ops;
+    double ns_total;
+    double bytes_per_elem;
+
+    double *samples; // ns per op of every sample
+    uint64_t nsamples;
+    uint64_t capacity;
+} Bench_Result_t;
+
+static inline void bench_result_init(Bench_Result_t *self, const char *container, const char *op, uint32_t dsize, uint64_t len)
+{
+    memset(self, 0, sizeof(Bench_Result_t));
+    self->container = container;
+    self->op = op;
+    self->dsize = dsize;
+    self->len = len;
+}
+
+static inline void bench_result_sample(Bench_Result_t *self, double ns, uint64_t ops)
+{
+    if (ops == 0)
+        return;
+    if (self->nsamples == self->capacity)
+    {
+        self->capacity = self->capacity ? self->capacity * 2 : 256;
+        self->samples = (double *)realloc(self->samples, self->capacity * sizeof(double));
+        if (self->samples == NULL)
+        {
+            perror("bench");
+            exit(1);
+        }
+    }
+    self->samples[self->nsamples++] = ns / (double)ops;
+    self->ns_total += ns;
+    self->ops += ops;
+}
+
+static int _bench_cmp_double_(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static inline double bench_result_percentile(Bench_Result_t *self, double pct)
+{
+    if (self->nsamples == 0)
+        return 0;
+    qsort(self->samples, self->nsamples, sizeof(double), _bench_cmp_double_);
+    uint64_t idx = (uint64_t)(pct / 100.0 * (double)(self->nsamples - 1) + 0.5);
+    return self->samples[idx];
+}
+
+static inline void bench_result_free(Bench_Result_t *self)
+{
+    free(self->samples);
+    self->samples = NULL;
+    self->nsamples = 0;
+    self->capacity = 0;
+}
+
+/*
+ * JSON output
+ */
+typedef struct
+{
+    FILE *out;
+    uint64_t count;
+} Bench_Json_t;
+
+static inline void bench_json_begin(Bench_Json_t *self, FILE *out, const char *suite)
+{
+    self->out = out;
+    self->count = 0;
+    fprintf(out, "{\n  \"suite\": \"%s\",\n  \"results\": [", suite);
+}
+
+static inline void bench_json_result(Bench_Json_t *self, Bench_Result_t *res)
+{
+    double ns_per_op = res->ops ? res->ns_total / (double)res->ops : 0;
+    fprintf(self->out,
+            "%s\n    {\"container\": \"%s\", \"op\": \"%s\", \"dsize\": %u, \"len\": %llu, "
+            "\"ops\": %llu, \"ns_per_op\": %.3f, \"ops_per_s\": %.1f, \"p50_ns\": %.3f, \"p99_ns\": %.3f, "
+            "\"bytes_per_elem\": %.2f",
+            self->count ? "," : "", res->container, res->op, res->dsize, (unsigned long long)res->len,
+            (unsigned long long)res->ops, ns_per_op, ns_per_op > 0 ? 1e9 / ns_per_op : 0,
+            bench_result_percentile(res, 50), bench_result_percentile(res, 99), res->bytes_per_elem);
+    if (res->threads)
+        fprintf(self->out, ", \"threads\": %u", res->threads);
+    if (res->tlb_misses && res->ops)
+        fprintf(self->out, ", \"tlb_misses_per_op\": %.4f", (double)res->tlb_misses / (double)res->ops);
+    fprintf(self->out, "}");
+    fflush(self->out);
+    self->count++;
+}
+
+static inline void bench_json_end(Bench_Json_t *self)
+{
+    fprintf(self->out, "\n  ]\n}\n");
+    fflush(self->out);
+}
@@ -0,0 +1,116 @@
+/*
+ * Per element cost of the batch push/pop calls against the single element
+ * calls, for List_t, Slist_t and Xlist_t at batch sizes 1 to 4096. One op is
+ * one element, len is the batch size. JSON on stdout.
+ */
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+#include "cctrlib/slist.h"
+#include "cctrlib/xlist.h"
+
+#define BENCH_ELEMS (1 << 20)
+#define BENCH_DSIZE 16
+#define BENCH_MAX_BATCH 4096
+
+static uint8_t _array_[BENCH_MAX_BATCH * BENCH_DSIZE];
+static uint8_t _out_[BENCH_MAX_BATCH * BENCH_DSIZE];
+
+/*
+ * Every container gets the same four entry points so one driver times them all
+ */
+typedef struct
+{
+    const char *name;
+    void *(*construct)(void);
+    void (*destroy)(void *self);
+    void (*push_back)(void *self, void *data);
+    void (*pop_front)(void *self);
+    void (*push_back_n)(void *self, void *array, uint32_t asize);
+    void (*pop_front_n)(void *self, void *out, uint32_t n);
+} Bench_Ops_t;
+
+static void *_list_construct_(void) { return list_init(BENCH_DSIZE); }
+static void _list_destroy_(void *self) { list_destroy((List_t *)self); }
+static void _list_push_back_(void *self, void *data) { list_push_back((List_t *)self, data); }
+static void _list_pop_front_(void *self) { list_pop_front((List_t *)self); }
+static void _list_push_back_n_(void *self, void *array, uint32_t asize) { list_push_back_n((List_t *)self, array, asize); }
+static void _list_pop_front_n_(void *self, void *out, uint32_t n) { list_pop_front_n((List_t *)self, out, n); }
+
+static void *_slist_construct_(void) { return slist_construct(BENCH_DSIZE); }
+static void _slist_destroy_(void *self) { slist_destroy((Slist_t *)self); }
+static void _slist_push_back_(void *self, void *data) { slist_push_back((Slist_t *)self, data); }
+static void _slist_pop_front_(void *self) { slist_pop_front((Slist_t *)self); }
+static void _slist_push_back_n_(void *self, void *array, uint32_t asize) { slist_push_back_n((Slist_t *)self, array, asize); }
+static void _slist_pop_front_n_(void *self, void *out, uint32_t n) { slist_pop_front_n((Slist_t *)self, out, n); }
+
+static void *_xlist_construct_(void) { return xlist_construct(BENCH_DSIZE); }
+static void _xlist_destroy_(void *self) { xlist_destroy((Xlist_t *)self); }
+static void _xlist_push_back_(void *self, void *data) { xlist_push_back((Xlist_t *)self, data); }
+static void _xlist_pop_front_(void *self) { xlist_pop_front((Xlist_t *)self); }
+static void _xlist_push_back_n_(void *self, void *array, uint32_t asize) { xlist_push_back_n((Xlist_t *)self, array, asize); }
+static void _xlist_pop_front_n_(void *self, void *out, uint32_t n) { xlist_pop_front_n((Xlist_t *)self, out, n); }
+
+static const Bench_Ops_t _containers_[] = {
+    {"List_t", _list_construct_, _list_destroy_, _list_push_back_, _list_pop_front_, _list_push_back_n_, _list_pop_front_n_},
+    {"Slist_t", _slist_construct_, _slist_destroy_, _slist_push_back_, _slist_pop_front_, _slist_push_back_n_, _slist_pop_front_n_},
+    {"Xlist_t", _xlist_construct_, _xlist_destroy_, _xlist_push_back_, _xlist_pop_front_, _xlist_push_back_n_, _xlist_pop_front_n_},
+};
+
+static void _bench_(Bench_Json_t *json, const Bench_Ops_t *ops, uint32_t batch, int batched)
+{
+    Bench_Result_t push;
+    Bench_Result_t pop;
+    bench_result_init(&push, ops->name, batched ? "push_back_n" : "push_back", BENCH_DSIZE, batch);
+    bench_result_init(&pop, ops->name, batched ? "pop_front_n" : "pop_front", BENCH_DSIZE, batch);
+
+    void *self = ops->construct();
+    int64_t heap = bench_heap_bytes();
+    for (uint32_t done = 0; done < BENCH_ELEMS; done += batch)
+    {
+        double t0 = bench_now_ns();
+        if (batched)
+            ops->push_back_n(self, _array_, batch);
+        else
+            for (uint32_t i = 0; i < batch; i++)
+                ops->push_back(self, _array_ + i * BENCH_DSIZE);
+        bench_result_sample(&push, bench_now_ns() - t0, batch);
+    }
+    push.bytes_per_elem = pop.bytes_per_elem = (double)(bench_heap_bytes() - heap) / BENCH_ELEMS;
+
+    for (uint32_t done = 0; done < BENCH_ELEMS; done += batch)
+    {
+        double t0 = bench_now_ns();
+        if (batched)
+            ops->pop_front_n(self, _out_, batch);
+        else
+            for (uint32_t i = 0; i < batch; i++)
+            {
+                memcpy(_out_ + i * BENCH_DSIZE, _array_, BENCH_DSIZE); // the batch call copies out too
+                ops->pop_front(self);
+            }
+        bench_result_sample(&pop, bench_now_ns() - t0, batch);
+    }
+    ops->destroy(self);
+
+    bench_json_result(json, &push);
+    bench_json_result(json, &pop);
+    bench_result_free(&push);
+    bench_result_free(&pop);
+}
+
+int main(void)
+{
+    for (uint32_t i = 0; i < sizeof(_array_); i++)
+        _array_[i] = (uint8_t)i;
+
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "batch");
+    for (size_t c = 0; c < sizeof(_containers_) / sizeof(_containers_[0]); c++)
+        for (uint32_t batch = 1; batch <= BENCH_MAX_BATCH; batch *= 4)
+        {
+            _bench_(&json, &_containers_[c], batch, 0);
+            _bench_(&json, &_containers_[c], batch, 1);
+        }
+    bench_json_end(&json);
+    return 0;
+}
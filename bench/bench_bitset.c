@@ -0,0 +1,151 @@
+/*
+ * Bitset_t against the List_t of one byte flags it replaces, lengths 10^4 to
+ * max_len with half of the flags set at random. count and and are one op per
+ * flag and report the bytes per flag, the list is left out past 10^7 flags.
+ * index builds the rank / select index, rank and select are one op per call.
+ * JSON on stdout.
+ *
+ * usage: bench_bitset [-n max_len] [-o ops]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/bitset.h"
+#include "cctrlib/list.h"
+
+#define BENCH_TARGET_WALK 20000000 // flags visited per case
+
+static volatile uint64_t _sink_;
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 100000000;
+    uint64_t ops = 1000000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'o':
+            ops = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-o ops]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "bitset");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        Bitset_t *a = bitset_construct(len);
+        Bitset_t *b = bitset_construct(len);
+        for (uint64_t i = 0; i < len / 2; i++)
+        {
+            bitset_set(a, bench_rand(&seed) % len);
+            bitset_set(b, bench_rand(&seed) % len);
+        }
+        uint64_t reps = BENCH_TARGET_WALK / len + 1;
+        Bench_Result_t res;
+
+        if (len <= BENCH_TARGET_WALK / 2)
+        {
+            int64_t heap = bench_heap_bytes();
+            List_t *la = list_init(1);
+            List_t *lb = list_init(1);
+            for (uint64_t i = 0; i < len; i++)
+            {
+                list_push_back(la, &(uint8_t){(uint8_t)bitset_test(a, i)});
+                list_push_back(lb, &(uint8_t){(uint8_t)bitset_test(b, i)});
+            }
+            double bytes = (double)(bench_heap_bytes() - heap) / (double)(2 * len);
+
+            bench_result_init(&res, "List_t", "count", 1, len);
+            res.bytes_per_elem = bytes;
+            uint64_t sum = 0;
+            for (uint64_t r = 0; r < reps; r++)
+            {
+                double t0 = bench_now_ns();
+                for (List_Node_t *node = la->head; node != NULL; node = node->next)
+                    sum += *(uint8_t *)node->data;
+                bench_result_sample(&res, bench_now_ns() - t0, len);
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            bench_result_init(&res, "List_t", "and", 1, len);
+            res.bytes_per_elem = bytes;
+            for (uint64_t r = 0; r < reps; r++)
+            {
+                double t0 = bench_now_ns();
+                List_Node_t *y = lb->head;
+                for (List_Node_t *x = la->head; x != NULL; x = x->next, y = y->next)
+                    *(uint8_t *)x->data &= *(uint8_t *)y->data;
+                bench_result_sample(&res, bench_now_ns() - t0, len);
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+            _sink_ = sum;
+            list_destroy(la);
+            list_destroy(lb);
+        }
+
+        bench_result_init(&res, "Bitset_t", "count", 1, len);
+        res.bytes_per_elem = (double)(a->nwords * sizeof(uint64_t)) / (double)len;
+        uint64_t sum = 0;
+        for (uint64_t r = 0; r < reps; r++)
+        {
+            double t0 = bench_now_ns();
+            sum += bitset_count(a);
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+        }
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+
+        bench_result_init(&res, "Bitset_t", "and", 1, len);
+        res.bytes_per_elem = (double)(a->nwords * sizeof(uint64_t)) / (double)len;
+        for (uint64_t r = 0; r < reps; r++)
+        {
+            double t0 = bench_now_ns();
+            bitset_and(a, b);
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+        }
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+
+        bench_result_init(&res, "Bitset_t", "index", 1, len);
+        double t0 = bench_now_ns();
+        bitset_index(a);
+        bench_result_sample(&res, bench_now_ns() - t0, len);
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+
+        uint64_t ones = bitset_count(a);
+        bench_result_init(&res, "Bitset_t", "rank", 1, len);
+        t0 = bench_now_ns();
+        for (uint64_t i = 0; i < ops; i++)
+            sum += bitset_rank(a, bench_rand(&seed) % len);
+        bench_result_sample(&res, bench_now_ns() - t0, ops);
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+
+        bench_result_init(&res, "Bitset_t", "select", 1, len);
+        t0 = bench_now_ns();
+        for (uint64_t i = 0; i < ops && ones; i++)
+            sum += bitset_select(a, bench_rand(&seed) % ones);
+        bench_result_sample(&res, bench_now_ns() - t0, ops);
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+        _sink_ = sum;
+
+        bitset_destroy(a);
+        bitset_destroy(b);
+    }
+    bench_json_end(&json);
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Bset_t against a sorted List_t, uint64_t keys 0, 2, 4, .. at lengths 10^4
+ * to max_len. The list is searched by walking from the head until the key is
+ * reached, an insert walks again to link the node. find looks up present keys,
+ * insert_erase adds an absent key and removes it, range reads the 100 keys
+ * from a lower bound, bulk_load is one op per key. JSON on stdout.
+ *
+ * usage: bench_bset [-n max_len] [-o ops]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/bset.h"
+
+#define BENCH_TARGET_WALK 20000000 // list nodes visited per case
+
+static volatile uint64_t _sink_;
+
+static void _visit_(const void *key, void *value, void *ctx)
+{
+    *(uint64_t *)ctx += *(const uint64_t *)key;
+}
+
+// position of the first element >= key, the node in *node
+static uint32_t _list_lower_(List_t *list, uint64_t key, List_Node_t **node)
+{
+    uint32_t pos = 0;
+    List_Node_t *ptr = list->head;
+    while (ptr != NULL && *(uint64_t *)ptr->data < key)
+    {
+        ptr = ptr->next;
+        pos++;
+    }
+    *node = ptr;
+    return pos;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint64_t ops = 1000000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'o':
+            ops = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-o ops]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "bset");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        uint64_t *keys = (uint64_t *)malloc(len * sizeof(uint64_t));
+        for (uint64_t i = 0; i < len; i++)
+            keys[i] = 2 * i;
+
+        Bench_Result_t res;
+        bench_result_init(&res, "Bset_t", "bulk_load", sizeof(uint64_t), len);
+        double t0 = bench_now_ns();
+        Bset_t *set = bset_from_sorted(sizeof(uint64_t), 0, NULL, NULL, keys, NULL, len);
+        bench_result_sample(&res, bench_now_ns() - t0, len);
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+
+        List_t *list = list_init(sizeof(uint64_t));
+        list_push_back_n(list, keys, (uint32_t)len);
+        uint64_t list_ops = BENCH_TARGET_WALK / len + 1;
+
+        for (int c = 0; c < 2; c++)
+        {
+            uint64_t n = c ? list_ops : ops;
+            const char *name = c ? "List_t" : "Bset_t";
+            uint64_t sum = 0;
+            List_Node_t *node;
+
+            bench_result_init(&res, name, "find", sizeof(uint64_t), len);
+            t0 = bench_now_ns();
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint64_t key = 2 * (bench_rand(&seed) % len);
+                if (c)
+                {
+                    _list_lower_(list, key, &node);
+                    sum += node != NULL && *(uint64_t *)node->data == key;
+                }
+                else
+                    sum += bset_contains(set, &key);
+            }
+            bench_result_sample(&res, bench_now_ns() - t0, n);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            bench_result_init(&res, name, "insert_erase", sizeof(uint64_t), len);
+            t0 = bench_now_ns();
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint64_t key = 2 * (bench_rand(&seed) % len) + 1;
+                if (c)
+                {
+                    uint32_t pos = _list_lower_(list, key, &node);
+                    list_insert(list, pos, &key);
+                    list_erase(list, pos);
+                }
+                else
+                {
+                    bset_insert(set, &key, NULL);
+                    bset_erase(set, &key);
+                }
+            }
+            bench_result_sample(&res, bench_now_ns() - t0, n);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            bench_result_init(&res, name, "range100", sizeof(uint64_t), len);
+            t0 = bench_now_ns();
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint64_t lo = 2 * (bench_rand(&seed) % len);
+                uint64_t hi = lo + 200;
+                if (c)
+                {
+                    _list_lower_(list, lo, &node);
+                    for (; node != NULL && *(uint64_t *)node->data < hi; node = node->next)
+                        sum += *(uint64_t *)node->data;
+                }
+                else
+                    bset_range(set, &lo, &hi, _visit_, &sum);
+            }
+            bench_result_sample(&res, bench_now_ns() - t0, n);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+            _sink_ = sum;
+        }
+
+        list_destroy(list);
+        bset_destroy(set);
+        free(keys);
+    }
+    bench_json_end(&json);
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Mixed find / rotate workload on Clist_t against a List_t behind one mutex,
+ * 1 to max_threads threads, uint64_t elements. A read is a find of a random
+ * element, a write pops the front and pushes it back at the tail. One op is
+ * one find or one rotation, ns_per_op is wall time over the ops of all
+ * threads. JSON on stdout.
+ *
+ * usage: bench_clist [-n len] [-t max_threads] [-w write_percent] [-o ops_per_thread]
+ */
+#include <getopt.h>
+#include <pthread.h>
+#include "bench/bench.h"
+#include "cctrlib/clist.h"
+#include "cctrlib/list.h"
+
+typedef struct
+{
+    List_t *list;
+    pthread_mutex_t *lock;
+    Clist_t *clist;
+    uint64_t len;
+    uint32_t write_percent;
+    uint64_t ops;
+    uint64_t seed;
+    uint64_t hits;
+} Bench_Clist_Worker_t;
+
+static void *_worker_(void *arg)
+{
+    Bench_Clist_Worker_t *worker = (Bench_Clist_Worker_t *)arg;
+    for (uint64_t i = 0; i < worker->ops; i++)
+    {
+        uint64_t r = bench_rand(&worker->seed);
+        uint64_t value = (r >> 8) % worker->len;
+        if (r % 100 < worker->write_percent)
+        {
+            if (worker->clist)
+            {
+                if (clist_pop_front(worker->clist, &value))
+                    clist_push_back(worker->clist, &value);
+            }
+            else
+            {
+                pthread_mutex_lock(worker->lock);
+                value = *(uint64_t *)list_front(worker->list);
+                list_pop_front(worker->list);
+                list_push_back(worker->list, &value);
+                pthread_mutex_unlock(worker->lock);
+            }
+        }
+        else if (worker->clist)
+            worker->hits += clist_find(worker->clist, &value) >= 0;
+        else
+        {
+            pthread_mutex_lock(worker->lock);
+            worker->hits += list_find(worker->list, &value) >= 0;
+            pthread_mutex_unlock(worker->lock);
+        }
+    }
+    return NULL;
+}
+
+static volatile uint64_t _sink_;
+
+int main(int argc, char **argv)
+{
+    uint64_t len = 1000;
+    uint32_t max_threads = 32;
+    uint32_t write_percent = 10;
+    uint64_t ops = 2000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:w:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            len = strtoull(optarg, NULL, 0);
+            break;
+        case 't':
+            max_threads = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            write_percent = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            ops = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n len] [-t max_threads] [-w write_percent] [-o ops_per_thread]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    List_t *list = list_init(sizeof(uint64_t));
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    Clist_t *clist = clist_construct(sizeof(uint64_t));
+    for (uint64_t i = 0; i < len; i++)
+    {
+        list_push_back(list, &i);
+        clist_push_back(clist, &i);
+    }
+
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "clist");
+    pthread_t *threads = (pthread_t *)malloc(max_threads * sizeof(pthread_t));
+    Bench_Clist_Worker_t *workers = (Bench_Clist_Worker_t *)malloc(max_threads * sizeof(Bench_Clist_Worker_t));
+    for (uint32_t nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+        for (int c = 0; c < 2; c++)
+        {
+            Bench_Result_t res;
+            bench_result_init(&res, c ? "Clist_t" : "List_t+mutex", "find_rotate", sizeof(uint64_t), len);
+            res.threads = nthreads;
+            for (uint32_t t = 0; t < nthreads; t++)
+                workers[t] = (Bench_Clist_Worker_t){c ? NULL : list, &lock, c ? clist : NULL, len,
+                                                    write_percent, ops, 0x9E3779B97F4A7C15ULL * (t + 1), 0};
+
+            double t0 = bench_now_ns();
+            for (uint32_t t = 0; t < nthreads; t++)
+                pthread_create(&threads[t], NULL, _worker_, &workers[t]);
+            for (uint32_t t = 0; t < nthreads; t++)
+                pthread_join(threads[t], NULL);
+            bench_result_sample(&res, bench_now_ns() - t0, ops * nthreads);
+
+            for (uint32_t t = 0; t < nthreads; t++)
+                _sink_ += workers[t].hits;
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+        }
+    bench_json_end(&json);
+
+    free(threads);
+    free(workers);
+    list_destroy(list);
+    clist_destroy(clist);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * List_t traversal (a list_find miss, one op per node) on a freshly built
+ * list, after churn and after list_compact, uint64_t elements. Churn rounds
+ * erase a random tenth of the list and push as many new elements at the back,
+ * which land in the freed holes all over the heap. JSON on stdout.
+ *
+ * usage: bench_compact [-n max_len] [-c churn_rounds] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+
+static uint64_t _seed_ = 0x9E3779B97F4A7C15ULL;
+
+static int _drop_(void *data, void *ctx)
+{
+    return bench_rand(&_seed_) % 10 == 0;
+}
+
+static void _find_(Bench_Json_t *json, List_t *list, const char *op, uint32_t rounds)
+{
+    Bench_Result_t res;
+    bench_result_init(&res, "List_t", op, sizeof(uint64_t), list->size);
+    uint64_t missing = UINT64_MAX;
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        double t0 = bench_now_ns();
+        int32_t pos = list_find(list, &missing);
+        bench_result_sample(&res, bench_now_ns() - t0, list->size);
+        if (pos != -1)
+            abort();
+    }
+    bench_json_result(json, &res);
+    bench_result_free(&res);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint32_t churn = 20;
+    uint32_t rounds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'c':
+            churn = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-c churn_rounds] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "compact");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        List_t *list = list_init(sizeof(uint64_t));
+        for (uint64_t i = 0; i < len; i++)
+            list_push_back(list, &i);
+        _find_(&json, list, "find_fresh", rounds);
+
+        for (uint32_t c = 0; c < churn; c++)
+        {
+            uint32_t dropped = list_remove_if(list, _drop_, NULL);
+            for (uint32_t i = 0; i < dropped; i++)
+            {
+                uint64_t tmp = bench_rand(&_seed_) >> 1;
+                list_push_back(list, &tmp);
+            }
+        }
+        _find_(&json, list, "find_churned", rounds);
+
+        Bench_Result_t res;
+        bench_result_init(&res, "List_t", "compact", sizeof(uint64_t), len);
+        double t0 = bench_now_ns();
+        list_compact(list);
+        bench_result_sample(&res, bench_now_ns() - t0, len);
+        bench_json_result(&json, &res);
+        bench_result_free(&res);
+
+        _find_(&json, list, "find_compacted", rounds);
+        list_destroy(list);
+    }
+    bench_json_end(&json);
+    return 0;
+}
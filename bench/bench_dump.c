@@ -0,0 +1,108 @@
+/*
+ * Dumps of a List_t with len elements of dsize bytes, lengths 10^4 to
+ * max_len, into a file (/dev/null by default). printf is the former
+ * list_print, one fprintf per byte, against list_dump in the hex, csv and
+ * raw modes. One op per element. JSON on stdout.
+ *
+ * usage: bench_dump [-n max_len] [-d dsize] [-f path]
+ */
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include "bench/bench.h"
+#include "cctrlib/dump.h"
+
+static volatile uint64_t _sink_;
+
+static void _printf_dump_(List_t *list, FILE *file)
+{
+    int itr = 0;
+    for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next)
+    {
+        fprintf(file, "itr-%i: ", itr++);
+        uint8_t *data = (uint8_t *)ptr->data;
+        for (uint32_t i = 0; i < list->dsize; i++)
+            fprintf(file, "%02x ", data[i]);
+        fprintf(file, "\n");
+    }
+    fflush(file);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 1000000;
+    uint32_t dsize = 16;
+    const char *path = "/dev/null";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:f:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'd':
+            dsize = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            path = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-d dsize] [-f path]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+    const int fd = fileno(file);
+    const char *names[] = {"printf", "hex", "csv", "raw"};
+    const Cctr_Dump_Mode_t modes[] = {CCTR_DUMP_HEX, CCTR_DUMP_HEX, CCTR_DUMP_CSV, CCTR_DUMP_RAW};
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    uint8_t *elem = (uint8_t *)malloc(dsize);
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "dump");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        List_t *list = list_init(dsize);
+        for (uint64_t i = 0; i < len; i++)
+        {
+            for (uint32_t k = 0; k < dsize; k++)
+                elem[k] = (uint8_t)bench_rand(&seed);
+            list_push_back(list, elem);
+        }
+
+        for (int c = 0; c < 4; c++)
+        {
+            Bench_Result_t res;
+            bench_result_init(&res, "List_t", names[c], dsize, len);
+            ftruncate(fd, 0);
+            lseek(fd, 0, SEEK_SET);
+            double t0 = bench_now_ns();
+            if (c == 0)
+                _printf_dump_(list, file);
+            else
+            {
+                Cctr_Dump_t dump;
+                cctr_dump_init(&dump, fd, modes[c], NULL, 0);
+                list_dump(list, &dump, 0, UINT64_MAX);
+                cctr_dump_close(&dump);
+            }
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+            _sink_ += (uint64_t)lseek(fd, 0, SEEK_CUR);
+        }
+        list_destroy(list);
+    }
+    bench_json_end(&json);
+    free(elem);
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Whole list comparison and hashing, lists of len elements of dsize bytes at
+ * lengths 10^3 to max_len. at_memcmp is the former way, list_at and memcmp
+ * for every position (only up to 10^4), against list_equal and
+ * list_compare on two equal lists, list_hash after a change and again
+ * without one (cached), and array_hash over the same payloads in one run.
+ * One op per element, cached is per call. JSON on stdout.
+ *
+ * usage: bench_hash [-n max_len] [-d dsize] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/array.h"
+#include "cctrlib/list.h"
+
+static volatile uint64_t _sink_;
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 1000000;
+    uint32_t dsize = 8;
+    uint32_t rounds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'd':
+            dsize = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-d dsize] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "hash");
+    for (uint64_t len = 1000; len <= max_len; len *= 10)
+    {
+        uint8_t *data = (uint8_t *)malloc(len * dsize);
+        for (uint64_t i = 0; i < len * dsize; i++)
+            data[i] = (uint8_t)bench_rand(&seed);
+        List_t *a = list_init(dsize);
+        List_t *b = list_init(dsize);
+        for (uint64_t i = 0; i < len; i++)
+        {
+            list_push_back(a, data + i * dsize);
+            list_push_back(b, data + i * dsize);
+        }
+        Array_t *array = array_from_array(data, len, dsize);
+
+        const char *ops[] = {"at_memcmp", "equal", "compare", "hash", "cached", "array_hash"};
+        for (int c = 0; c < 6; c++)
+        {
+            if (c == 0 && len > 10000)
+                continue;
+            Bench_Result_t res;
+            bench_result_init(&res, c == 5 ? "Array_t" : "List_t", ops[c], dsize, len);
+            for (uint32_t r = 0; r < rounds; r++)
+            {
+                uint64_t sum = 0;
+                uint64_t n = len;
+                if (c == 3)
+                    list_touch(a);
+                else if (c == 4)
+                    sum += list_hash(a);
+                double t0 = bench_now_ns();
+                switch (c)
+                {
+                case 0:
+                    for (int32_t i = 0; i < (int32_t)len; i++)
+                        sum += !memcmp(list_at(a, i), list_at(b, i), dsize);
+                    break;
+                case 1:
+                    sum += list_equal(a, b);
+                    break;
+                case 2:
+                    sum += list_compare(a, b);
+                    break;
+                case 3:
+                    sum += list_hash(a);
+                    break;
+                case 4:
+                    sum += list_hash(a);
+                    n = 1;
+                    break;
+                default:
+                    sum += array_hash(array);
+                }
+                bench_result_sample(&res, bench_now_ns() - t0, n);
+                _sink_ = sum;
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+        }
+        list_destroy(a);
+        list_destroy(b);
+        array_destroy(array);
+        free(data);
+    }
+    bench_json_end(&json);
+    return 0;
+}
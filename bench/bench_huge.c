@@ -0,0 +1,140 @@
+/*
+ * List_t and Array_t on malloc storage against their huge page versions
+ * (list_init_huge, array_construct_huge), 16 byte elements at lengths 10^5 to
+ * max_len. The lists are shuffled against allocation order like in
+ * bench_prefetch, find looks for a missing key (one op per node visited) and
+ * clear frees every node. Array gather reads random elements. dTLB load
+ * misses per op are added when the cpu counter can be opened. JSON on stdout,
+ * the huge page bytes the kernel actually used on stderr.
+ *
+ * usage: bench_huge [-n max_len] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+#include "cctrlib/array.h"
+#include "cctrlib/sort.h"
+
+typedef struct
+{
+    uint64_t key;
+    uint64_t value;
+} Bench_Record_t;
+
+static volatile uint64_t _sink_;
+
+static uint64_t _anon_huge_kb_(void)
+{
+    // AnonHugePages of the process, 0 when unknown
+    uint64_t ret = 0;
+    char line[256];
+    FILE *fp = fopen("/proc/self/smaps_rollup", "r");
+    if (fp == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+        if (sscanf(line, "AnonHugePages: %lu kB", &ret) == 1)
+            break;
+    fclose(fp);
+    return ret;
+}
+
+static List_t *_shuffled_(uint64_t len, int huge, uint64_t *seed)
+{
+    // sorting on a random key relinks the nodes in random memory order
+    List_t *ret = huge ? list_init_huge(sizeof(Bench_Record_t)) : list_init(sizeof(Bench_Record_t));
+    for (uint64_t i = 0; i < len; i++)
+    {
+        Bench_Record_t tmp = {bench_rand(seed), i};
+        list_push_back(ret, &tmp);
+    }
+    list_sort_key(ret, NULL, 0, sizeof(uint64_t), 0);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint32_t rounds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int tlb = bench_dtlb_open();
+    if (tlb < 0)
+        fprintf(stderr, "bench_huge: no dTLB counter, times only\n");
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "huge");
+    for (uint64_t len = 100000; len <= max_len; len *= 10)
+    {
+        for (int huge = 0; huge < 2; huge++)
+        {
+            const char *list_name = huge ? "List_t+huge" : "List_t";
+            const char *array_name = huge ? "Array_t+huge" : "Array_t";
+            List_t *list = _shuffled_(len, huge, &seed);
+            Bench_Record_t missing = {0, UINT64_MAX};
+            Bench_Result_t res;
+
+            bench_result_init(&res, list_name, "find", sizeof(Bench_Record_t), len);
+            for (uint32_t r = 0; r < rounds; r++)
+            {
+                uint64_t m0 = bench_counter_read(tlb);
+                double t0 = bench_now_ns();
+                _sink_ = (uint64_t)list_find_data_range(list, &missing.value, sizeof(uint64_t), sizeof(uint64_t));
+                bench_result_sample(&res, bench_now_ns() - t0, len);
+                res.tlb_misses += bench_counter_read(tlb) - m0;
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+            if (huge)
+                fprintf(stderr, "bench_huge: len %llu, %llu kB in huge pages\n",
+                        (unsigned long long)len, (unsigned long long)_anon_huge_kb_());
+
+            bench_result_init(&res, list_name, "clear", sizeof(Bench_Record_t), len);
+            uint64_t m0 = bench_counter_read(tlb);
+            double t0 = bench_now_ns();
+            list_destroy(list);
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+            res.tlb_misses += bench_counter_read(tlb) - m0;
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            Array_t *array = huge ? array_construct_huge(sizeof(Bench_Record_t)) : array_construct(sizeof(Bench_Record_t));
+            for (uint64_t i = 0; i < len; i++)
+                array_push_back(array, &(Bench_Record_t){i, i});
+            bench_result_init(&res, array_name, "gather", sizeof(Bench_Record_t), len);
+            for (uint32_t r = 0; r < rounds; r++)
+            {
+                uint64_t sum = 0;
+                m0 = bench_counter_read(tlb);
+                t0 = bench_now_ns();
+                for (uint64_t i = 0; i < len; i++)
+                    sum += ((Bench_Record_t *)array_at(array, bench_rand(&seed) % len))->value;
+                bench_result_sample(&res, bench_now_ns() - t0, len);
+                res.tlb_misses += bench_counter_read(tlb) - m0;
+                _sink_ = sum;
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+            array_destroy(array);
+        }
+    }
+    bench_json_end(&json);
+    if (tlb >= 0)
+        close(tlb);
+    return 0;
+}
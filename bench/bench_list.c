@@ -0,0 +1,381 @@
+/*
+ * List_t operations across element sizes and list lengths, JSON on stdout.
+ *
+ * usage: bench_list [-n max_len] [-s dsize,...] [-o op,...] [-m max_bytes]
+ */
+#include <getopt.h>
+#include <assert.h>
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+
+#define BENCH_TARGET_OPS 1000000   // calls per case for O(1) operations
+#define BENCH_TARGET_WALK 20000000 // nodes visited per case for O(n) operations
+#define BENCH_MAX_BATCH 256
+#define BENCH_MAX_DSIZE 256
+
+static const uint32_t _dsizes_[] = {1, 4, 8, 64, 256};
+static const uint64_t _lens_[] = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+static uint64_t _seed_ = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t _min_(uint64_t a, uint64_t b) { return a < b ? a : b; }
+static uint64_t _max_(uint64_t a, uint64_t b) { return a > b ? a : b; }
+
+static void _elem_(uint8_t *elem, uint32_t dsize, uint64_t value)
+{
+    memset(elem, 0, dsize);
+    memcpy(elem, &value, _min_(dsize, sizeof(value)));
+}
+
+static List_t *_build_(uint32_t dsize, uint64_t len)
+{
+    uint8_t elem[BENCH_MAX_DSIZE];
+    List_t *list = list_init(dsize);
+    for (uint64_t i = 0; i < len; i++)
+    {
+        _elem_(elem, dsize, i);
+        list_push_back(list, elem);
+    }
+    return list;
+}
+
+static double _bytes_per_elem_(uint32_t dsize, uint64_t len)
+{
+    int64_t heap = bench_heap_bytes();
+    List_t *list = _build_(dsize, len);
+    double ret = (double)(bench_heap_bytes() - heap) / (double)len;
+    list_destroy(list);
+    return ret;
+}
+
+static uint64_t _walk_calls_(uint64_t len)
+{
+    return _max_(1, _min_(BENCH_TARGET_WALK / len, 100000));
+}
+
+// ----------------------------------------------------------------------
+/*
+ * Cases, one call of the operation is one op
+ */
+static void _bench_push_(Bench_Result_t *res, uint32_t dsize, uint64_t len, int front)
+{
+    uint8_t elem[BENCH_MAX_DSIZE];
+    uint64_t rounds = _max_(1, BENCH_TARGET_OPS / len);
+    uint64_t batch = _min_(len, BENCH_MAX_BATCH);
+
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        List_t *list = list_init(dsize);
+        for (uint64_t i = 0; i < len; i += batch)
+        {
+            uint64_t n = _min_(batch, len - i);
+            double t0 = bench_now_ns();
+            for (uint64_t j = 0; j < n; j++)
+            {
+                _elem_(elem, dsize, i + j);
+                if (front)
+                    list_push_front(list, elem);
+                else
+                    list_push_back(list, elem);
+            }
+            bench_result_sample(res, bench_now_ns() - t0, n);
+        }
+        list_destroy(list);
+    }
+}
+static void _bench_push_back_(Bench_Result_t *res, uint32_t dsize, uint64_t len) { _bench_push_(res, dsize, len, 0); }
+static void _bench_push_front_(Bench_Result_t *res, uint32_t dsize, uint64_t len) { _bench_push_(res, dsize, len, 1); }
+
+static void _bench_pop_(Bench_Result_t *res, uint32_t dsize, uint64_t len, int front)
+{
+    uint64_t rounds = _max_(1, BENCH_TARGET_OPS / len);
+    uint64_t batch = _min_(len, BENCH_MAX_BATCH);
+
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        List_t *list = _build_(dsize, len);
+        for (uint64_t i = 0; i < len; i += batch)
+        {
+            uint64_t n = _min_(batch, len - i);
+            double t0 = bench_now_ns();
+            for (uint64_t j = 0; j < n; j++)
+            {
+                if (front)
+                    list_pop_front(list);
+                else
+                    list_pop_back(list);
+            }
+            bench_result_sample(res, bench_now_ns() - t0, n);
+        }
+        list_destroy(list);
+    }
+}
+static void _bench_pop_front_(Bench_Result_t *res, uint32_t dsize, uint64_t len) { _bench_pop_(res, dsize, len, 1); }
+static void _bench_pop_back_(Bench_Result_t *res, uint32_t dsize, uint64_t len) { _bench_pop_(res, dsize, len, 0); }
+
+static void _bench_at_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    uint64_t calls = _walk_calls_(len);
+    uint64_t batch = _max_(1, calls / BENCH_MAX_BATCH);
+    List_t *list = _build_(dsize, len);
+
+    for (uint64_t i = 0; i < calls; i += batch)
+    {
+        uint64_t n = _min_(batch, calls - i);
+        double t0 = bench_now_ns();
+        for (uint64_t j = 0; j < n; j++)
+        {
+            void *volatile data = list_at(list, (int32_t)(bench_rand(&_seed_) % len));
+            (void)data;
+        }
+        bench_result_sample(res, bench_now_ns() - t0, n);
+    }
+    list_destroy(list);
+}
+
+static void _bench_find_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    uint8_t elem[BENCH_MAX_DSIZE];
+    uint64_t calls = _walk_calls_(len);
+    uint64_t batch = _max_(1, calls / BENCH_MAX_BATCH);
+    List_t *list = _build_(dsize, len);
+
+    for (uint64_t i = 0; i < calls; i += batch)
+    {
+        uint64_t n = _min_(batch, calls - i);
+        double t0 = bench_now_ns();
+        for (uint64_t j = 0; j < n; j++)
+        {
+            _elem_(elem, dsize, bench_rand(&_seed_) % len);
+            volatile int32_t pos = list_find(list, elem);
+            (void)pos;
+        }
+        bench_result_sample(res, bench_now_ns() - t0, n);
+    }
+    list_destroy(list);
+}
+
+static void _bench_insert_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    // the list is rebuilt once it has grown by half so the walk length stays around len
+    uint8_t elem[BENCH_MAX_DSIZE];
+    uint64_t calls = _walk_calls_(len);
+    uint64_t per_round = _max_(1, _min_(calls, len / 2));
+    uint64_t batch = _max_(1, _min_(per_round, calls / BENCH_MAX_BATCH));
+
+    for (uint64_t done = 0; done < calls; done += per_round)
+    {
+        List_t *list = _build_(dsize, len);
+        for (uint64_t i = 0; i < per_round; i += batch)
+        {
+            uint64_t n = _min_(batch, per_round - i);
+            double t0 = bench_now_ns();
+            for (uint64_t j = 0; j < n; j++)
+            {
+                _elem_(elem, dsize, i + j);
+                list_insert(list, (int64_t)(bench_rand(&_seed_) % list->size), elem);
+            }
+            bench_result_sample(res, bench_now_ns() - t0, n);
+        }
+        list_destroy(list);
+    }
+}
+
+static void _bench_erase_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    uint64_t calls = _walk_calls_(len);
+    uint64_t per_round = _max_(1, _min_(calls, len / 2));
+    uint64_t batch = _max_(1, _min_(per_round, calls / BENCH_MAX_BATCH));
+
+    for (uint64_t done = 0; done < calls; done += per_round)
+    {
+        List_t *list = _build_(dsize, len);
+        for (uint64_t i = 0; i < per_round; i += batch)
+        {
+            uint64_t n = _min_(batch, per_round - i);
+            double t0 = bench_now_ns();
+            for (uint64_t j = 0; j < n; j++)
+                list_erase(list, (int32_t)(bench_rand(&_seed_) % list->size));
+            bench_result_sample(res, bench_now_ns() - t0, n);
+        }
+        list_destroy(list);
+    }
+}
+
+static void _bench_insert_list_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    // inserts a 16 element list, rebuilt like in _bench_insert_
+    uint64_t calls = _walk_calls_(len);
+    uint64_t per_round = _max_(1, _min_(calls, len / 32));
+    uint64_t batch = _max_(1, _min_(per_round, calls / BENCH_MAX_BATCH));
+    List_t *object = _build_(dsize, 16);
+
+    for (uint64_t done = 0; done < calls; done += per_round)
+    {
+        List_t *list = _build_(dsize, len);
+        for (uint64_t i = 0; i < per_round; i += batch)
+        {
+            uint64_t n = _min_(batch, per_round - i);
+            double t0 = bench_now_ns();
+            for (uint64_t j = 0; j < n; j++)
+                list_insert_list(list, (int32_t)(bench_rand(&_seed_) % list->size), object);
+            bench_result_sample(res, bench_now_ns() - t0, n);
+        }
+        list_destroy(list);
+    }
+    list_destroy(object);
+}
+
+static void _bench_copy_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    uint64_t calls = _min_(_walk_calls_(len), 1000);
+    List_t *list = _build_(dsize, len);
+
+    for (uint64_t i = 0; i < calls; i++)
+    {
+        double t0 = bench_now_ns();
+        List_t *cpy = list_copy(list);
+        bench_result_sample(res, bench_now_ns() - t0, 1);
+        list_destroy(cpy);
+    }
+    list_destroy(list);
+}
+
+static void _bench_clear_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    uint64_t calls = _min_(_walk_calls_(len), 1000);
+
+    for (uint64_t i = 0; i < calls; i++)
+    {
+        List_t *list = _build_(dsize, len);
+        double t0 = bench_now_ns();
+        list_clear(list);
+        bench_result_sample(res, bench_now_ns() - t0, 1);
+        list_destroy(list);
+    }
+}
+
+static int _bench_is_odd_(void *data, void *ctx)
+{
+    (void)ctx;
+    return *(uint8_t *)data & 1;
+}
+
+static void _bench_remove_if_(Bench_Result_t *res, uint32_t dsize, uint64_t len)
+{
+    // purges every other element in one call
+    uint64_t calls = _min_(_walk_calls_(len), 1000);
+
+    for (uint64_t i = 0; i < calls; i++)
+    {
+        List_t *list = _build_(dsize, len);
+        double t0 = bench_now_ns();
+        list_remove_if(list, _bench_is_odd_, NULL);
+        bench_result_sample(res, bench_now_ns() - t0, 1);
+        list_destroy(list);
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    void (*run)(Bench_Result_t *res, uint32_t dsize, uint64_t len);
+    uint32_t copies; // lists of len alive at the same time, for the memory limit
+} Bench_Case_t;
+
+static const Bench_Case_t _cases_[] = {
+    {"push_back", _bench_push_back_, 1},
+    {"push_front", _bench_push_front_, 1},
+    {"pop_front", _bench_pop_front_, 1},
+    {"pop_back", _bench_pop_back_, 1},
+    {"at", _bench_at_, 1},
+    {"find", _bench_find_, 1},
+    {"insert", _bench_insert_, 1},
+    {"erase", _bench_erase_, 1},
+    {"insert_list", _bench_insert_list_, 1},
+    {"copy", _bench_copy_, 2},
+    {"clear", _bench_clear_, 1},
+    {"remove_if", _bench_remove_if_, 1},
+};
+
+// ----------------------------------------------------------------------
+static int _selected_(const char *list, const char *name)
+{
+    // list is comma separated, NULL selects everything
+    if (list == NULL)
+        return 1;
+    size_t len = strlen(name);
+    for (const char *p = list; p != NULL; p = strchr(p, ','))
+    {
+        if (*p == ',')
+            p++;
+        if (!strncmp(p, name, len) && (p[len] == ',' || p[len] == '\0'))
+            return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint64_t max_bytes = 2ULL << 30;
+    const char *dsizes = NULL;
+    const char *ops = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:o:m:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 's':
+            dsizes = optarg;
+            break;
+        case 'o':
+            ops = optarg;
+            break;
+        case 'm':
+            max_bytes = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-s dsize,...] [-o op,...] [-m max_bytes]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "list");
+
+    for (size_t c = 0; c < sizeof(_cases_) / sizeof(_cases_[0]); c++)
+    {
+        if (!_selected_(ops, _cases_[c].name))
+            continue;
+        for (size_t d = 0; d < sizeof(_dsizes_) / sizeof(_dsizes_[0]); d++)
+        {
+            char dname[16];
+            snprintf(dname, sizeof(dname), "%u", _dsizes_[d]);
+            if (!_selected_(dsizes, dname))
+                continue;
+            for (size_t l = 0; l < sizeof(_lens_) / sizeof(_lens_[0]) && _lens_[l] <= max_len; l++)
+            {
+                // rough node + payload footprint, malloc overhead included
+                uint64_t footprint = _lens_[l] * (sizeof(List_Node_t) + _dsizes_[d] + 32) * _cases_[c].copies;
+                if (footprint > max_bytes)
+                    continue;
+
+                fprintf(stderr, "%s dsize=%u len=%llu\n", _cases_[c].name, _dsizes_[d], (unsigned long long)_lens_[l]);
+                Bench_Result_t res;
+                bench_result_init(&res, "List_t", _cases_[c].name, _dsizes_[d], _lens_[l]);
+                res.bytes_per_elem = _bytes_per_elem_(_dsizes_[d], _lens_[l]);
+                _cases_[c].run(&res, _dsizes_[d], _lens_[l]);
+                bench_json_result(&json, &res);
+                bench_result_free(&res);
+            }
+        }
+    }
+
+    bench_json_end(&json);
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Generic List_t against the type specialized list_tmpl.h lists for 4, 8
+ * and 64 byte elements: push_back, find of the last element, clear.
+ */
+#include <assert.h>
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+
+typedef struct
+{
+    uint64_t word[8];
+} Blob64_t;
+
+#define CCTR_T uint32_t
+#include "cctrlib/list_tmpl.h"
+
+#define CCTR_T uint64_t
+#include "cctrlib/list_tmpl.h"
+
+#define CCTR_T Blob64_t
+#define CCTR_EQ(a, b) (!memcmp(&(a), &(b), sizeof(Blob64_t)))
+#include "cctrlib/list_tmpl.h"
+
+#define BENCH_LEN 1000000
+
+static void _report_(const char *name, uint32_t dsize, double push, double find, double clear)
+{
+    printf("%-8s dsize=%-3u push_back %6.2f ns/op  find %6.2f ns/node  clear %6.2f ns/node\n",
+           name, dsize, push / BENCH_LEN, find / BENCH_LEN, clear / BENCH_LEN);
+}
+
+static void _bench_generic_(uint32_t dsize)
+{
+    uint8_t elem[sizeof(Blob64_t)] = {0};
+    List_t *list = list_init(dsize);
+
+    double t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_LEN; i++)
+    {
+        memcpy(elem, &i, sizeof(i));
+        list_push_back(list, elem);
+    }
+    double t1 = bench_now_ns();
+    uint32_t last = BENCH_LEN - 1;
+    memcpy(elem, &last, sizeof(last));
+    volatile int32_t pos = list_find(list, elem);
+    double t2 = bench_now_ns();
+    list_destroy(list);
+    double t3 = bench_now_ns();
+
+    assert(pos == BENCH_LEN - 1);
+    (void)pos;
+    _report_("List_t", dsize, t1 - t0, t2 - t1, t3 - t2);
+}
+
+#define BENCH_TYPED(name, type, make)                        \
+    static void _bench_##name##_(void)                       \
+    {                                                        \
+        List_##name *list = list_##name##_init();            \
+        double t0 = bench_now_ns();                              \
+        for (uint32_t i = 0; i < BENCH_LEN; i++)             \
+            list_##name##_push_back(list, make(i));          \
+        double t1 = bench_now_ns();                              \
+        volatile int32_t pos =                               \
+            list_##name##_find(list, make(BENCH_LEN - 1));   \
+        double t2 = bench_now_ns();                              \
+        list_##name##_destroy(list);                         \
+        double t3 = bench_now_ns();                              \
+        assert(pos == BENCH_LEN - 1);                        \
+        (void)pos;                                           \
+        _report_(#name, sizeof(type), t1 - t0, t2 - t1, t3 - t2); \
+    }
+
+#define MAKE_INT(i) (i)
+static inline Blob64_t _make_blob64_(uint32_t i)
+{
+    Blob64_t ret = {{i}};
+    return ret;
+}
+
+BENCH_TYPED(uint32_t, uint32_t, MAKE_INT)
+BENCH_TYPED(uint64_t, uint64_t, MAKE_INT)
+BENCH_TYPED(Blob64_t, Blob64_t, _make_blob64_)
+
+int main(void)
+{
+    _bench_generic_(sizeof(uint32_t));
+    _bench_uint32_t_();
+    _bench_generic_(sizeof(uint64_t));
+    _bench_uint64_t_();
+    _bench_generic_(sizeof(Blob64_t));
+    _bench_Blob64_t_();
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Parallel traversal over List_t (through a segment index) and Array_t at 1 to
+ * max_threads threads, uint64_t elements. One op is one element visited, the
+ * find_first target sits at 3/4 of the sequence. JSON on stdout.
+ *
+ * usage: bench_parallel [-n len] [-t max_threads] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/parallel.h"
+
+static int _is_odd_(void *data, void *ctx)
+{
+    return (*(uint64_t *)data & 1) != 0;
+}
+
+static int _is_target_(void *data, void *ctx)
+{
+    return *(uint64_t *)data == *(uint64_t *)ctx;
+}
+
+static void _touch_(void *data, void *ctx)
+{
+    *(uint64_t *)data ^= 1; // applied twice per round pair, values come back
+}
+
+static void _sum_(void *acc, void *data, void *ctx)
+{
+    *(uint64_t *)acc += *(uint64_t *)data;
+}
+
+static void _combine_(void *acc, void *part, void *ctx)
+{
+    *(uint64_t *)acc += *(uint64_t *)part;
+}
+
+static volatile uint64_t _sink_;
+
+/*
+ * op 0 count, 1 for_each, 2 reduce, 3 find_first
+ */
+static const char *_ops_[] = {"par_count", "par_for_each", "par_reduce", "par_find_first"};
+
+static void _run_(List_t *list, List_Index_t *index, Array_t *array, Cctr_Pool_t *pool, int op, uint64_t target)
+{
+    uint64_t sum = 0;
+    switch (op)
+    {
+    case 0:
+        _sink_ = list ? list_par_count(list, index, pool, _is_odd_, NULL) : array_par_count(array, pool, _is_odd_, NULL);
+        break;
+    case 1:
+        if (list)
+            list_par_for_each(list, index, pool, _touch_, NULL);
+        else
+            array_par_for_each(array, pool, _touch_, NULL);
+        break;
+    case 2:
+        if (list)
+            list_par_reduce(list, index, pool, &sum, sizeof(sum), _sum_, _combine_, NULL);
+        else
+            array_par_reduce(array, pool, &sum, sizeof(sum), _sum_, _combine_, NULL);
+        _sink_ = sum;
+        break;
+    default:
+        _sink_ = list ? list_par_find_first(list, index, pool, _is_target_, &target)
+                      : array_par_find_first(array, pool, _is_target_, &target);
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t len = 10000000;
+    uint32_t max_threads = 16;
+    uint32_t rounds = 10;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            len = strtoull(optarg, NULL, 0);
+            break;
+        case 't':
+            max_threads = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n len] [-t max_threads] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // the list is shuffled in memory the way a long lived list is
+    List_t *list = list_init(sizeof(uint64_t));
+    Array_t *array = array_construct(sizeof(uint64_t));
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (uint64_t i = 0; i < len; i++)
+    {
+        uint64_t tmp = bench_rand(&seed) & ~1ULL;
+        if (bench_rand(&seed) & 1)
+            list_push_front(list, &tmp);
+        else
+            list_push_back(list, &tmp);
+        array_push_back(array, &tmp);
+    }
+    uint64_t target = *(uint64_t *)list_at(list, (int32_t)(len * 3 / 4));
+
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "parallel");
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        Cctr_Pool_t *pool = cctr_pool_construct(threads - 1);
+
+        Bench_Result_t build;
+        bench_result_init(&build, "List_t", "index_build", sizeof(uint64_t), len);
+        build.threads = threads;
+        double t0 = bench_now_ns();
+        List_Index_t *index = list_index_build(list, threads * 4);
+        bench_result_sample(&build, bench_now_ns() - t0, len);
+        bench_json_result(&json, &build);
+        bench_result_free(&build);
+
+        for (int op = 0; op < 4; op++)
+            for (int c = 0; c < 2; c++)
+            {
+                Bench_Result_t res;
+                bench_result_init(&res, c ? "Array_t" : "List_t", _ops_[op], sizeof(uint64_t), len);
+                res.threads = threads;
+                for (uint32_t r = 0; r < rounds; r++)
+                {
+                    t0 = bench_now_ns();
+                    _run_(c ? NULL : list, index, c ? array : NULL, pool, op, target);
+                    bench_result_sample(&res, bench_now_ns() - t0, op == 3 ? len * 3 / 4 : len);
+                }
+                bench_json_result(&json, &res);
+                bench_result_free(&res);
+            }
+
+        list_index_destroy(index);
+        cctr_pool_destroy(pool);
+    }
+    bench_json_end(&json);
+
+    list_destroy(list);
+    array_destroy(array);
+    return 0;
+}
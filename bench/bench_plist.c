@@ -0,0 +1,102 @@
+/*
+ * Plist_t snapshots against List_t deep copies, uint64_t elements, lengths
+ * 10 to max_len. snapshot/copy is one op per call, set_after_snapshot is the
+ * first change after a snapshot (the path copy), walk is one op per element.
+ * JSON on stdout.
+ *
+ * usage: bench_plist [-n max_len] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/plist.h"
+
+static void _visit_(const void *data, void *ctx)
+{
+    *(uint64_t *)ctx += *(const uint64_t *)data;
+}
+
+static volatile uint64_t _sink_;
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 1000000;
+    uint32_t rounds = 100;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "plist");
+    for (uint64_t len = 10; len <= max_len; len *= 10)
+    {
+        List_t *list = list_init(sizeof(uint64_t));
+        Plist_t *plist = plist_construct(sizeof(uint64_t));
+        for (uint64_t i = 0; i < len; i++)
+        {
+            list_push_back(list, &i);
+            plist_push_back(plist, &i);
+        }
+        uint32_t n = len >= 100000 ? rounds / 10 + 1 : rounds;
+        Bench_Result_t copy, snap, set, plist_walk, list_walk;
+        bench_result_init(&copy, "List_t", "copy", sizeof(uint64_t), len);
+        bench_result_init(&snap, "Plist_t", "snapshot", sizeof(uint64_t), len);
+        bench_result_init(&set, "Plist_t", "set_after_snapshot", sizeof(uint64_t), len);
+        bench_result_init(&plist_walk, "Plist_t", "walk", sizeof(uint64_t), len);
+        bench_result_init(&list_walk, "List_t", "walk", sizeof(uint64_t), len);
+
+        for (uint32_t r = 0; r < n; r++)
+        {
+            double t0 = bench_now_ns();
+            List_t *cpy = list_copy(list);
+            bench_result_sample(&copy, bench_now_ns() - t0, 1);
+            list_destroy(cpy);
+
+            t0 = bench_now_ns();
+            Plist_t *snapshot = plist_snapshot(plist);
+            bench_result_sample(&snap, bench_now_ns() - t0, 1);
+
+            uint64_t tmp = r;
+            t0 = bench_now_ns();
+            plist_set(plist, bench_rand(&seed) % len, &tmp);
+            bench_result_sample(&set, bench_now_ns() - t0, 1);
+            plist_destroy(snapshot);
+
+            uint64_t sum = 0;
+            t0 = bench_now_ns();
+            plist_for_each(plist, _visit_, &sum);
+            bench_result_sample(&plist_walk, bench_now_ns() - t0, len);
+
+            t0 = bench_now_ns();
+            for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next)
+                sum += *(uint64_t *)ptr->data;
+            bench_result_sample(&list_walk, bench_now_ns() - t0, len);
+            _sink_ = sum;
+        }
+
+        Bench_Result_t *all[] = {&copy, &snap, &set, &list_walk, &plist_walk};
+        for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+        {
+            bench_json_result(&json, all[i]);
+            bench_result_free(all[i]);
+        }
+        list_destroy(list);
+        plist_destroy(plist);
+    }
+    bench_json_end(&json);
+    return 0;
+}
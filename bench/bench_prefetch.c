@@ -0,0 +1,134 @@
+/*
+ * List_t traversal kernels on lists whose node order is shuffled against
+ * allocation order, 16 byte elements, 10^5 to max_len nodes so the larger
+ * ones do not fit in L2/L3. Build once plain and once with make PREFETCH=1,
+ * the container is reported as "List_t+prefetch" by the second. One op is one
+ * node visited (for at one call). JSON on stdout.
+ *
+ * usage: bench_prefetch [-n max_len] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+#include "cctrlib/sort.h"
+
+#ifdef CCTR_PREFETCH
+#define BENCH_CONTAINER "List_t+prefetch"
+#else
+#define BENCH_CONTAINER "List_t"
+#endif
+
+typedef struct
+{
+    uint64_t key;
+    uint64_t value;
+} Bench_Record_t;
+
+static volatile uint64_t _sink_;
+
+static List_t *_shuffled_(uint64_t len, uint64_t *seed)
+{
+    // sorting on a random key relinks the nodes in random memory order
+    List_t *ret = list_init(sizeof(Bench_Record_t));
+    for (uint64_t i = 0; i < len; i++)
+    {
+        Bench_Record_t tmp = {bench_rand(seed), i};
+        list_push_back(ret, &tmp);
+    }
+    list_sort_key(ret, NULL, 0, sizeof(uint64_t), 0);
+    return ret;
+}
+
+static void _report_(Bench_Json_t *json, Bench_Result_t *res)
+{
+    bench_json_result(json, res);
+    bench_result_free(res);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint32_t rounds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "prefetch");
+    for (uint64_t len = 100000; len <= max_len; len *= 10)
+    {
+        List_t *list = _shuffled_(len, &seed);
+        Bench_Record_t missing = {0, UINT64_MAX};
+        Bench_Result_t res;
+        double t0;
+
+        // the second search pays for the skip array, the first walks the list
+        bench_result_init(&res, BENCH_CONTAINER, "find_first", sizeof(Bench_Record_t), len);
+        _sink_ = list_find(list, &missing);
+        t0 = bench_now_ns();
+        _sink_ = list_find(list, &missing);
+        bench_result_sample(&res, bench_now_ns() - t0, len);
+        _report_(&json, &res);
+
+        bench_result_init(&res, BENCH_CONTAINER, "find", sizeof(Bench_Record_t), len);
+        for (uint32_t r = 0; r < rounds; r++)
+        {
+            t0 = bench_now_ns();
+            _sink_ = list_find(list, &missing);
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+        }
+        _report_(&json, &res);
+
+        bench_result_init(&res, BENCH_CONTAINER, "find_data_range", sizeof(Bench_Record_t), len);
+        for (uint32_t r = 0; r < rounds; r++)
+        {
+            t0 = bench_now_ns();
+            _sink_ = list_find_data_range(list, &missing.value, sizeof(uint64_t), sizeof(uint64_t));
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+        }
+        _report_(&json, &res);
+
+        // random positions, without the array every call walks half the list on average
+        bench_result_init(&res, BENCH_CONTAINER, "at", sizeof(Bench_Record_t), len);
+        uint32_t calls = len >= 1000000 ? 10 : 100;
+        for (uint32_t r = 0; r < rounds; r++)
+        {
+            t0 = bench_now_ns();
+            for (uint32_t i = 0; i < calls; i++)
+                _sink_ = ((Bench_Record_t *)list_at(list, (int32_t)(bench_rand(&seed) % len)))->value;
+            bench_result_sample(&res, bench_now_ns() - t0, calls);
+        }
+        _report_(&json, &res);
+
+        bench_result_init(&res, BENCH_CONTAINER, "copy", sizeof(Bench_Record_t), len);
+        t0 = bench_now_ns();
+        List_t *cpy = list_copy(list);
+        bench_result_sample(&res, bench_now_ns() - t0, len);
+        _report_(&json, &res);
+        list_destroy(cpy);
+
+        bench_result_init(&res, BENCH_CONTAINER, "clear", sizeof(Bench_Record_t), len);
+        t0 = bench_now_ns();
+        list_clear(list);
+        bench_result_sample(&res, bench_now_ns() - t0, len);
+        _report_(&json, &res);
+        list_destroy(list);
+    }
+    bench_json_end(&json);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Cost of giving nodes back on the calling thread, lists of len elements of
+ * dsize bytes at lengths 10^4 to max_len. inline frees in place, deferred
+ * queues with list_defer_free and reclaims outside the timed part, reclaimer
+ * queues while a cctr_reclaim_start thread releases. pop times
+ * list_pop_front in samples of 64 pops (p99 over the samples), destroy one
+ * list_destroy per round (one op per element). JSON on stdout.
+ *
+ * usage: bench_reclaim [-n max_len] [-d dsize] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/list.h"
+#include "cctrlib/reclaim.h"
+
+#define BENCH_POP_SAMPLE 64 // pops per sample
+
+static List_t *_build_(uint64_t len, uint32_t dsize, int defer, uint8_t *elem)
+{
+    List_t *list = list_init(dsize);
+    list_defer_free(list, defer);
+    for (uint64_t i = 0; i < len; i++)
+        list_push_back(list, elem);
+    return list;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 1000000;
+    uint32_t dsize = 64;
+    uint32_t rounds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'd':
+            dsize = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-d dsize] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint8_t *elem = (uint8_t *)calloc(1, dsize);
+    const char *modes[] = {"inline", "deferred", "reclaimer"};
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "reclaim");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        for (int m = 0; m < 3; m++)
+        {
+            if (m == 2 && cctr_reclaim_start(4096, 100) < 0)
+            {
+                perror("cctr_reclaim_start");
+                return 1;
+            }
+            char name[32];
+            snprintf(name, sizeof(name), "List_t/%s", modes[m]);
+
+            Bench_Result_t res;
+            bench_result_init(&res, name, "pop", dsize, len);
+            for (uint32_t r = 0; r < rounds; r++)
+            {
+                List_t *list = _build_(len, dsize, m > 0, elem);
+                while (list->size >= BENCH_POP_SAMPLE)
+                {
+                    double t0 = bench_now_ns();
+                    for (int i = 0; i < BENCH_POP_SAMPLE; i++)
+                        list_pop_front(list);
+                    bench_result_sample(&res, bench_now_ns() - t0, BENCH_POP_SAMPLE);
+                }
+                list_destroy(list);
+                if (m == 1)
+                    cctr_reclaim(UINT64_MAX);
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            bench_result_init(&res, name, "destroy", dsize, len);
+            for (uint32_t r = 0; r < rounds; r++)
+            {
+                List_t *list = _build_(len, dsize, m > 0, elem);
+                double t0 = bench_now_ns();
+                list_destroy(list);
+                bench_result_sample(&res, bench_now_ns() - t0, len);
+                if (m == 1)
+                    cctr_reclaim(UINT64_MAX);
+            }
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            if (m == 2)
+                cctr_reclaim_stop();
+        }
+    }
+    bench_json_end(&json);
+    free(elem);
+    return 0;
+}
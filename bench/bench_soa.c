@@ -0,0 +1,142 @@
+/*
+ * One field search over 32 byte records, len records at lengths 10^4 to
+ * max_len. find looks for an absent value (a full scan), count counts a
+ * value held by every 16th record, for the 1, 4 and 8 byte fields. Soa_t
+ * scans the column, List_t and Array_t use their find_data_range on whole
+ * records (List_t up to 10^6, count as repeated finds). One op per record.
+ * JSON on stdout.
+ *
+ * usage: bench_soa [-n max_len] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/array.h"
+#include "cctrlib/list.h"
+#include "cctrlib/soa.h"
+
+typedef struct
+{
+    uint64_t id;
+    uint32_t key;
+    uint8_t flag;
+    uint8_t pad[3];
+    uint8_t payload[16];
+} Bench_Record_t;
+
+static const Soa_Field_t _fields_[] = {
+    {offsetof(Bench_Record_t, id), sizeof(uint64_t)},
+    {offsetof(Bench_Record_t, key), sizeof(uint32_t)},
+    {offsetof(Bench_Record_t, flag), sizeof(uint8_t)},
+    {offsetof(Bench_Record_t, payload), 16},
+};
+
+static volatile uint64_t _sink_;
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint32_t rounds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    const uint32_t fields[] = {2, 1, 0}; // 1, 4 and 8 bytes
+    char op[32];
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "soa");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        Bench_Record_t *records = (Bench_Record_t *)calloc(len, sizeof(Bench_Record_t));
+        for (uint64_t i = 0; i < len; i++)
+        {
+            // 0 is never a value, 1 is the value of every 16th record
+            uint64_t x = bench_rand(&seed);
+            int hit = (i & 15) == 7;
+            records[i].id = hit ? 1 : (x | 2);
+            records[i].key = hit ? 1 : ((uint32_t)x | 2);
+            records[i].flag = hit ? 1 : ((uint8_t)x | 2);
+        }
+        Soa_t *soa = soa_construct(sizeof(Bench_Record_t), _fields_, 4);
+        soa_push_back_n(soa, records, len);
+        Array_t *array = array_from_array(records, len, sizeof(Bench_Record_t));
+        List_t *list = NULL;
+        if (len <= 1000000)
+        {
+            list = list_init(sizeof(Bench_Record_t));
+            for (uint64_t i = 0; i < len; i++)
+                list_push_back(list, &records[i]);
+        }
+
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            const uint32_t f = fields[k];
+            const uint32_t offset = _fields_[f].offset;
+            const uint32_t size = _fields_[f].size;
+            const uint64_t absent = 0;
+            const uint64_t present = 1;
+            for (int c = 0; c < 3; c++)
+            {
+                if (c == 2 && list == NULL)
+                    continue;
+                const char *name = c == 0 ? "Soa_t" : c == 1 ? "Array_t" : "List_t";
+                for (int count = 0; count < 2; count++)
+                {
+                    snprintf(op, sizeof(op), "%s_%ub", count ? "count" : "find", size);
+                    Bench_Result_t res;
+                    bench_result_init(&res, name, op, sizeof(Bench_Record_t), len);
+                    for (uint32_t r = 0; r < rounds; r++)
+                    {
+                        uint64_t sum = 0;
+                        double t0 = bench_now_ns();
+                        if (c == 0)
+                            sum = count ? soa_count(soa, f, &present) : (uint64_t)soa_find(soa, f, &absent, 0);
+                        else if (!count)
+                            sum = c == 1 ? (uint64_t)array_find_data_range(array, (void *)&absent, offset, size)
+                                         : (uint64_t)list_find_data_range(list, (void *)&absent, offset, size);
+                        else if (c == 1)
+                        {
+                            // a find per match, each resuming behind the last
+                            Array_t view = *array;
+                            for (int64_t pos; view.size > 0 &&
+                                              (pos = array_find_data_range(&view, (void *)&present, offset, size)) >= 0;
+                                 sum++)
+                            {
+                                view.data = (uint8_t *)view.data + (pos + 1) * view.dsize;
+                                view.size -= pos + 1;
+                            }
+                        }
+                        else
+                            for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next)
+                                sum += !memcmp((uint8_t *)ptr->data + offset, &present, size);
+                        bench_result_sample(&res, bench_now_ns() - t0, len);
+                        _sink_ = sum;
+                    }
+                    bench_json_result(&json, &res);
+                    bench_result_free(&res);
+                }
+            }
+        }
+        if (list != NULL)
+            list_destroy(list);
+        array_destroy(array);
+        soa_destroy(soa);
+        free(records);
+    }
+    bench_json_end(&json);
+    return 0;
+}
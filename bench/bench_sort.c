@@ -0,0 +1,114 @@
+/*
+ * Parallel sort of 16 byte records with a uint64_t key, Array_t and List_t,
+ * by comparison and by radix key, at 1 to max_threads threads. One op is one
+ * element, the input is reshuffled before every round. JSON on stdout.
+ *
+ * usage: bench_sort [-n len] [-t max_threads] [-r rounds]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/sort.h"
+
+typedef struct
+{
+    uint64_t key;
+    uint64_t value;
+} Bench_Record_t;
+
+static int _cmp_(const void *a, const void *b, void *ctx)
+{
+    uint64_t ka = ((const Bench_Record_t *)a)->key;
+    uint64_t kb = ((const Bench_Record_t *)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+static void _fill_array_(Array_t *array, uint64_t seed)
+{
+    Bench_Record_t *rec = (Bench_Record_t *)array->data;
+    for (uint64_t i = 0; i < array->size; i++)
+        rec[i].key = bench_rand(&seed);
+}
+
+static void _fill_list_(List_t *list, uint64_t seed)
+{
+    for (List_Node_t *node = list->head; node != NULL; node = node->next)
+        ((Bench_Record_t *)node->data)->key = bench_rand(&seed);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t len = 10000000;
+    uint32_t max_threads = 32;
+    uint32_t rounds = 3;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            len = strtoull(optarg, NULL, 0);
+            break;
+        case 't':
+            max_threads = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n len] [-t max_threads] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Array_t *array = array_construct(sizeof(Bench_Record_t));
+    List_t *list = list_init(sizeof(Bench_Record_t));
+    Bench_Record_t tmp = {0, 0};
+    array_reserve(array, len);
+    for (uint64_t i = 0; i < len; i++, tmp.value++)
+    {
+        array_push_back(array, &tmp);
+        list_push_back(list, &tmp);
+    }
+
+    static const char *ops[] = {"sort", "sort_key"};
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "sort");
+    for (uint32_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        Cctr_Pool_t *pool = cctr_pool_construct(threads - 1);
+        for (int c = 0; c < 2; c++)
+            for (int op = 0; op < 2; op++)
+            {
+                Bench_Result_t res;
+                bench_result_init(&res, c ? "List_t" : "Array_t", ops[op], sizeof(Bench_Record_t), len);
+                res.threads = threads;
+                for (uint32_t r = 0; r < rounds; r++)
+                {
+                    if (c)
+                        _fill_list_(list, r + 1);
+                    else
+                        _fill_array_(array, r + 1);
+
+                    double t0 = bench_now_ns();
+                    if (c && op)
+                        list_sort_key(list, pool, 0, sizeof(uint64_t), 0);
+                    else if (c)
+                        list_sort(list, pool, _cmp_, NULL);
+                    else if (op)
+                        array_sort_key(array, pool, 0, sizeof(uint64_t), 0);
+                    else
+                        array_sort(array, pool, _cmp_, NULL);
+                    bench_result_sample(&res, bench_now_ns() - t0, len);
+                }
+                bench_json_result(&json, &res);
+                bench_result_free(&res);
+            }
+        cctr_pool_destroy(pool);
+    }
+    bench_json_end(&json);
+
+    array_destroy(array);
+    list_destroy(list);
+    return 0;
+}
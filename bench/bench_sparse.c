@@ -0,0 +1,151 @@
+/*
+ * Sparse_t against a List_t of key + value records searched with
+ * list_find_data_range, len random keys with uint64_t values at lengths 10^4
+ * to max_len, about 2% of the key range [0, 50 * len) is used. get looks up present keys, set_erase sets an
+ * absent key and erases it again, iterate visits every key once (one op per
+ * key). The list is only timed up to 10^6 keys. JSON on stdout.
+ *
+ * usage: bench_sparse [-n max_len] [-o ops]
+ */
+#include <getopt.h>
+#include "bench/bench.h"
+#include "cctrlib/sparse.h"
+#include "cctrlib/list.h"
+
+#define BENCH_TARGET_WALK 20000000 // list records visited per case
+#define BENCH_SPREAD 50              // key range per key
+
+typedef struct
+{
+    uint32_t key;
+    uint32_t reserved;
+    uint64_t value;
+} Bench_Record_t;
+
+static volatile uint64_t _sink_;
+
+static void _visit_(uint32_t key, void *data, void *ctx)
+{
+    *(uint64_t *)ctx += *(uint64_t *)data;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t max_len = 10000000;
+    uint64_t ops = 1000000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_len = strtoull(optarg, NULL, 0);
+            break;
+        case 'o':
+            ops = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n max_len] [-o ops]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    Bench_Json_t json;
+    bench_json_begin(&json, stdout, "sparse");
+    for (uint64_t len = 10000; len <= max_len; len *= 10)
+    {
+        uint32_t *keys = (uint32_t *)malloc(len * sizeof(uint32_t));
+        uint64_t range = len * BENCH_SPREAD < UINT32_MAX ? len * BENCH_SPREAD : UINT32_MAX;
+        int64_t heap = bench_heap_bytes();
+        Sparse_t *sparse = sparse_construct(sizeof(uint64_t));
+        for (uint64_t i = 0; i < len; i++)
+        {
+            // odd keys are set, even keys stay absent for set_erase
+            do
+                keys[i] = (uint32_t)(bench_rand(&seed) % range) | 1;
+            while (sparse_contains(sparse, keys[i]));
+            sparse_set(sparse, keys[i], &(uint64_t){i});
+        }
+        double sparse_bytes = (double)(bench_heap_bytes() - heap) / (double)len;
+
+        List_t *list = NULL;
+        double list_bytes = 0;
+        if (len <= 1000000)
+        {
+            heap = bench_heap_bytes();
+            list = list_init(sizeof(Bench_Record_t));
+            for (uint64_t i = 0; i < len; i++)
+                list_push_back(list, &(Bench_Record_t){keys[i], 0, i});
+            list_bytes = (double)(bench_heap_bytes() - heap) / (double)len;
+        }
+        uint64_t list_ops = BENCH_TARGET_WALK / len + 1;
+
+        for (int c = 0; c < 2; c++)
+        {
+            if (c && list == NULL)
+                break;
+            uint64_t n = c ? list_ops : ops;
+            const char *name = c ? "List_t" : "Sparse_t";
+            uint64_t sum = 0;
+            Bench_Result_t res;
+
+            bench_result_init(&res, name, "get", sizeof(uint64_t), len);
+            res.bytes_per_elem = c ? list_bytes : sparse_bytes;
+            double t0 = bench_now_ns();
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint32_t key = keys[bench_rand(&seed) % len];
+                if (c)
+                    sum += ((Bench_Record_t *)list_at(list, list_find_data_range(list, &key, 0, sizeof(uint32_t))))->value;
+                else
+                    sum += *(uint64_t *)sparse_get(sparse, key);
+            }
+            bench_result_sample(&res, bench_now_ns() - t0, n);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            bench_result_init(&res, name, "set_erase", sizeof(uint64_t), len);
+            t0 = bench_now_ns();
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint32_t key = (uint32_t)(bench_rand(&seed) % range) & ~1u;
+                if (c)
+                {
+                    // the set has to look for the key first, the erase again
+                    if (list_find_data_range(list, &key, 0, sizeof(uint32_t)) < 0)
+                        list_push_back(list, &(Bench_Record_t){key, 0, i});
+                    list_erase(list, list_find_data_range(list, &key, 0, sizeof(uint32_t)));
+                }
+                else
+                {
+                    sparse_set(sparse, key, &i);
+                    sparse_erase(sparse, key);
+                }
+            }
+            bench_result_sample(&res, bench_now_ns() - t0, n);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+
+            bench_result_init(&res, name, "iterate", sizeof(uint64_t), len);
+            t0 = bench_now_ns();
+            if (c)
+                for (List_Node_t *node = list->head; node != NULL; node = node->next)
+                    sum += ((Bench_Record_t *)node->data)->value;
+            else
+                sparse_for_each(sparse, _visit_, &sum);
+            bench_result_sample(&res, bench_now_ns() - t0, len);
+            bench_json_result(&json, &res);
+            bench_result_free(&res);
+            _sink_ = sum;
+        }
+
+        if (list != NULL)
+            list_destroy(list);
+        sparse_destroy(sparse);
+        free(keys);
+    }
+    bench_json_end(&json);
+    return 0;
+}
@@ -0,0 +1,297 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include <sys/mman.h>
+#include "array.h"
+#include "hash.h"
+#include "huge.h"
+
+Array_t *array_construct(uint32_t dsize)
+{
+    assert(dsize > 0);
+    Array_t *ret = (Array_t *)calloc(1, sizeof(Array_t));
+    assert(ret != NULL);
+    ret->dsize = dsize;
+    return ret;
+}
+
+Array_t *array_construct_huge(uint32_t dsize)
+{
+    Array_t *ret = array_construct(dsize);
+    ret->flags = CCTR_ARRAY_HUGE;
+    return ret;
+}
+
+static void _array_release_(Array_t *self)
+{
+    if (self->flags & CCTR_ARRAY_MAPPED)
+        munmap(self->map, self->map_size);
+    else
+        free(self->data);
+    self->data = NULL;
+    self->map = NULL;
+    self->map_size = 0;
+    self->capacity = 0;
+    self->flags &= CCTR_ARRAY_HUGE;
+}
+
+void array_clear(Array_t *self)
+{
+    assert(self != NULL);
+    _array_release_(self);
+    self->size = 0;
+}
+
+void array_destroy(Array_t *self)
+{
+    array_clear(self);
+    free(self);
+}
+
+Array_t *array_copy(Array_t *self)
+{
+    assert(self != NULL);
+    if (!(self->flags & CCTR_ARRAY_HUGE))
+        return array_from_array(self->data, self->size, self->dsize);
+
+    // same kind of storage, a long copy gets its own huge page mapping
+    Array_t *ret = array_construct_huge(self->dsize);
+    if (self->size == 0)
+        return ret;
+    array_reserve(ret, self->size);
+    memcpy(ret->data, self->data, self->size * self->dsize);
+    ret->size = self->size;
+    return ret;
+}
+
+void array_reserve(Array_t *self, uint64_t capacity)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    if (capacity <= self->capacity)
+        return;
+
+    if ((self->flags & CCTR_ARRAY_HUGE) && capacity * self->dsize >= CCTR_HUGE_PAGE)
+    {
+        // a new mapping of whole huge pages, the capacity takes all of it
+        uint64_t map_size;
+        void *map = cctr_huge_map(capacity * self->dsize, &map_size);
+        if (self->size > 0)
+            memcpy(map, self->data, self->size * self->dsize);
+        _array_release_(self);
+        self->data = map;
+        if (map_size != 0)
+        {
+            self->map = map;
+            self->map_size = map_size;
+            self->flags |= CCTR_ARRAY_MAPPED;
+            capacity = map_size / self->dsize;
+        }
+    }
+    else if (self->flags & CCTR_ARRAY_MAPPED)
+    {
+        // a mapping cannot grow, move over to malloc storage
+        void *data = malloc(capacity * self->dsize);
+        assert(data != NULL);
+        memcpy(data, self->data, self->size * self->dsize);
+        _array_release_(self);
+        self->data = data;
+    }
+    else
+    {
+        self->data = realloc(self->data, capacity * self->dsize);
+        assert(self->data != NULL);
+    }
+    self->capacity = capacity;
+}
+
+void array_promote(Array_t *self)
+{
+    // a private file mapping turns writable, pages are copied on first write only
+    assert(self != NULL);
+    if (!(self->flags & CCTR_ARRAY_READONLY))
+        return;
+
+    int ret = mprotect(self->map, self->map_size, PROT_READ | PROT_WRITE);
+    assert(ret == 0);
+    (void)ret;
+    self->flags &= ~CCTR_ARRAY_READONLY;
+}
+
+static void _array_grow_(Array_t *self, uint64_t extra)
+{
+    if (self->size + extra <= self->capacity)
+        return;
+    uint64_t capacity = self->capacity ? self->capacity * 2 : 16;
+    while (capacity < self->size + extra)
+        capacity *= 2;
+    array_reserve(self, capacity);
+}
+
+// ------------------------------------------------------------------
+
+void *array_front(Array_t *self)
+{
+    assert(self != NULL);
+    assert(self->size > 0);
+    return self->data;
+}
+
+void *array_back(Array_t *self)
+{
+    assert(self != NULL);
+    assert(self->size > 0);
+    return (uint8_t *)self->data + (self->size - 1) * self->dsize;
+}
+
+void *array_at(Array_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    if (pos >= self->size)
+        return NULL;
+    return (uint8_t *)self->data + pos * self->dsize;
+}
+
+void array_push_back(Array_t *self, void *data)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    _array_grow_(self, 1);
+    memcpy((uint8_t *)self->data + self->size * self->dsize, data, self->dsize);
+    self->size++;
+}
+
+void array_pop_back(Array_t *self)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    if (self->size > 0)
+        self->size--;
+}
+
+// ------------------------------------------------------------------
+
+void array_insert(Array_t *self, uint64_t pos, void *data)
+{
+    array_insert_array(self, pos, data, 1);
+}
+
+void array_erase(Array_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    if (pos >= self->size)
+        return;
+
+    uint8_t *ptr = (uint8_t *)self->data + pos * self->dsize;
+    memmove(ptr, ptr + self->dsize, (self->size - pos - 1) * self->dsize);
+    self->size--;
+}
+
+void array_insert_array(Array_t *self, uint64_t pos, void *array, uint64_t asize)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    if (pos > self->size || asize == 0)
+        return;
+
+    _array_grow_(self, asize);
+    uint8_t *ptr = (uint8_t *)self->data + pos * self->dsize;
+    memmove(ptr + asize * self->dsize, ptr, (self->size - pos) * self->dsize);
+    memcpy(ptr, array, asize * self->dsize);
+    self->size += asize;
+}
+
+Array_t *array_from_array(void *array, uint64_t asize, uint32_t dsize)
+{
+    Array_t *ret = array_construct(dsize);
+    if (asize == 0)
+        return ret;
+    array_reserve(ret, asize);
+    memcpy(ret->data, array, asize * dsize);
+    ret->size = asize;
+    return ret;
+}
+
+// ---------------------------------------------------------------------------------------
+int64_t array_find_data_range(Array_t *self, void *data, uint32_t offset, uint32_t dsize)
+{
+    assert(self != NULL);
+    if ((offset + dsize) > self->dsize)
+        return -1;
+    uint8_t *ptr = (uint8_t *)self->data + offset;
+    for (uint64_t pos = 0; pos < self->size; pos++, ptr += self->dsize)
+        if (!memcmp(data, ptr, dsize))
+            return (int64_t)pos;
+    return -1;
+}
+
+int64_t array_find(Array_t *self, void *data)
+{
+    assert(self != NULL);
+    switch (self->dsize)
+    {
+    case sizeof(uint32_t):
+    {
+        uint32_t key;
+        memcpy(&key, data, sizeof(key));
+        for (uint64_t pos = 0; pos < self->size; pos++)
+            if (((uint32_t *)self->data)[pos] == key)
+                return (int64_t)pos;
+        return -1;
+    }
+    case sizeof(uint64_t):
+    {
+        uint64_t key;
+        memcpy(&key, data, sizeof(key));
+        for (uint64_t pos = 0; pos < self->size; pos++)
+            if (((uint64_t *)self->data)[pos] == key)
+                return (int64_t)pos;
+        return -1;
+    }
+    default:
+        return array_find_data_range(self, data, 0, self->dsize);
+    }
+}
+
+// ------------------------------------------------------------------
+int array_equal(Array_t *self, Array_t *other)
+{
+    if (self->size != other->size || self->dsize != other->dsize)
+        return 0;
+    return self->size == 0 || !memcmp(self->data, other->data, self->size * self->dsize);
+}
+
+int array_compare(Array_t *self, Array_t *other)
+{
+    assert(self->dsize == other->dsize);
+    uint64_t n = self->size < other->size ? self->size : other->size;
+    int ret = n > 0 ? memcmp(self->data, other->data, n * self->dsize) : 0;
+    if (ret != 0)
+        return ret < 0 ? -1 : 1;
+    return self->size < other->size ? -1 : self->size > other->size;
+}
+
+uint64_t array_hash(Array_t *self)
+{
+    return cctr_hash(self->data, self->size * self->dsize, CCTR_HASH_SEED);
+}
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Contiguous storage of size elements of dsize bytes. The storage is either
+ * from malloc or a file mapping (see array_map in serialize.h), a mapping is
+ * read-only until array_promote. An array of array_construct_huge moves to an
+ * anonymous huge page mapping (huge.h) once it needs CCTR_HUGE_PAGE bytes.
+ */
+#define CCTR_ARRAY_READONLY 0x1
+#define CCTR_ARRAY_MAPPED 0x2
+#define CCTR_ARRAY_HUGE 0x4
+
+typedef struct
+{
+    void *data;
+    uint64_t size;
+    uint64_t capacity; // in elements
+    uint32_t dsize;
+    uint32_t flags;
+    void *map; // mapping which contains data, NULL for malloc storage
+    uint64_t map_size;
+} Array_t;
+
+/*
+ * Construct & Desctruct
+ */
+Array_t *array_construct(uint32_t dsize);
+Array_t *array_construct_huge(uint32_t dsize);
+void array_clear(Array_t *self);
+void array_destroy(Array_t *self);
+Array_t *array_copy(Array_t *self);
+void array_reserve(Array_t *self, uint64_t capacity);
+void array_promote(Array_t *self);
+
+/*
+ * Basic Usage
+ */
+void *array_front(Array_t *self);
+void *array_back(Array_t *self);
+void *array_at(Array_t *self, uint64_t pos);
+void array_push_back(Array_t *self, void *data);
+void array_pop_back(Array_t *self);
+
+/*
+ * Additional
+ */
+void array_insert(Array_t *self, uint64_t pos, void *data);
+void array_erase(Array_t *self, uint64_t pos);
+void array_insert_array(Array_t *self, uint64_t pos, void *array, uint64_t asize);
+Array_t *array_from_array(void *array, uint64_t asize, uint32_t dsize);
+
+/*
+ * Searching
+ */
+int64_t array_find_data_range(Array_t *self, void *data, uint32_t offset, uint32_t dsize);
+int64_t array_find(Array_t *self, void *data);
+
+/*
+ * Comparing, see list_equal / list_compare / list_hash
+ * the payloads are one run, array_hash is a single cctr_hash over it
+ */
+int array_equal(Array_t *self, Array_t *other);
+int array_compare(Array_t *self, Array_t *other);
+uint64_t array_hash(Array_t *self);
@@ -0,0 +1,433 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "bitset.h"
+#include "serialize.h"
+
+#define _BITSET_BLOCK_WORDS_ (CCTR_BITSET_BLOCK_BITS / 64)
+
+/*
+ * Popcount
+ * the hardware instruction is not in the x86-64 baseline, the word loops are
+ * compiled twice and the one the cpu runs is picked on first use
+ */
+static uint64_t _bitset_popcount_soft_(const uint64_t *words, uint64_t n)
+{
+    uint64_t ret = 0;
+    for (uint64_t i = 0; i < n; i++)
+        ret += (uint64_t)__builtin_popcountll(words[i]);
+    return ret;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("popcnt"))) static uint64_t _bitset_popcount_hw_(const uint64_t *words, uint64_t n)
+{
+    uint64_t ret = 0;
+    for (uint64_t i = 0; i < n; i++)
+        ret += (uint64_t)__builtin_popcountll(words[i]);
+    return ret;
+}
+#endif
+
+typedef uint64_t (*_Bitset_Popcount_t_)(const uint64_t *words, uint64_t n);
+
+static uint64_t _bitset_popcount_pick_(const uint64_t *words, uint64_t n);
+static _Bitset_Popcount_t_ _bitset_popcount_fn_ = _bitset_popcount_pick_;
+
+static uint64_t _bitset_popcount_pick_(const uint64_t *words, uint64_t n)
+{
+    _Bitset_Popcount_t_ fn = _bitset_popcount_soft_;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt"))
+        fn = _bitset_popcount_hw_;
+#endif
+    __atomic_store_n(&_bitset_popcount_fn_, fn, __ATOMIC_RELAXED);
+    return fn(words, n);
+}
+
+static inline uint64_t _bitset_popcount_(const uint64_t *words, uint64_t n)
+{
+    return __atomic_load_n(&_bitset_popcount_fn_, __ATOMIC_RELAXED)(words, n);
+}
+
+static inline uint64_t _bitset_popcount_word_(uint64_t word)
+{
+    // inline for the few words rank / select look at inside a block
+    word -= (word >> 1) & 0x5555555555555555ULL;
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (word * 0x0101010101010101ULL) >> 56;
+}
+
+/*
+ * Storage
+ */
+static inline uint64_t _bitset_nwords_(uint64_t nbits)
+{
+    return (nbits + 63) / 64;
+}
+
+static Bitset_t *_bitset_wrap_(void *map, uint64_t map_size, uint64_t *words, uint64_t nbits, uint32_t flags)
+{
+    Bitset_t *ret = (Bitset_t *)calloc(1, sizeof(Bitset_t));
+    assert(ret != NULL);
+    ret->words = words;
+    ret->nbits = nbits;
+    ret->nwords = _bitset_nwords_(nbits);
+    ret->flags = flags;
+    ret->map = map;
+    ret->map_size = map_size;
+    return ret;
+}
+
+static void _bitset_drop_index_(Bitset_t *self)
+{
+    free(self->blocks);
+    free(self->samples);
+    self->blocks = NULL;
+    self->samples = NULL;
+    self->indexed = 0;
+}
+
+// ------------------------------------------------------------------
+Bitset_t *bitset_construct(uint64_t nbits)
+{
+    // zero pages are mapped lazily, a sparse bitset costs the pages written to
+    uint64_t map_size = _bitset_nwords_(nbits) * sizeof(uint64_t);
+    map_size = map_size ? map_size : sizeof(uint64_t);
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (map == MAP_FAILED)
+        return NULL;
+    return _bitset_wrap_(map, map_size, (uint64_t *)map, nbits, 0);
+}
+
+Bitset_t *bitset_create(const char *path, uint64_t nbits)
+{
+    assert(path != NULL);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return NULL;
+
+    Cctr_File_Header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CCTR_FILE_MAGIC;
+    header.version = CCTR_FILE_VERSION;
+    header.kind = CCTR_FILE_BITSET;
+    header.endian = CCTR_FILE_ENDIAN;
+    header.dsize = sizeof(uint64_t);
+    header.count = _bitset_nwords_(nbits);
+    header.header_size = sizeof(Cctr_File_Header_t);
+    memcpy(header.reserved, &nbits, sizeof(uint64_t));
+
+    // the file is sized first, the words read as zero until written
+    uint64_t map_size = header.header_size + header.count * sizeof(uint64_t);
+    void *map = MAP_FAILED;
+    if (ftruncate(fd, (off_t)map_size) == 0 && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header))
+        map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int err = errno;
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        errno = err;
+        return NULL;
+    }
+    return _bitset_wrap_(map, map_size, (uint64_t *)((uint8_t *)map + header.header_size), nbits, CCTR_BITSET_FILE);
+}
+
+Bitset_t *bitset_open(const char *path, int writable)
+{
+    assert(path != NULL);
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    Cctr_File_Header_t header;
+    struct stat st;
+    ssize_t got = fstat(fd, &st) < 0 ? -1 : pread(fd, &header, sizeof(header), 0);
+    if (got != (ssize_t)sizeof(header))
+    {
+        int err = got < 0 ? errno : EINVAL;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    uint64_t nbits;
+    memcpy(&nbits, header.reserved, sizeof(uint64_t));
+    uint64_t file_size = (uint64_t)st.st_size;
+    if (header.magic != CCTR_FILE_MAGIC || header.endian != CCTR_FILE_ENDIAN ||
+        header.version != CCTR_FILE_VERSION || header.kind != CCTR_FILE_BITSET ||
+        header.dsize != sizeof(uint64_t) || header.header_size < sizeof(Cctr_File_Header_t) ||
+        header.header_size % sizeof(uint64_t) != 0 || header.count != _bitset_nwords_(nbits) ||
+        header.header_size > file_size || header.count > (file_size - header.header_size) / sizeof(uint64_t))
+    {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *map = mmap(NULL, file_size, prot, MAP_SHARED, fd, 0);
+    int err = errno;
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        errno = err;
+        return NULL;
+    }
+    uint32_t flags = CCTR_BITSET_FILE | (writable ? 0 : CCTR_BITSET_READONLY);
+    return _bitset_wrap_(map, file_size, (uint64_t *)((uint8_t *)map + header.header_size), nbits, flags);
+}
+
+Bitset_t *bitset_copy(Bitset_t *self)
+{
+    assert(self != NULL);
+    Bitset_t *ret = bitset_construct(self->nbits);
+    if (ret != NULL)
+        memcpy(ret->words, self->words, self->nwords * sizeof(uint64_t));
+    return ret;
+}
+
+int bitset_sync(Bitset_t *self)
+{
+    assert(self != NULL);
+    if (!(self->flags & CCTR_BITSET_FILE) || (self->flags & CCTR_BITSET_READONLY))
+        return 0;
+    return msync(self->map, self->map_size, MS_SYNC);
+}
+
+void bitset_destroy(Bitset_t *self)
+{
+    assert(self != NULL);
+    munmap(self->map, self->map_size);
+    _bitset_drop_index_(self);
+    free(self);
+}
+
+void bitset_set_range(Bitset_t *self, uint64_t lo, uint64_t hi, int value)
+{
+    assert(self != NULL);
+    assert(lo <= hi && hi <= self->nbits);
+    assert(!(self->flags & CCTR_BITSET_READONLY));
+    if (lo == hi)
+        return;
+
+    uint64_t first = lo >> 6, last = (hi - 1) >> 6;
+    uint64_t head = ~0ULL << (lo & 63);
+    uint64_t tail = ~0ULL >> (63 - ((hi - 1) & 63));
+    if (first == last)
+        head &= tail;
+    if (value)
+        self->words[first] |= head;
+    else
+        self->words[first] &= ~head;
+    if (first != last)
+    {
+        memset(self->words + first + 1, value ? 0xFF : 0, (last - first - 1) * sizeof(uint64_t));
+        if (value)
+            self->words[last] |= tail;
+        else
+            self->words[last] &= ~tail;
+    }
+    self->indexed = 0;
+}
+
+/*
+ * Bulk
+ * two words per SSE2 operation, the rest word by word
+ */
+#ifdef __SSE2__
+#define _BITSET_SIMD_(a, b, VEC)                                  \
+    for (; i + 2 <= n; i += 2)                                    \
+    {                                                             \
+        __m128i x = _mm_loadu_si128((const __m128i *)((a) + i));  \
+        __m128i y = _mm_loadu_si128((const __m128i *)((b) + i));  \
+        _mm_storeu_si128((__m128i *)((a) + i), VEC);              \
+    }
+#else
+#define _BITSET_SIMD_(a, b, VEC)
+#endif
+
+#define _BITSET_BULK_(NAME, VEC, EXPR)                                 \
+    void bitset_##NAME(Bitset_t *self, Bitset_t *other)                \
+    {                                                                  \
+        assert(self != NULL && other != NULL);                         \
+        assert(self->nbits == other->nbits);                           \
+        assert(!(self->flags & CCTR_BITSET_READONLY));                 \
+        uint64_t *a = self->words;                                     \
+        const uint64_t *b = other->words;                              \
+        const uint64_t n = self->nwords;                               \
+        uint64_t i = 0;                                                \
+        _BITSET_SIMD_(a, b, VEC)                                       \
+        for (; i < n; i++)                                             \
+            a[i] = EXPR;                                               \
+        self->indexed = 0;                                             \
+    }
+
+_BITSET_BULK_(and, _mm_and_si128(x, y), a[i] & b[i])
+_BITSET_BULK_(or, _mm_or_si128(x, y), a[i] | b[i])
+_BITSET_BULK_(xor, _mm_xor_si128(x, y), a[i] ^ b[i])
+_BITSET_BULK_(andnot, _mm_andnot_si128(y, x), a[i] & ~b[i])
+
+uint64_t bitset_count(Bitset_t *self)
+{
+    assert(self != NULL);
+    if (self->indexed)
+        return self->ones;
+    return _bitset_popcount_(self->words, self->nwords);
+}
+
+uint64_t bitset_next(Bitset_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    if (pos >= self->nbits)
+        return self->nbits;
+    uint64_t i = pos >> 6;
+    uint64_t word = self->words[i] & (~0ULL << (pos & 63));
+    while (word == 0)
+    {
+        if (++i == self->nwords)
+            return self->nbits;
+        word = self->words[i];
+    }
+    return (i << 6) + (uint64_t)__builtin_ctzll(word);
+}
+
+/*
+ * Rank & Select
+ */
+void bitset_index(Bitset_t *self)
+{
+    assert(self != NULL);
+    if (self->indexed)
+        return;
+    _bitset_drop_index_(self);
+
+    self->nblocks = (self->nwords + _BITSET_BLOCK_WORDS_ - 1) / _BITSET_BLOCK_WORDS_;
+    self->blocks = (uint64_t *)malloc((self->nblocks + 1) * sizeof(uint64_t));
+    assert(self->blocks != NULL);
+    uint64_t ones = 0;
+    for (uint64_t b = 0; b < self->nblocks; b++)
+    {
+        self->blocks[b] = ones;
+        uint64_t begin = b * _BITSET_BLOCK_WORDS_;
+        uint64_t len = self->nwords - begin < _BITSET_BLOCK_WORDS_ ? self->nwords - begin : _BITSET_BLOCK_WORDS_;
+        ones += _bitset_popcount_(self->words + begin, len);
+    }
+    self->blocks[self->nblocks] = ones;
+    self->ones = ones;
+
+    // block of every CCTR_BITSET_SELECT_SAMPLE-th one, the search for the k-th stays between two samples
+    self->nsamples = ones / CCTR_BITSET_SELECT_SAMPLE + 1;
+    self->samples = (uint64_t *)malloc(self->nsamples * sizeof(uint64_t));
+    assert(self->samples != NULL);
+    uint64_t b = 0;
+    for (uint64_t j = 0; j < self->nsamples; j++)
+    {
+        uint64_t k = j * CCTR_BITSET_SELECT_SAMPLE;
+        while (b + 1 < self->nblocks && self->blocks[b + 1] <= k)
+            b++;
+        self->samples[j] = b;
+    }
+    self->indexed = 1;
+}
+
+uint64_t bitset_rank(Bitset_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    assert(pos <= self->nbits);
+    bitset_index(self);
+    uint64_t w = pos >> 6;
+    uint64_t b = w / _BITSET_BLOCK_WORDS_;
+    uint64_t ret = self->blocks[b];
+    for (uint64_t i = b * _BITSET_BLOCK_WORDS_; i < w; i++)
+        ret += _bitset_popcount_word_(self->words[i]);
+    if (pos & 63)
+        ret += _bitset_popcount_word_(self->words[w] & (~0ULL >> (64 - (pos & 63))));
+    return ret;
+}
+
+static inline uint64_t _bitset_bytes_le_(uint64_t bytes, uint64_t r)
+{
+    // number of bytes <= r, every byte and r below 128
+    uint64_t le = ((r * 0x0101010101010101ULL) | 0x8080808080808080ULL) - bytes;
+    return (((le & 0x8080808080808080ULL) >> 7) * 0x0101010101010101ULL) >> 56;
+}
+
+static inline uint64_t _bitset_select_word_(uint64_t word, uint64_t r)
+{
+    // branch free: byte i of sums counts the ones in bytes 0 .. i, the bytes
+    // with at most r ones before the end lie below the r-th one
+    uint64_t sums = word - ((word >> 1) & 0x5555555555555555ULL);
+    sums = (sums & 0x3333333333333333ULL) + ((sums >> 2) & 0x3333333333333333ULL);
+    sums = ((sums + (sums >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL;
+    uint64_t place = _bitset_bytes_le_(sums, r) * 8;
+    r -= ((sums << 8) >> place) & 0xFF;
+
+    // the same on the bits of that byte spread over the bytes of a word
+    uint64_t bits = (((word >> place) & 0xFF) * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+    bits = ((bits + 0x7F7F7F7F7F7F7F7FULL) & 0x8080808080808080ULL) >> 7;
+    return place + _bitset_bytes_le_(bits * 0x0101010101010101ULL, r);
+}
+
+uint64_t bitset_select(Bitset_t *self, uint64_t k)
+{
+    assert(self != NULL);
+    bitset_index(self);
+    if (k >= self->ones)
+        return self->nbits;
+
+    // last block starting with at most k ones, between two samples
+    uint64_t j = k / CCTR_BITSET_SELECT_SAMPLE;
+    uint64_t lo = self->samples[j];
+    uint64_t hi = j + 1 < self->nsamples ? self->samples[j + 1] + 1 : self->nblocks;
+    uint64_t len = hi - lo;
+    while (len > 1)
+    {
+        uint64_t half = len / 2;
+        lo = self->blocks[lo + half] <= k ? lo + half : lo;
+        len -= half;
+    }
+
+    // words of the block skipped while the k-th one is further, without branches
+    uint64_t r = k - self->blocks[lo];
+    uint64_t i = lo * _BITSET_BLOCK_WORDS_;
+    uint64_t end = self->nwords - i < _BITSET_BLOCK_WORDS_ ? self->nwords : i + _BITSET_BLOCK_WORDS_;
+    uint64_t found = 0, pos = i;
+    for (; i < end; i++)
+    {
+        uint64_t c = _bitset_popcount_word_(self->words[i]);
+        uint64_t skip = !found & (r >= c);
+        r -= skip ? c : 0;
+        pos += skip;
+        found |= !skip;
+    }
+    return (pos << 6) + _bitset_select_word_(self->words[pos], r);
+}
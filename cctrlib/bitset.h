@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Fixed length vector of nbits bits packed into 64 bit words, bit i is bit
+ * i % 64 of words[i / 64] and the bits past nbits are always 0. The words
+ * live in an anonymous mapping, pages are only backed once written, or in a
+ * mapped file (serialize.h header, kind CCTR_FILE_BITSET, the bit count in
+ * the first 8 reserved bytes) which array_map can read as an array of words.
+ *
+ * The rank / select index counts the set bits before every block of
+ * CCTR_BITSET_BLOCK_BITS and samples the block of every
+ * CCTR_BITSET_SELECT_SAMPLE-th set bit. It is built by the first
+ * bitset_rank / bitset_select after a change, so reading concurrently is
+ * only safe after bitset_index.
+ */
+#define CCTR_BITSET_BLOCK_BITS 512
+#define CCTR_BITSET_SELECT_SAMPLE 8192
+
+#define CCTR_BITSET_READONLY 0x1
+#define CCTR_BITSET_FILE 0x2
+
+typedef struct
+{
+    uint64_t *words;
+    uint64_t nbits;
+    uint64_t nwords;
+    uint32_t flags;
+    uint32_t indexed; // 1 while blocks / samples match the words
+    void *map;
+    uint64_t map_size;
+
+    uint64_t *blocks; // set bits before each block, nblocks + 1 entries
+    uint64_t nblocks;
+    uint64_t *samples; // block of set bit j * CCTR_BITSET_SELECT_SAMPLE
+    uint64_t nsamples;
+    uint64_t ones; // set bits, valid while indexed
+} Bitset_t;
+
+/*
+ * Construct & Desctruct
+ * bitset_construct starts with every bit clear. bitset_create truncates path
+ * and maps it shared, so the file holds the bits, bitset_open maps a file
+ * written before (read-only unless writable). Both return NULL with errno set
+ * on failure.
+ */
+Bitset_t *bitset_construct(uint64_t nbits);
+Bitset_t *bitset_create(const char *path, uint64_t nbits);
+Bitset_t *bitset_open(const char *path, int writable);
+Bitset_t *bitset_copy(Bitset_t *self);
+int bitset_sync(Bitset_t *self);
+void bitset_destroy(Bitset_t *self);
+
+/*
+ * Basic Usage
+ */
+static inline void bitset_set(Bitset_t *self, uint64_t pos)
+{
+    assert(pos < self->nbits && !(self->flags & CCTR_BITSET_READONLY));
+    self->words[pos >> 6] |= 1ULL << (pos & 63);
+    self->indexed = 0;
+}
+
+static inline void bitset_clear(Bitset_t *self, uint64_t pos)
+{
+    assert(pos < self->nbits && !(self->flags & CCTR_BITSET_READONLY));
+    self->words[pos >> 6] &= ~(1ULL << (pos & 63));
+    self->indexed = 0;
+}
+
+static inline void bitset_flip(Bitset_t *self, uint64_t pos)
+{
+    assert(pos < self->nbits && !(self->flags & CCTR_BITSET_READONLY));
+    self->words[pos >> 6] ^= 1ULL << (pos & 63);
+    self->indexed = 0;
+}
+
+static inline int bitset_test(Bitset_t *self, uint64_t pos)
+{
+    assert(pos < self->nbits);
+    return (self->words[pos >> 6] >> (pos & 63)) & 1;
+}
+
+// bits [lo, hi) to value
+void bitset_set_range(Bitset_t *self, uint64_t lo, uint64_t hi, int value);
+
+/*
+ * Bulk, self = self op other, both of the same length
+ */
+void bitset_and(Bitset_t *self, Bitset_t *other);
+void bitset_or(Bitset_t *self, Bitset_t *other);
+void bitset_xor(Bitset_t *self, Bitset_t *other);
+void bitset_andnot(Bitset_t *self, Bitset_t *other);
+
+/*
+ * Counting & Searching
+ * bitset_next returns the first set bit >= pos, nbits when there is none:
+ *     for (uint64_t i = bitset_next(b, 0); i < b->nbits; i = bitset_next(b, i + 1))
+ */
+uint64_t bitset_count(Bitset_t *self);
+uint64_t bitset_next(Bitset_t *self, uint64_t pos);
+
+/*
+ * Rank & Select
+ * bitset_rank counts the set bits before pos in O(1), bitset_select finds the
+ * k-th set bit counting from 0, nbits when k >= bitset_count.
+ */
+void bitset_index(Bitset_t *self);
+uint64_t bitset_rank(Bitset_t *self, uint64_t pos);
+uint64_t bitset_select(Bitset_t *self, uint64_t k);
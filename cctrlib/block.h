@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <assert.h>
+#include <sys/mman.h>
+
+#pragma once
+
+/*
+ * Block
+ * One allocation holding count elements of stride bytes, used to allocate
+ * nodes in batches. Each element keeps the block alive, the block is freed
+ * when the last element is released. A block may also be a region of huge
+ * pages (huge.h), which is unmapped instead. Nodes of one block can end up in
+ * different containers (slist_split_front, list_insert_list) used from
+ * different threads, so refs is only changed atomically.
+ */
+#define CCTR_ALIGN(x) (((x) + _Alignof(max_align_t) - 1) & ~(uint64_t)(_Alignof(max_align_t) - 1))
+#define CCTR_BLOCK_HEADER CCTR_ALIGN(sizeof(Cctr_Block_t))
+
+typedef struct Cctr_Block_t
+{
+    uint64_t refs;     // elements still in use, atomic
+    uint64_t map_size; // length of the mapping, 0 for malloc storage
+} Cctr_Block_t;
+
+static inline Cctr_Block_t *cctr_block_construct(uint64_t count, uint64_t stride)
+{
+    assert(count > 0);
+    Cctr_Block_t *block = (Cctr_Block_t *)malloc(CCTR_BLOCK_HEADER + count * stride);
+    assert(block != NULL);
+    block->refs = count;
+    block->map_size = 0;
+    return block;
+}
+
+static inline void *cctr_block_at(Cctr_Block_t *block, uint64_t stride, uint64_t idx)
+{
+    return (uint8_t *)block + CCTR_BLOCK_HEADER + idx * stride;
+}
+
+static inline void cctr_block_retain(Cctr_Block_t *block)
+{
+    __atomic_add_fetch(&block->refs, 1, __ATOMIC_RELAXED);
+}
+
+// drops one reference, returns 1 when it was the last one and the block is the caller's to free
+static inline int cctr_block_drop(Cctr_Block_t *block)
+{
+    uint64_t refs = __atomic_sub_fetch(&block->refs, 1, __ATOMIC_ACQ_REL);
+    assert(refs != UINT64_MAX);
+    return refs == 0;
+}
+
+static inline void cctr_block_free(Cctr_Block_t *block)
+{
+    if (block->map_size != 0)
+        munmap(block, block->map_size);
+    else
+        free(block);
+}
+
+static inline void cctr_block_release(Cctr_Block_t *block)
+{
+    if (cctr_block_drop(block))
+        cctr_block_free(block);
+}
+
+/*
+ * Small payloads
+ * A payload of at most CCTR_SMALL_DSIZE bytes is kept in the allocation of
+ * its node, right behind it, the data pointer of the node points there. One
+ * malloc per element instead of two and the payload shares the cache line of
+ * the links.
+ */
+#define CCTR_SMALL_DSIZE sizeof(void *)
+#define CCTR_NODE_ALLOCS(dsize) ((dsize) <= CCTR_SMALL_DSIZE ? 1 : 2)
+
+// allocates a node of node_size bytes and room for its payload, returns both
+static inline void *cctr_node_alloc(uint64_t node_size, uint32_t dsize, void **data)
+{
+    if (dsize <= CCTR_SMALL_DSIZE)
+    {
+        uint8_t *node = (uint8_t *)malloc(node_size + CCTR_SMALL_DSIZE);
+        assert(node != NULL);
+        *data = node + node_size;
+        return node;
+    }
+    void *node = malloc(node_size);
+    assert(node != NULL);
+    *data = malloc(dsize);
+    assert(*data != NULL);
+    return node;
+}
+
+static inline void cctr_node_free(void *node, void *data, uint32_t dsize)
+{
+    if (dsize > CCTR_SMALL_DSIZE)
+        free(data);
+    free(node);
+}
@@ -0,0 +1,576 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include "bset.h"
+#include "block.h"
+
+/*
+ * Nodes
+ */
+#define _BSET_HEADER_ offsetof(Bset_Node_t, keys)
+
+static inline uint8_t *_bset_key_(Bset_t *self, Bset_Node_t *node, uint32_t idx)
+{
+    return node->keys + (uint64_t)idx * self->ksize;
+}
+
+static inline uint8_t *_bset_value_(Bset_t *self, Bset_Node_t *node, uint32_t idx)
+{
+    return (uint8_t *)node + self->values + (uint64_t)idx * self->vsize;
+}
+
+static inline Bset_Node_t **_bset_children_(Bset_t *self, Bset_Node_t *node)
+{
+    return (Bset_Node_t **)((uint8_t *)node + self->children);
+}
+
+static Bset_Node_t *_bset_node_(Bset_t *self, int leaf)
+{
+    uint64_t bytes = leaf ? self->values + (uint64_t)(self->leaf_cap + 1) * self->vsize
+                          : self->children + (uint64_t)(self->inner_cap + 2) * sizeof(Bset_Node_t *);
+    Bset_Node_t *ret = (Bset_Node_t *)malloc(bytes);
+    assert(ret != NULL);
+    ret->count = 0;
+    ret->leaf = (uint32_t)leaf;
+    ret->next = NULL;
+    return ret;
+}
+
+static void _bset_node_destroy_(Bset_t *self, Bset_Node_t *node)
+{
+    if (!node->leaf)
+        for (uint32_t i = 0; i <= node->count; i++)
+            _bset_node_destroy_(self, _bset_children_(self, node)[i]);
+    free(node);
+}
+
+/*
+ * Search
+ * position of the first key >= key (upper: > key) among the n keys of a node
+ */
+#define _BSET_SEARCH_(T)                                                                        \
+    static inline uint32_t _bset_search_##T##_(const uint8_t *keys, uint32_t n, const void *key, \
+                                               int upper)                                       \
+    {                                                                                           \
+        T k;                                                                                    \
+        memcpy(&k, key, sizeof(T));                                                             \
+        const T *base = (const T *)keys;                                                        \
+        while (n > 1)                                                                           \
+        {                                                                                       \
+            uint32_t half = n / 2;                                                              \
+            T probe = base[half - 1];                                                           \
+            base += ((probe < k) | (upper & (probe == k))) * half;                              \
+            n -= half;                                                                          \
+        }                                                                                       \
+        return (uint32_t)(base - (const T *)keys) + (n == 1 && ((base[0] < k) | (upper & (base[0] == k)))); \
+    }
+_BSET_SEARCH_(uint8_t)
+_BSET_SEARCH_(uint16_t)
+_BSET_SEARCH_(uint32_t)
+_BSET_SEARCH_(uint64_t)
+
+static inline uint64_t _bset_int_(uint32_t ksize, const void *key)
+{
+    switch (ksize)
+    {
+    case 1:
+        return *(const uint8_t *)key;
+    case 2:
+        return *(const uint16_t *)key;
+    case 4:
+        return *(const uint32_t *)key;
+    default:
+        return *(const uint64_t *)key;
+    }
+}
+
+static inline int _bset_cmp_(Bset_t *self, const void *a, const void *b)
+{
+    if (self->cmp)
+        return self->cmp(a, b, self->ctx);
+    uint64_t x = _bset_int_(self->ksize, a);
+    uint64_t y = _bset_int_(self->ksize, b);
+    return (x > y) - (x < y);
+}
+
+static inline uint32_t _bset_search_(Bset_t *self, Bset_Node_t *node, const void *key, int upper)
+{
+    if (self->cmp == NULL)
+        switch (self->ksize)
+        {
+        case 1:
+            return _bset_search_uint8_t_(node->keys, node->count, key, upper);
+        case 2:
+            return _bset_search_uint16_t_(node->keys, node->count, key, upper);
+        case 4:
+            return _bset_search_uint32_t_(node->keys, node->count, key, upper);
+        default:
+            return _bset_search_uint64_t_(node->keys, node->count, key, upper);
+        }
+    uint32_t lo = 0;
+    uint32_t hi = node->count;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        int c = self->cmp(_bset_key_(self, node, mid), key, self->ctx);
+        if (c < 0 || (upper && c == 0))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// leaf which holds key if it is present, separators are the first key of their right subtree
+static inline Bset_Node_t *_bset_leaf_(Bset_t *self, const void *key)
+{
+    Bset_Node_t *node = self->root;
+    while (!node->leaf)
+        node = _bset_children_(self, node)[_bset_search_(self, node, key, 1)];
+    return node;
+}
+
+/*
+ * Construct & Desctruct
+ */
+Bset_t *bset_construct(uint32_t ksize, uint32_t vsize, Cctr_Cmp_t cmp, void *ctx)
+{
+    assert(ksize > 0);
+    assert(cmp != NULL || ksize == 1 || ksize == 2 || ksize == 4 || ksize == 8);
+    Bset_t *ret = (Bset_t *)malloc(sizeof(Bset_t));
+    assert(ret != NULL);
+    ret->root = NULL;
+    ret->size = 0;
+    ret->ksize = ksize;
+    ret->vsize = vsize;
+    ret->cmp = cmp;
+    ret->ctx = ctx;
+
+    // one spare key (and value or child) absorbs the insert before a split
+    const uint64_t room = CCTR_BSET_NODE_BYTES - _BSET_HEADER_ - _Alignof(max_align_t);
+    uint64_t cap = room / (ksize + vsize);
+    ret->leaf_cap = cap > 5 ? (uint32_t)cap - 1 : 4;
+    cap = (room - 2 * sizeof(Bset_Node_t *)) / (ksize + sizeof(Bset_Node_t *));
+    ret->inner_cap = cap > 5 ? (uint32_t)cap - 1 : 4;
+    ret->values = (uint32_t)CCTR_ALIGN(_BSET_HEADER_ + (uint64_t)(ret->leaf_cap + 1) * ksize);
+    ret->children = (uint32_t)CCTR_ALIGN(_BSET_HEADER_ + (uint64_t)(ret->inner_cap + 1) * ksize);
+    return ret;
+}
+
+void bset_clear(Bset_t *self)
+{
+    if (self->root)
+        _bset_node_destroy_(self, self->root);
+    self->root = NULL;
+    self->size = 0;
+}
+
+void bset_destroy(Bset_t *self)
+{
+    bset_clear(self);
+    free(self);
+}
+
+Bset_t *bset_from_sorted(uint32_t ksize, uint32_t vsize, Cctr_Cmp_t cmp, void *ctx,
+                         const void *keys, const void *values, uint64_t n)
+{
+    Bset_t *ret = bset_construct(ksize, vsize, cmp, ctx);
+    if (n == 0)
+        return ret;
+    const uint8_t *kptr = (const uint8_t *)keys;
+    for (uint64_t i = 1; i < n; i++)
+        assert(_bset_cmp_(ret, kptr + (i - 1) * ksize, kptr + i * ksize) < 0);
+
+    // leaves as full as the count allows, spread evenly so none is under half full
+    uint64_t nodes = (n + ret->leaf_cap - 1) / ret->leaf_cap;
+    Bset_Node_t **level = (Bset_Node_t **)malloc(nodes * sizeof(Bset_Node_t *));
+    const uint8_t **low = (const uint8_t **)malloc(nodes * sizeof(uint8_t *)); // first key below each node
+    assert(level != NULL && low != NULL);
+    uint64_t pos = 0;
+    for (uint64_t l = 0; l < nodes; l++)
+    {
+        Bset_Node_t *leaf = _bset_node_(ret, 1);
+        leaf->count = (uint32_t)(n / nodes + (l < n % nodes));
+        memcpy(leaf->keys, kptr + pos * ksize, (uint64_t)leaf->count * ksize);
+        if (values)
+            memcpy(_bset_value_(ret, leaf, 0), (const uint8_t *)values + pos * vsize, (uint64_t)leaf->count * vsize);
+        else
+            memset(_bset_value_(ret, leaf, 0), 0, (uint64_t)leaf->count * vsize);
+        if (l > 0)
+            level[l - 1]->next = leaf;
+        level[l] = leaf;
+        low[l] = leaf->keys;
+        pos += leaf->count;
+    }
+
+    // inner levels the same way, the nodes of the next level overwrite the ones already linked
+    while (nodes > 1)
+    {
+        uint64_t groups = (nodes + ret->inner_cap) / (ret->inner_cap + 1);
+        uint64_t k = 0;
+        for (uint64_t g = 0; g < groups; g++)
+        {
+            uint32_t cnt = (uint32_t)(nodes / groups + (g < nodes % groups));
+            Bset_Node_t *inner = _bset_node_(ret, 0);
+            inner->count = cnt - 1;
+            for (uint32_t j = 0; j < cnt; j++)
+            {
+                _bset_children_(ret, inner)[j] = level[k + j];
+                if (j > 0)
+                    memcpy(_bset_key_(ret, inner, j - 1), low[k + j], ksize);
+            }
+            level[g] = inner;
+            low[g] = low[k];
+            k += cnt;
+        }
+        nodes = groups;
+    }
+    ret->root = level[0];
+    ret->size = n;
+    free(level);
+    free(low);
+    return ret;
+}
+
+/*
+ * Insert
+ * returns the new right sibling when node split, its first key in sep
+ */
+static Bset_Node_t *_bset_insert_(Bset_t *self, Bset_Node_t *node, const void *key, const void *value,
+                                  int *added, uint8_t *sep)
+{
+    const uint32_t ksize = self->ksize;
+    const uint32_t vsize = self->vsize;
+    if (node->leaf)
+    {
+        uint32_t i = _bset_search_(self, node, key, 0);
+        if (i < node->count && _bset_cmp_(self, _bset_key_(self, node, i), key) == 0)
+        {
+            if (value)
+                memcpy(_bset_value_(self, node, i), value, vsize);
+            *added = 0;
+            return NULL;
+        }
+        memmove(_bset_key_(self, node, i + 1), _bset_key_(self, node, i), (uint64_t)(node->count - i) * ksize);
+        memmove(_bset_value_(self, node, i + 1), _bset_value_(self, node, i), (uint64_t)(node->count - i) * vsize);
+        memcpy(_bset_key_(self, node, i), key, ksize);
+        if (value)
+            memcpy(_bset_value_(self, node, i), value, vsize);
+        else
+            memset(_bset_value_(self, node, i), 0, vsize);
+        node->count++;
+        *added = 1;
+        if (node->count <= self->leaf_cap)
+            return NULL;
+
+        // ascending inserts leave full leaves behind
+        uint32_t left = i == node->count - 1 ? self->leaf_cap : node->count / 2;
+        Bset_Node_t *right = _bset_node_(self, 1);
+        right->count = node->count - left;
+        memcpy(right->keys, _bset_key_(self, node, left), (uint64_t)right->count * ksize);
+        memcpy(_bset_value_(self, right, 0), _bset_value_(self, node, left), (uint64_t)right->count * vsize);
+        node->count = left;
+        right->next = node->next;
+        node->next = right;
+        memcpy(sep, right->keys, ksize);
+        return right;
+    }
+
+    uint32_t c = _bset_search_(self, node, key, 1);
+    Bset_Node_t **children = _bset_children_(self, node);
+    Bset_Node_t *split = _bset_insert_(self, children[c], key, value, added, sep);
+    if (split == NULL)
+        return NULL;
+    memmove(_bset_key_(self, node, c + 1), _bset_key_(self, node, c), (uint64_t)(node->count - c) * ksize);
+    memcpy(_bset_key_(self, node, c), sep, ksize);
+    memmove(&children[c + 2], &children[c + 1], (node->count - c) * sizeof(Bset_Node_t *));
+    children[c + 1] = split;
+    node->count++;
+    if (node->count <= self->inner_cap)
+        return NULL;
+
+    // the middle key moves up
+    uint32_t m = node->count / 2;
+    Bset_Node_t *right = _bset_node_(self, 0);
+    right->count = node->count - m - 1;
+    memcpy(right->keys, _bset_key_(self, node, m + 1), (uint64_t)right->count * ksize);
+    memcpy(_bset_children_(self, right), &children[m + 1], (right->count + 1) * sizeof(Bset_Node_t *));
+    memcpy(sep, _bset_key_(self, node, m), ksize);
+    node->count = m;
+    return right;
+}
+
+int bset_insert(Bset_t *self, const void *key, const void *value)
+{
+    assert(self != NULL && key != NULL);
+    if (self->root == NULL)
+        self->root = _bset_node_(self, 1);
+    int added;
+    uint8_t sep[self->ksize];
+    Bset_Node_t *split = _bset_insert_(self, self->root, key, value, &added, sep);
+    if (split)
+    {
+        Bset_Node_t *root = _bset_node_(self, 0);
+        root->count = 1;
+        memcpy(root->keys, sep, self->ksize);
+        _bset_children_(self, root)[0] = self->root;
+        _bset_children_(self, root)[1] = split;
+        self->root = root;
+    }
+    self->size += added;
+    return added;
+}
+
+/*
+ * Erase
+ */
+// moves children[i + 1] of parent into children[i] and drops it
+static void _bset_merge_(Bset_t *self, Bset_Node_t *parent, uint32_t i)
+{
+    const uint32_t ksize = self->ksize;
+    Bset_Node_t **children = _bset_children_(self, parent);
+    Bset_Node_t *left = children[i];
+    Bset_Node_t *right = children[i + 1];
+    if (left->leaf)
+    {
+        memcpy(_bset_key_(self, left, left->count), right->keys, (uint64_t)right->count * ksize);
+        memcpy(_bset_value_(self, left, left->count), _bset_value_(self, right, 0), (uint64_t)right->count * self->vsize);
+        left->count += right->count;
+        left->next = right->next;
+    }
+    else
+    {
+        memcpy(_bset_key_(self, left, left->count), _bset_key_(self, parent, i), ksize);
+        memcpy(_bset_key_(self, left, left->count + 1), right->keys, (uint64_t)right->count * ksize);
+        memcpy(&_bset_children_(self, left)[left->count + 1], _bset_children_(self, right),
+               (right->count + 1) * sizeof(Bset_Node_t *));
+        left->count += right->count + 1;
+    }
+    free(right);
+    memmove(_bset_key_(self, parent, i), _bset_key_(self, parent, i + 1), (uint64_t)(parent->count - i - 1) * ksize);
+    memmove(&children[i + 1], &children[i + 2], (parent->count - i - 1) * sizeof(Bset_Node_t *));
+    parent->count--;
+}
+
+// children[c] of parent fell under half full, borrow a key from a sibling or merge with it
+static void _bset_rebalance_(Bset_t *self, Bset_Node_t *parent, uint32_t c)
+{
+    const uint32_t ksize = self->ksize;
+    const uint32_t vsize = self->vsize;
+    Bset_Node_t **children = _bset_children_(self, parent);
+    Bset_Node_t *child = children[c];
+    Bset_Node_t *left = c > 0 ? children[c - 1] : NULL;
+    Bset_Node_t *right = c < parent->count ? children[c + 1] : NULL;
+    const uint32_t min = (child->leaf ? self->leaf_cap : self->inner_cap) / 2;
+
+    if (left && left->count > min)
+    {
+        memmove(_bset_key_(self, child, 1), child->keys, (uint64_t)child->count * ksize);
+        if (child->leaf)
+        {
+            memmove(_bset_value_(self, child, 1), _bset_value_(self, child, 0), (uint64_t)child->count * vsize);
+            memcpy(child->keys, _bset_key_(self, left, left->count - 1), ksize);
+            memcpy(_bset_value_(self, child, 0), _bset_value_(self, left, left->count - 1), vsize);
+            memcpy(_bset_key_(self, parent, c - 1), child->keys, ksize);
+        }
+        else
+        {
+            Bset_Node_t **cc = _bset_children_(self, child);
+            memmove(&cc[1], &cc[0], (child->count + 1) * sizeof(Bset_Node_t *));
+            cc[0] = _bset_children_(self, left)[left->count];
+            memcpy(child->keys, _bset_key_(self, parent, c - 1), ksize);
+            memcpy(_bset_key_(self, parent, c - 1), _bset_key_(self, left, left->count - 1), ksize);
+        }
+        left->count--;
+        child->count++;
+    }
+    else if (right && right->count > min)
+    {
+        if (child->leaf)
+        {
+            memcpy(_bset_key_(self, child, child->count), right->keys, ksize);
+            memcpy(_bset_value_(self, child, child->count), _bset_value_(self, right, 0), vsize);
+            memmove(_bset_value_(self, right, 0), _bset_value_(self, right, 1), (uint64_t)(right->count - 1) * vsize);
+            memmove(right->keys, _bset_key_(self, right, 1), (uint64_t)(right->count - 1) * ksize);
+            memcpy(_bset_key_(self, parent, c), right->keys, ksize);
+        }
+        else
+        {
+            Bset_Node_t **rc = _bset_children_(self, right);
+            memcpy(_bset_key_(self, child, child->count), _bset_key_(self, parent, c), ksize);
+            _bset_children_(self, child)[child->count + 1] = rc[0];
+            memcpy(_bset_key_(self, parent, c), right->keys, ksize);
+            memmove(right->keys, _bset_key_(self, right, 1), (uint64_t)(right->count - 1) * ksize);
+            memmove(&rc[0], &rc[1], right->count * sizeof(Bset_Node_t *));
+        }
+        right->count--;
+        child->count++;
+    }
+    else if (left)
+        _bset_merge_(self, parent, c - 1);
+    else
+        _bset_merge_(self, parent, c);
+}
+
+static int _bset_erase_(Bset_t *self, Bset_Node_t *node, const void *key)
+{
+    if (node->leaf)
+    {
+        uint32_t i = _bset_search_(self, node, key, 0);
+        if (i >= node->count || _bset_cmp_(self, _bset_key_(self, node, i), key) != 0)
+            return 0;
+        memmove(_bset_key_(self, node, i), _bset_key_(self, node, i + 1), (uint64_t)(node->count - i - 1) * self->ksize);
+        memmove(_bset_value_(self, node, i), _bset_value_(self, node, i + 1),
+                (uint64_t)(node->count - i - 1) * self->vsize);
+        node->count--;
+        return 1;
+    }
+    uint32_t c = _bset_search_(self, node, key, 1);
+    Bset_Node_t *child = _bset_children_(self, node)[c];
+    if (!_bset_erase_(self, child, key))
+        return 0;
+    if (child->count < (child->leaf ? self->leaf_cap : self->inner_cap) / 2)
+        _bset_rebalance_(self, node, c);
+    return 1;
+}
+
+int bset_erase(Bset_t *self, const void *key)
+{
+    assert(self != NULL && key != NULL);
+    if (self->root == NULL || !_bset_erase_(self, self->root, key))
+        return 0;
+    self->size--;
+    Bset_Node_t *root = self->root;
+    if (root->count == 0)
+    {
+        self->root = root->leaf ? NULL : _bset_children_(self, root)[0];
+        free(root);
+    }
+    return 1;
+}
+
+/*
+ * Lookup
+ */
+void *bset_find(Bset_t *self, const void *key)
+{
+    assert(self != NULL && key != NULL);
+    if (self->root == NULL)
+        return NULL;
+    Bset_Node_t *leaf = _bset_leaf_(self, key);
+    uint32_t i = _bset_search_(self, leaf, key, 0);
+    if (i >= leaf->count || _bset_cmp_(self, _bset_key_(self, leaf, i), key) != 0)
+        return NULL;
+    return self->vsize ? _bset_value_(self, leaf, i) : _bset_key_(self, leaf, i);
+}
+
+int bset_contains(Bset_t *self, const void *key)
+{
+    return bset_find(self, key) != NULL;
+}
+
+/*
+ * Iteration
+ */
+static inline int _bset_iter_fix_(Bset_Iter_t *iter)
+{
+    // a position behind the last key of a leaf is the first of the next one
+    if (iter->leaf && iter->idx >= iter->leaf->count)
+    {
+        iter->leaf = iter->leaf->next;
+        iter->idx = 0;
+    }
+    return iter->leaf != NULL;
+}
+
+int bset_first(Bset_t *self, Bset_Iter_t *iter)
+{
+    Bset_Node_t *node = self->root;
+    while (node && !node->leaf)
+        node = _bset_children_(self, node)[0];
+    iter->leaf = node;
+    iter->idx = 0;
+    return node != NULL;
+}
+
+static int _bset_bound_(Bset_t *self, const void *key, Bset_Iter_t *iter, int upper)
+{
+    iter->leaf = self->root ? _bset_leaf_(self, key) : NULL;
+    iter->idx = iter->leaf ? _bset_search_(self, iter->leaf, key, upper) : 0;
+    return _bset_iter_fix_(iter);
+}
+
+int bset_lower_bound(Bset_t *self, const void *key, Bset_Iter_t *iter)
+{
+    return _bset_bound_(self, key, iter, 0);
+}
+
+int bset_upper_bound(Bset_t *self, const void *key, Bset_Iter_t *iter)
+{
+    return _bset_bound_(self, key, iter, 1);
+}
+
+int bset_next(Bset_t *self, Bset_Iter_t *iter)
+{
+    assert(iter->leaf != NULL);
+    iter->idx++;
+    return _bset_iter_fix_(iter);
+}
+
+const void *bset_iter_key(Bset_t *self, Bset_Iter_t *iter)
+{
+    return iter->leaf ? _bset_key_(self, iter->leaf, iter->idx) : NULL;
+}
+
+void *bset_iter_value(Bset_t *self, Bset_Iter_t *iter)
+{
+    return iter->leaf && self->vsize ? _bset_value_(self, iter->leaf, iter->idx) : NULL;
+}
+
+uint64_t bset_range(Bset_t *self, const void *lo, const void *hi,
+                    void (*fn)(const void *key, void *value, void *ctx), void *ctx)
+{
+    Bset_Iter_t iter;
+    int valid = lo ? bset_lower_bound(self, lo, &iter) : bset_first(self, &iter);
+    uint64_t ret = 0;
+    // a leaf at a time, the bound is only compared against the last key of each
+    while (valid)
+    {
+        Bset_Node_t *leaf = iter.leaf;
+        uint32_t end = leaf->count;
+        if (hi && _bset_cmp_(self, _bset_key_(self, leaf, end - 1), hi) >= 0)
+            end = _bset_search_(self, leaf, hi, 0);
+        if (end < iter.idx)
+            end = iter.idx; // hi <= lo
+        for (uint32_t i = iter.idx; i < end; i++)
+            fn(_bset_key_(self, leaf, i), self->vsize ? _bset_value_(self, leaf, i) : NULL, ctx);
+        ret += end - iter.idx;
+        if (end < leaf->count)
+            break;
+        iter.leaf = leaf->next;
+        iter.idx = 0;
+        valid = iter.leaf != NULL;
+    }
+    return ret;
+}
@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "sort.h"
+
+#pragma once
+
+/*
+ * Strcture
+ * Ordered set of unique ksize byte keys, a map when vsize is not 0. A B+-tree
+ * whose nodes are CCTR_BSET_NODE_BYTES long and keep their keys packed in one
+ * array, values next to the keys in the leaves, children next to the keys in
+ * the inner nodes. The leaves are chained in key order for range iteration.
+ *
+ * Without a comparator the keys are unsigned integers of 1, 2, 4 or 8 bytes
+ * in native byte order and a node is searched with a branch free binary
+ * search, otherwise cmp orders them (sort.h).
+ */
+#define CCTR_BSET_NODE_BYTES 512 // at least 4 keys per node
+
+typedef struct Bset_Node_t
+{
+    uint32_t count; // keys
+    uint32_t leaf;
+    struct Bset_Node_t *next; // next leaf in key order, NULL for inner nodes
+    uint8_t keys[];           // cap + 1 keys, then cap + 1 values or cap + 2 children
+} Bset_Node_t;
+
+typedef struct
+{
+    Bset_Node_t *root; // NULL when empty
+    uint64_t size;
+    uint32_t ksize;
+    uint32_t vsize;
+    Cctr_Cmp_t cmp;
+    void *ctx;
+    uint32_t leaf_cap;
+    uint32_t inner_cap;
+    uint32_t values;   // offset of the values in a leaf
+    uint32_t children; // offset of the children in an inner node
+} Bset_t;
+
+// position of an element, invalidated by any insert or erase
+typedef struct
+{
+    Bset_Node_t *leaf; // NULL past the last element
+    uint32_t idx;
+} Bset_Iter_t;
+
+/*
+ * Construct & Desctruct
+ * bset_from_sorted takes n strictly increasing keys, values may be NULL
+ */
+Bset_t *bset_construct(uint32_t ksize, uint32_t vsize, Cctr_Cmp_t cmp, void *ctx);
+void bset_destroy(Bset_t *self);
+void bset_clear(Bset_t *self);
+Bset_t *bset_from_sorted(uint32_t ksize, uint32_t vsize, Cctr_Cmp_t cmp, void *ctx,
+                         const void *keys, const void *values, uint64_t n);
+
+/*
+ * Usage
+ * bset_insert returns 1 for a new key, for a present key it overwrites the
+ * value and returns 0. value may be NULL, a new key then gets a zero value.
+ * bset_find returns the value of the key (the stored key in a set) or NULL.
+ */
+int bset_insert(Bset_t *self, const void *key, const void *value);
+int bset_erase(Bset_t *self, const void *key);
+void *bset_find(Bset_t *self, const void *key);
+int bset_contains(Bset_t *self, const void *key);
+
+/*
+ * Iteration
+ * bset_first and the bounds return 0 when the position is past the last key
+ */
+int bset_first(Bset_t *self, Bset_Iter_t *iter);
+int bset_lower_bound(Bset_t *self, const void *key, Bset_Iter_t *iter); // first key >= key
+int bset_upper_bound(Bset_t *self, const void *key, Bset_Iter_t *iter); // first key > key
+int bset_next(Bset_t *self, Bset_Iter_t *iter);
+const void *bset_iter_key(Bset_t *self, Bset_Iter_t *iter);
+void *bset_iter_value(Bset_t *self, Bset_Iter_t *iter);
+// visits the keys in [lo, hi) in order, a NULL bound is open, returns the number visited
+uint64_t bset_range(Bset_t *self, const void *lo, const void *hi,
+                    void (*fn)(const void *key, void *value, void *ctx), void *ctx);
@@ -0,0 +1,339 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include <sched.h>
+#include "clist.h"
+
+/*
+ * Nodes
+ */
+static Clist_Node_t *_clist_node_(Clist_t *self, void *data)
+{
+    Clist_Node_t *ret = (Clist_Node_t *)malloc(sizeof(Clist_Node_t) + (data ? self->dsize : 0));
+    assert(ret != NULL);
+    ret->prev = NULL;
+    ret->next = NULL;
+    pthread_rwlock_init(&ret->lock, NULL);
+    if (data)
+        memcpy(ret->data, data, self->dsize);
+    return ret;
+}
+
+static void _clist_node_destroy_(Clist_Node_t *node)
+{
+    pthread_rwlock_destroy(&node->lock);
+    free(node);
+}
+
+static inline void _clist_rdlock_(Clist_Node_t *node)
+{
+    pthread_rwlock_rdlock(&node->lock);
+}
+
+static inline void _clist_wrlock_(Clist_Node_t *node)
+{
+    pthread_rwlock_wrlock(&node->lock);
+}
+
+static inline void _clist_unlock_(Clist_Node_t *node)
+{
+    pthread_rwlock_unlock(&node->lock);
+}
+
+// links node between left and right, both write locked
+static inline void _clist_link_(Clist_t *self, Clist_Node_t *left, Clist_Node_t *node, Clist_Node_t *right)
+{
+    node->prev = left;
+    node->next = right;
+    left->next = node;
+    right->prev = node;
+    __atomic_fetch_add(&self->size, 1, __ATOMIC_RELAXED);
+}
+
+// unlinks node, it and both neighbours write locked, copies the payload out
+static inline void _clist_unlink_(Clist_t *self, Clist_Node_t *node, void *out)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    __atomic_fetch_sub(&self->size, 1, __ATOMIC_RELAXED);
+    if (out)
+        memcpy(out, node->data, self->dsize);
+}
+
+/*
+ * Walk
+ * returns the node in front of pos (the head sentinel for 0) with itself and
+ * its next write locked, NULL with nothing locked when the list is shorter
+ */
+static Clist_Node_t *_clist_seek_(Clist_t *self, uint32_t pos)
+{
+    Clist_Node_t *prev = self->head;
+    _clist_wrlock_(prev);
+    Clist_Node_t *cur = prev->next;
+    _clist_wrlock_(cur);
+    for (uint32_t i = 0; i < pos; i++)
+    {
+        if (cur == self->tail)
+        {
+            _clist_unlock_(cur);
+            _clist_unlock_(prev);
+            return NULL;
+        }
+        _clist_unlock_(prev);
+        prev = cur;
+        cur = cur->next;
+        _clist_wrlock_(cur);
+    }
+    return prev;
+}
+
+// erases prev->next, prev and prev->next write locked by the caller, all unlocked after
+static void _clist_erase_next_(Clist_t *self, Clist_Node_t *prev, void *out)
+{
+    Clist_Node_t *node = prev->next;
+    Clist_Node_t *next = node->next;
+    _clist_wrlock_(next);
+    _clist_unlink_(self, node, out);
+    _clist_unlock_(next);
+    _clist_unlock_(prev);
+    // nobody waits on node, reaching it takes the lock of prev or next
+    _clist_unlock_(node);
+    _clist_node_destroy_(node);
+}
+
+/*
+ * Construct & Desctruct
+ */
+Clist_t *clist_construct(uint32_t dsize)
+{
+    Clist_t *ret = (Clist_t *)malloc(sizeof(Clist_t));
+    assert(ret != NULL);
+    ret->dsize = dsize;
+    ret->size = 0;
+    ret->head = _clist_node_(ret, NULL);
+    ret->tail = _clist_node_(ret, NULL);
+    ret->head->next = ret->tail;
+    ret->tail->prev = ret->head;
+    return ret;
+}
+
+void clist_destroy(Clist_t *self)
+{
+    Clist_Node_t *ptr = self->head;
+    while (ptr != NULL)
+    {
+        Clist_Node_t *next = ptr->next;
+        _clist_node_destroy_(ptr);
+        ptr = next;
+    }
+    free(self);
+}
+
+/*
+ * Usage
+ */
+uint32_t clist_size(Clist_t *self)
+{
+    return __atomic_load_n(&self->size, __ATOMIC_RELAXED);
+}
+
+void clist_push_front(Clist_t *self, void *data)
+{
+    Clist_Node_t *node = _clist_node_(self, data);
+    Clist_Node_t *head = self->head;
+    _clist_wrlock_(head);
+    Clist_Node_t *first = head->next;
+    _clist_wrlock_(first);
+    _clist_link_(self, head, node, first);
+    _clist_unlock_(first);
+    _clist_unlock_(head);
+}
+
+void clist_push_back(Clist_t *self, void *data)
+{
+    Clist_Node_t *node = _clist_node_(self, data);
+    Clist_Node_t *tail = self->tail;
+    Clist_Node_t *last;
+    for (;;)
+    {
+        // tail->prev only changes under the tail lock, last stays alive meanwhile
+        _clist_wrlock_(tail);
+        last = tail->prev;
+        if (pthread_rwlock_trywrlock(&last->lock) == 0)
+            break;
+        _clist_unlock_(tail);
+        sched_yield();
+    }
+    _clist_link_(self, last, node, tail);
+    _clist_unlock_(last);
+    _clist_unlock_(tail);
+}
+
+int clist_pop_front(Clist_t *self, void *out)
+{
+    return clist_erase(self, 0, out);
+}
+
+int clist_pop_back(Clist_t *self, void *out)
+{
+    Clist_Node_t *tail = self->tail;
+    Clist_Node_t *last;
+    for (;;)
+    {
+        _clist_wrlock_(tail);
+        last = tail->prev;
+        if (last == self->head)
+        {
+            _clist_unlock_(tail);
+            return 0;
+        }
+        if (pthread_rwlock_trywrlock(&last->lock) == 0)
+        {
+            if (pthread_rwlock_trywrlock(&last->prev->lock) == 0)
+                break;
+            _clist_unlock_(last);
+        }
+        _clist_unlock_(tail);
+        sched_yield();
+    }
+    Clist_Node_t *prev = last->prev;
+    _clist_unlink_(self, last, out);
+    _clist_unlock_(prev);
+    _clist_unlock_(tail);
+    _clist_unlock_(last);
+    _clist_node_destroy_(last);
+    return 1;
+}
+
+int clist_at(Clist_t *self, uint32_t pos, void *out)
+{
+    Clist_Node_t *cur = self->head;
+    _clist_rdlock_(cur);
+    for (uint32_t i = 0;; i++)
+    {
+        Clist_Node_t *next = cur->next;
+        _clist_rdlock_(next);
+        _clist_unlock_(cur);
+        cur = next;
+        if (cur == self->tail)
+            break;
+        if (i == pos)
+        {
+            if (out)
+                memcpy(out, cur->data, self->dsize);
+            _clist_unlock_(cur);
+            return 1;
+        }
+    }
+    _clist_unlock_(cur);
+    return 0;
+}
+
+int clist_insert(Clist_t *self, uint32_t pos, void *data)
+{
+    Clist_Node_t *prev = _clist_seek_(self, pos);
+    if (prev == NULL)
+        return 0;
+    Clist_Node_t *next = prev->next;
+    _clist_link_(self, prev, _clist_node_(self, data), next);
+    _clist_unlock_(next);
+    _clist_unlock_(prev);
+    return 1;
+}
+
+int clist_erase(Clist_t *self, uint32_t pos, void *out)
+{
+    Clist_Node_t *prev = _clist_seek_(self, pos);
+    if (prev == NULL)
+        return 0;
+    if (prev->next == self->tail)
+    {
+        _clist_unlock_(prev->next);
+        _clist_unlock_(prev);
+        return 0;
+    }
+    _clist_erase_next_(self, prev, out);
+    return 1;
+}
+
+int clist_remove(Clist_t *self, void *data)
+{
+    Clist_Node_t *prev = self->head;
+    _clist_wrlock_(prev);
+    Clist_Node_t *cur = prev->next;
+    _clist_wrlock_(cur);
+    while (cur != self->tail)
+    {
+        if (memcmp(cur->data, data, self->dsize) == 0)
+        {
+            _clist_erase_next_(self, prev, NULL);
+            return 1;
+        }
+        _clist_unlock_(prev);
+        prev = cur;
+        cur = cur->next;
+        _clist_wrlock_(cur);
+    }
+    _clist_unlock_(cur);
+    _clist_unlock_(prev);
+    return 0;
+}
+
+int32_t clist_find(Clist_t *self, void *data)
+{
+    Clist_Node_t *cur = self->head;
+    _clist_rdlock_(cur);
+    for (int32_t i = 0;; i++)
+    {
+        Clist_Node_t *next = cur->next;
+        _clist_rdlock_(next);
+        _clist_unlock_(cur);
+        cur = next;
+        if (cur == self->tail)
+            break;
+        if (memcmp(cur->data, data, self->dsize) == 0)
+        {
+            _clist_unlock_(cur);
+            return i;
+        }
+    }
+    _clist_unlock_(cur);
+    return -1;
+}
+
+void clist_for_each(Clist_t *self, void (*fn)(const void *data, void *ctx), void *ctx)
+{
+    Clist_Node_t *cur = self->head;
+    _clist_rdlock_(cur);
+    for (;;)
+    {
+        Clist_Node_t *next = cur->next;
+        _clist_rdlock_(next);
+        _clist_unlock_(cur);
+        cur = next;
+        if (cur == self->tail)
+            break;
+        fn(cur->data, ctx);
+    }
+    _clist_unlock_(cur);
+}
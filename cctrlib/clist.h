@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Doubly linked list for concurrent use, every node carries a reader-writer
+ * lock. A thread walks from the head sentinel holding the lock of the node it
+ * stands on and takes the next one before letting go (lock coupling), readers
+ * share the locks so any number of them traverse together, a writer locks the
+ * nodes around the link it changes and only blocks the threads walking behind
+ * it. Locks are always taken head to tail, the operations at the tail take
+ * the tail sentinel first and only try the node before it, backing off when
+ * it is busy.
+ *
+ * Positions are counted during the walk, a concurrent change in front of the
+ * walking thread moves them. Negative positions are not supported.
+ */
+typedef struct Clist_Node_t
+{
+    struct Clist_Node_t *prev;
+    struct Clist_Node_t *next;
+    pthread_rwlock_t lock;
+    uint8_t data[]; // dsize bytes, none in the sentinels
+} Clist_Node_t;
+
+typedef struct
+{
+    Clist_Node_t *head; // sentinel before the first element
+    Clist_Node_t *tail; // sentinel after the last element
+    uint32_t dsize;
+    uint32_t size; // atomic
+} Clist_t;
+
+/*
+ * Construct & Desctruct
+ * clist_destroy requires that no other thread uses the list
+ */
+Clist_t *clist_construct(uint32_t dsize);
+void clist_destroy(Clist_t *self);
+
+/*
+ * Usage
+ * pop, at and erase copy the element to out when it is not NULL, they return
+ * 0 when there is no such element. insert returns 0 when pos is past the end.
+ */
+uint32_t clist_size(Clist_t *self);
+void clist_push_front(Clist_t *self, void *data);
+void clist_push_back(Clist_t *self, void *data);
+int clist_pop_front(Clist_t *self, void *out);
+int clist_pop_back(Clist_t *self, void *out);
+int clist_at(Clist_t *self, uint32_t pos, void *out);
+int clist_insert(Clist_t *self, uint32_t pos, void *data);
+int clist_erase(Clist_t *self, uint32_t pos, void *out);
+int clist_remove(Clist_t *self, void *data); // erases the first equal element
+int32_t clist_find(Clist_t *self, void *data);
+void clist_for_each(Clist_t *self, void (*fn)(const void *data, void *ctx), void *ctx);
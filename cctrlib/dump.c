@@ -0,0 +1,473 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include "dump.h"
+
+#define _DUMP_CHUNK_ 64 // bytes or fields formatted between two checks for room, 21 chars per field at most
+
+static const char _dump_hex_[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+static const char _dump_digits_[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+/*
+ * Buffer
+ */
+static int _dump_write_(Cctr_Dump_t *self, const uint8_t *ptr, uint64_t len)
+{
+    while (len > 0 && self->error == 0)
+    {
+        ssize_t ret = write(self->fd, ptr, len);
+        if (ret < 0)
+        {
+            if (errno != EINTR)
+                self->error = errno;
+            continue;
+        }
+        ptr += ret;
+        len -= (uint64_t)ret;
+    }
+    return self->error ? -1 : 0;
+}
+
+static inline uint8_t *_dump_room_(Cctr_Dump_t *self, uint64_t need)
+{
+    // where the next need bytes go, the buffer is written out first if they do not fit
+    if (self->cap - self->len < need)
+    {
+        _dump_write_(self, self->buf, self->len);
+        self->len = 0;
+    }
+    return self->buf + self->len;
+}
+
+static inline uint8_t *_dump_u64_(uint8_t *out, uint64_t value)
+{
+    // two digits per division, written backwards into a scratch
+    uint8_t tmp[20];
+    uint8_t *ptr = tmp + sizeof(tmp);
+    while (value >= 100)
+    {
+        uint64_t q = value / 100;
+        ptr -= 2;
+        memcpy(ptr, _dump_digits_ + 2 * (value - q * 100), 2);
+        value = q;
+    }
+    if (value >= 10)
+    {
+        ptr -= 2;
+        memcpy(ptr, _dump_digits_ + 2 * value, 2);
+    }
+    else
+        *--ptr = (uint8_t)('0' + value);
+    uint64_t len = tmp + sizeof(tmp) - ptr;
+    memcpy(out, ptr, len);
+    return out + len;
+}
+
+static void _dump_hex_element_(Cctr_Dump_t *self, const uint8_t *data, uint32_t dsize)
+{
+    uint8_t *out = _dump_room_(self, 24);
+    out = _dump_u64_(out, self->index);
+    *out++ = ':';
+    self->len = out - self->buf;
+    for (uint32_t i = 0; i < dsize; i += _DUMP_CHUNK_)
+    {
+        uint32_t n = dsize - i < _DUMP_CHUNK_ ? dsize - i : _DUMP_CHUNK_;
+        out = _dump_room_(self, 3 * _DUMP_CHUNK_ + 1);
+        for (uint32_t k = 0; k < n; k++)
+        {
+            out[0] = ' ';
+            memcpy(out + 1, _dump_hex_ + 2 * data[i + k], 2);
+            out += 3;
+        }
+        self->len = out - self->buf;
+    }
+    self->buf[self->len++] = '\n';
+}
+
+static void _dump_csv_element_(Cctr_Dump_t *self, const uint8_t *data, uint32_t dsize)
+{
+    uint32_t width = self->width;
+    if (width == 0)
+        width = dsize % 8 == 0 ? 8 : dsize % 4 == 0 ? 4 : dsize % 2 == 0 ? 2 : 1;
+    assert((width == 1 || width == 2 || width == 4 || width == 8) && dsize % width == 0);
+    const uint32_t fields = dsize / width;
+    for (uint32_t i = 0; i < fields; i += _DUMP_CHUNK_)
+    {
+        uint32_t n = fields - i < _DUMP_CHUNK_ ? fields - i : _DUMP_CHUNK_;
+        uint8_t *out = _dump_room_(self, 21 * _DUMP_CHUNK_);
+        for (uint32_t k = 0; k < n; k++)
+        {
+            const uint8_t *ptr = data + (uint64_t)(i + k) * width;
+            uint64_t value;
+            switch (width)
+            {
+            case 8:
+                memcpy(&value, ptr, 8);
+                break;
+            case 4:
+            {
+                uint32_t tmp;
+                memcpy(&tmp, ptr, 4);
+                value = tmp;
+                break;
+            }
+            case 2:
+            {
+                uint16_t tmp;
+                memcpy(&tmp, ptr, 2);
+                value = tmp;
+                break;
+            }
+            default:
+                value = *ptr;
+            }
+            out = _dump_u64_(out, value);
+            *out++ = ',';
+        }
+        self->len = out - self->buf;
+    }
+    self->buf[self->len - 1] = '\n';
+}
+
+// ------------------------------------------------------------------
+void cctr_dump_init(Cctr_Dump_t *self, int fd, Cctr_Dump_Mode_t mode, void *buf, uint64_t cap)
+{
+    assert(self != NULL);
+    assert(mode == CCTR_DUMP_HEX || mode == CCTR_DUMP_RAW || mode == CCTR_DUMP_CSV);
+    memset(self, 0, sizeof(Cctr_Dump_t));
+    self->fd = fd;
+    self->mode = mode;
+    if (buf == NULL)
+    {
+        self->cap = CCTR_DUMP_BUFFER;
+        self->buf = (uint8_t *)malloc(self->cap);
+        assert(self->buf != NULL);
+        self->owned = 1;
+    }
+    else
+    {
+        assert(cap >= CCTR_DUMP_MIN_BUFFER);
+        self->buf = (uint8_t *)buf;
+        self->cap = cap;
+    }
+}
+
+int cctr_dump_flush(Cctr_Dump_t *self)
+{
+    assert(self != NULL);
+    _dump_write_(self, self->buf, self->len);
+    self->len = 0;
+    if (self->error)
+    {
+        errno = self->error;
+        return -1;
+    }
+    return 0;
+}
+
+int cctr_dump_close(Cctr_Dump_t *self)
+{
+    int ret = cctr_dump_flush(self);
+    if (self->owned)
+        free(self->buf);
+    self->buf = NULL;
+    return ret;
+}
+
+int cctr_dump_elements(Cctr_Dump_t *self, const void *data, uint64_t n, uint32_t dsize)
+{
+    assert(self != NULL && dsize > 0);
+    const uint8_t *ptr = (const uint8_t *)data;
+    if (self->mode == CCTR_DUMP_RAW)
+    {
+        // a run larger than the buffer skips it
+        uint64_t bytes = n * dsize;
+        if (self->cap - self->len < bytes)
+        {
+            _dump_write_(self, self->buf, self->len);
+            self->len = 0;
+        }
+        if (bytes >= self->cap)
+            _dump_write_(self, ptr, bytes);
+        else
+        {
+            memcpy(self->buf + self->len, ptr, bytes);
+            self->len += bytes;
+        }
+        self->index += n;
+    }
+    else
+        for (uint64_t i = 0; i < n && self->error == 0; i++, ptr += dsize)
+        {
+            if (self->mode == CCTR_DUMP_HEX)
+                _dump_hex_element_(self, ptr, dsize);
+            else
+                _dump_csv_element_(self, ptr, dsize);
+            self->index++;
+        }
+    if (self->error)
+    {
+        errno = self->error;
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Containers
+ */
+static inline int _dump_range_(Cctr_Dump_t *dump, uint64_t *from, uint64_t *to, uint64_t size)
+{
+    // clamps the range, 0 when it is empty
+    assert(dump != NULL);
+    *to = *to < size ? *to : size;
+    dump->index = *from;
+    return *from < *to;
+}
+
+static inline int _dump_status_(Cctr_Dump_t *dump)
+{
+    if (dump->error)
+    {
+        errno = dump->error;
+        return -1;
+    }
+    return 0;
+}
+
+int list_dump(List_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (!_dump_range_(dump, &from, &to, self->size))
+        return _dump_status_(dump);
+
+    // walk to from from whichever end is closer
+    List_Node_t *ptr;
+    if (from <= self->size / 2)
+    {
+        ptr = self->head;
+        for (uint64_t i = 0; i < from; i++)
+            ptr = ptr->next;
+    }
+    else
+    {
+        ptr = self->tail;
+        for (uint64_t i = self->size - 1; i > from; i--)
+            ptr = ptr->prev;
+    }
+    for (uint64_t i = from; i < to && dump->error == 0; i++, ptr = ptr->next)
+        cctr_dump_elements(dump, ptr->data, 1, self->dsize);
+    return _dump_status_(dump);
+}
+
+void list_print(List_t *self)
+{
+    // hex lines "<index>: <bytes>" on stdout, through one buffered dump, here so
+    // that list.c does not depend on the other containers dump.h includes
+    Cctr_Dump_t dump;
+    fflush(stdout);
+    cctr_dump_init(&dump, STDOUT_FILENO, CCTR_DUMP_HEX, NULL, 0);
+    list_dump(self, &dump, 0, UINT64_MAX);
+    cctr_dump_close(&dump);
+}
+
+int slist_dump(Slist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (!_dump_range_(dump, &from, &to, self->size))
+        return _dump_status_(dump);
+
+    Slist_Node_t *ptr = self->head;
+    for (uint64_t i = 0; i < from; i++)
+        ptr = ptr->next;
+    for (uint64_t i = from; i < to && dump->error == 0; i++, ptr = ptr->next)
+        cctr_dump_elements(dump, ptr->data, 1, self->dsize);
+    return _dump_status_(dump);
+}
+
+int xlist_dump(Xlist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (!_dump_range_(dump, &from, &to, self->size))
+        return _dump_status_(dump);
+
+    Xlist_Node_t *prev = NULL;
+    Xlist_Node_t *ptr = self->head;
+    for (uint64_t i = 0; i < to && dump->error == 0; i++)
+    {
+        if (i >= from)
+            cctr_dump_elements(dump, ptr->data, 1, self->dsize);
+        Xlist_Node_t *next = (Xlist_Node_t *)((uintptr_t)prev ^ (uintptr_t)ptr->diff);
+        prev = ptr;
+        ptr = next;
+    }
+    return _dump_status_(dump);
+}
+
+int array_dump(Array_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (_dump_range_(dump, &from, &to, self->size))
+        cctr_dump_elements(dump, (uint8_t *)self->data + from * self->dsize, to - from, self->dsize);
+    return _dump_status_(dump);
+}
+
+static void _plist_dump_(Plist_Node_t *node, Cctr_Dump_t *dump, uint64_t from, uint64_t to, uint32_t dsize)
+{
+    // [from, to) relative to the first element below node, both inside it
+    if (node->leaf)
+    {
+        cctr_dump_elements(dump, node->data + from * dsize, to - from, dsize);
+        return;
+    }
+    for (uint32_t i = 0; i < node->count && from < to; i++)
+    {
+        uint64_t size = node->child[i]->size;
+        if (from < size)
+            _plist_dump_(node->child[i], dump, from, to < size ? to : size, dsize);
+        from = from > size ? from - size : 0;
+        to -= to > size ? size : to;
+    }
+}
+
+int plist_dump(Plist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (_dump_range_(dump, &from, &to, self->size))
+        _plist_dump_(self->root, dump, from, to, self->dsize);
+    return _dump_status_(dump);
+}
+
+typedef struct
+{
+    Cctr_Dump_t *dump;
+    uint64_t pos;
+    uint64_t from;
+    uint64_t to;
+    uint32_t dsize;
+} _Dump_Each_t;
+
+static void _clist_dump_(const void *data, void *ctx)
+{
+    _Dump_Each_t *each = (_Dump_Each_t *)ctx;
+    if (each->pos >= each->from && each->pos < each->to)
+        cctr_dump_elements(each->dump, data, 1, each->dsize);
+    each->pos++;
+}
+
+int clist_dump(Clist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    // the size is read once, elements inserted behind the range while it runs are left out
+    assert(self != NULL);
+    if (!_dump_range_(dump, &from, &to, __atomic_load_n(&self->size, __ATOMIC_ACQUIRE)))
+        return _dump_status_(dump);
+
+    _Dump_Each_t each = {dump, 0, from, to, self->dsize};
+    clist_for_each(self, _clist_dump_, &each);
+    return _dump_status_(dump);
+}
+
+int gap_dump(Gap_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (!_dump_range_(dump, &from, &to, gap_size(self)))
+        return _dump_status_(dump);
+
+    // one run in front of the gap, one behind it
+    if (from < self->cursor)
+    {
+        uint64_t end = to < self->cursor ? to : self->cursor;
+        cctr_dump_elements(dump, self->data + from * self->dsize, end - from, self->dsize);
+        from = end;
+    }
+    if (from < to)
+    {
+        uint64_t shift = self->gap_end - self->cursor;
+        cctr_dump_elements(dump, self->data + (from + shift) * self->dsize, to - from, self->dsize);
+    }
+    return _dump_status_(dump);
+}
+
+static void _rope_dump_(Rope_Node_t *node, Cctr_Dump_t *dump, uint64_t from, uint64_t to, uint32_t dsize)
+{
+    if (node->leaf)
+    {
+        cctr_dump_elements(dump, node->data + from * dsize, to - from, dsize);
+        return;
+    }
+    for (uint32_t i = 0; i < node->count && from < to; i++)
+    {
+        uint64_t size = node->child[i]->size;
+        if (from < size)
+            _rope_dump_(node->child[i], dump, from, to < size ? to : size, dsize);
+        from = from > size ? from - size : 0;
+        to -= to > size ? size : to;
+    }
+}
+
+int rope_dump(Rope_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (_dump_range_(dump, &from, &to, self->size))
+        _rope_dump_(self->root, dump, from, to, self->dsize);
+    return _dump_status_(dump);
+}
+
+int stream_dump(Stream_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    if (!_dump_range_(dump, &from, &to, self->size))
+        return _dump_status_(dump);
+
+    Stream_Iter_t iter;
+    stream_iter_begin(self, &iter, from);
+    int ret = 0;
+    for (uint64_t i = from; i < to && dump->error == 0; i++)
+    {
+        void *ptr = stream_iter_next(&iter);
+        if (ptr == NULL)
+        {
+            // read error, errno is from the stream
+            ret = -1;
+            break;
+        }
+        cctr_dump_elements(dump, ptr, 1, self->dsize);
+    }
+    int err = errno;
+    stream_iter_end(&iter);
+    if (ret < 0)
+    {
+        errno = err;
+        return -1;
+    }
+    return _dump_status_(dump);
+}
@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "list.h"
+#include "slist.h"
+#include "xlist.h"
+#include "array.h"
+#include "plist.h"
+#include "clist.h"
+#include "gap.h"
+#include "rope.h"
+#include "stream.h"
+
+#pragma once
+
+/*
+ * Strcture
+ * Buffered dump of elements to a file descriptor. Elements are formatted
+ * into one buffer, user supplied or CCTR_DUMP_BUFFER bytes from malloc, which
+ * goes out with a single write whenever it is full, so a dump of a million
+ * elements costs a few dozen system calls.
+ *
+ * CCTR_DUMP_HEX   one line per element: "<index>: <bytes in memory order>"
+ * CCTR_DUMP_RAW   the payloads back to back, runs of contiguous containers
+ *                 larger than the buffer are written straight from them
+ * CCTR_DUMP_CSV   one line per element, the element read as unsigned
+ *                 integers of width bytes in host byte order, separated by
+ *                 commas. width is 0 after init, which picks the widest of
+ *                 8, 4, 2, 1 dividing dsize
+ *
+ * A write error sticks: later calls do nothing and return -1 with the errno
+ * of the failure.
+ */
+#define CCTR_DUMP_BUFFER (1 << 20)
+#define CCTR_DUMP_MIN_BUFFER 2048 // holds one formatted chunk of 64 bytes or integers
+
+typedef enum
+{
+    CCTR_DUMP_HEX = 0,
+    CCTR_DUMP_RAW = 1,
+    CCTR_DUMP_CSV = 2,
+} Cctr_Dump_Mode_t;
+
+typedef struct
+{
+    int fd;
+    Cctr_Dump_Mode_t mode;
+    uint8_t *buf;
+    uint64_t cap;
+    uint64_t len; // bytes in buf
+    uint64_t index; // of the next element, printed by CCTR_DUMP_HEX
+    uint32_t width; // bytes per CCTR_DUMP_CSV field, 1, 2, 4 or 8 dividing dsize, 0 picks the widest
+    int owned; // buf is from malloc
+    int error; // errno of the first failed write, 0 while none failed
+} Cctr_Dump_t;
+
+/*
+ * Construct & Desctruct
+ * buf == NULL takes a CCTR_DUMP_BUFFER buffer from malloc, otherwise cap is
+ * at least CCTR_DUMP_MIN_BUFFER bytes. cctr_dump_close flushes and releases
+ * the buffer, the descriptor stays open.
+ */
+void cctr_dump_init(Cctr_Dump_t *self, int fd, Cctr_Dump_Mode_t mode, void *buf, uint64_t cap);
+int cctr_dump_flush(Cctr_Dump_t *self);
+int cctr_dump_close(Cctr_Dump_t *self);
+
+/*
+ * Elements, for containers without a dump of their own (Bset_t, Sparse_t, ..)
+ * n elements of dsize bytes back to back, numbered from self->index on
+ */
+int cctr_dump_elements(Cctr_Dump_t *self, const void *data, uint64_t n, uint32_t dsize);
+
+/*
+ * Containers, 0 on success and -1 with errno set
+ * the elements at [from, to) are dumped, to is clamped to the size, so
+ * (0, UINT64_MAX) dumps all of them. Numbering starts at from.
+ */
+int list_dump(List_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int slist_dump(Slist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int xlist_dump(Xlist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int array_dump(Array_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int plist_dump(Plist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int clist_dump(Clist_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int gap_dump(Gap_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int rope_dump(Rope_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
+int stream_dump(Stream_t *self, Cctr_Dump_t *dump, uint64_t from, uint64_t to);
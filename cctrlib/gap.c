@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include "gap.h"
+
+#define _GAP_MIN_ 16 // initial capacity in elements
+
+static inline uint8_t *_gap_ptr_(Gap_t *self, uint64_t idx)
+{
+    return self->data + idx * self->dsize;
+}
+
+// grows the gap to at least n elements, the back moves to the end of the new allocation
+static void _gap_reserve_(Gap_t *self, uint64_t n)
+{
+    if (self->gap_end - self->cursor >= n)
+        return;
+    uint64_t back = self->capacity - self->gap_end;
+    uint64_t capacity = self->capacity > _GAP_MIN_ ? self->capacity : _GAP_MIN_;
+    while (capacity - self->cursor - back < n)
+        capacity *= 2;
+    self->data = (uint8_t *)realloc(self->data, capacity * self->dsize);
+    assert(self->data != NULL);
+    memmove(_gap_ptr_(self, capacity - back), _gap_ptr_(self, self->gap_end), back * self->dsize);
+    self->gap_end = capacity - back;
+    self->capacity = capacity;
+}
+
+/*
+ * Construct & Desctruct
+ */
+Gap_t *gap_construct(uint32_t dsize)
+{
+    assert(dsize > 0);
+    Gap_t *ret = (Gap_t *)malloc(sizeof(Gap_t));
+    assert(ret != NULL);
+    ret->data = NULL;
+    ret->capacity = 0;
+    ret->cursor = 0;
+    ret->gap_end = 0;
+    ret->dsize = dsize;
+    return ret;
+}
+
+Gap_t *gap_from_array(const void *array, uint64_t asize, uint32_t dsize)
+{
+    Gap_t *ret = gap_construct(dsize);
+    gap_insert(ret, array, asize);
+    return ret;
+}
+
+void gap_clear(Gap_t *self)
+{
+    assert(self != NULL);
+    free(self->data);
+    self->data = NULL;
+    self->capacity = 0;
+    self->cursor = 0;
+    self->gap_end = 0;
+}
+
+void gap_destroy(Gap_t *self)
+{
+    gap_clear(self);
+    free(self);
+}
+
+/*
+ * Usage
+ */
+uint64_t gap_size(Gap_t *self)
+{
+    return self->capacity - (self->gap_end - self->cursor);
+}
+
+void gap_move(Gap_t *self, uint64_t pos)
+{
+    assert(self != NULL && pos <= gap_size(self));
+    if (pos < self->cursor)
+    {
+        // the elements between pos and the cursor go behind the gap
+        uint64_t n = self->cursor - pos;
+        memmove(_gap_ptr_(self, self->gap_end - n), _gap_ptr_(self, pos), n * self->dsize);
+        self->gap_end -= n;
+    }
+    else if (pos > self->cursor)
+    {
+        uint64_t n = pos - self->cursor;
+        memmove(_gap_ptr_(self, self->cursor), _gap_ptr_(self, self->gap_end), n * self->dsize);
+        self->gap_end += n;
+    }
+    self->cursor = pos;
+}
+
+void gap_insert(Gap_t *self, const void *array, uint64_t n)
+{
+    assert(self != NULL && (array != NULL || n == 0));
+    if (n == 0)
+        return;
+    _gap_reserve_(self, n);
+    memcpy(_gap_ptr_(self, self->cursor), array, n * self->dsize);
+    self->cursor += n;
+}
+
+void gap_erase(Gap_t *self, uint64_t n)
+{
+    assert(self != NULL && self->gap_end + n <= self->capacity);
+    self->gap_end += n;
+}
+
+void gap_backspace(Gap_t *self, uint64_t n)
+{
+    assert(self != NULL && n <= self->cursor);
+    self->cursor -= n;
+}
+
+void *gap_at(Gap_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    if (pos >= gap_size(self))
+        return NULL;
+    return _gap_ptr_(self, pos < self->cursor ? pos : pos + self->gap_end - self->cursor);
+}
+
+void gap_export(Gap_t *self, void *out)
+{
+    assert(self != NULL);
+    if (self->data == NULL)
+        return;
+    uint64_t back = self->capacity - self->gap_end;
+    memcpy(out, self->data, self->cursor * self->dsize);
+    memcpy((uint8_t *)out + self->cursor * self->dsize, _gap_ptr_(self, self->gap_end), back * self->dsize);
+}
@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Gap buffer, one allocation of capacity elements with the unused part (the
+ * gap) kept at the cursor. Inserting and erasing at the cursor only moves the
+ * gap bounds, moving the cursor moves the elements between the old and the
+ * new place across the gap. Made for edits which stay close to each other.
+ *
+ *   | front ... | gap | ... back |
+ *   0           cursor  gap_end  capacity
+ */
+typedef struct
+{
+    uint8_t *data;
+    uint64_t capacity; // in elements
+    uint64_t cursor;   // first element of the gap, the number of elements in front
+    uint64_t gap_end;  // first element behind the gap
+    uint32_t dsize;
+} Gap_t;
+
+/*
+ * Construct & Desctruct
+ */
+Gap_t *gap_construct(uint32_t dsize);
+Gap_t *gap_from_array(const void *array, uint64_t asize, uint32_t dsize);
+void gap_clear(Gap_t *self);
+void gap_destroy(Gap_t *self);
+
+/*
+ * Usage
+ * gap_erase drops n elements behind the cursor, gap_backspace n in front of it
+ */
+uint64_t gap_size(Gap_t *self);
+void gap_move(Gap_t *self, uint64_t pos);
+void gap_insert(Gap_t *self, const void *array, uint64_t n);
+void gap_erase(Gap_t *self, uint64_t n);
+void gap_backspace(Gap_t *self, uint64_t n);
+void *gap_at(Gap_t *self, uint64_t pos);
+void gap_export(Gap_t *self, void *out); // all elements, gap_size * dsize bytes
@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#pragma once
+
+/*
+ * Hash
+ * Streaming 64 bit hash in the style of wyhash: 64 byte stripes are folded
+ * into four lanes with 64 x 64 -> 128 bit multiplies, a shorter rest waits in
+ * a buffer. Feeding a sequence in pieces gives the value of hashing it in one
+ * call, so a list hashes like an array of the same payloads. Not for
+ * adversarial input and not stable across byte orders.
+ */
+#define CCTR_HASH_SEED 0x9E3779B97F4A7C15ULL
+#define CCTR_HASH_STRIPE 64
+
+typedef struct
+{
+    uint64_t lane[4];
+    uint64_t total; // bytes fed
+    uint32_t len;   // bytes in buf
+    uint8_t buf[CCTR_HASH_STRIPE];
+} Cctr_Hash_t;
+
+static const uint64_t _cctr_hash_secret_[4] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+                                               0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+static inline uint64_t _cctr_hash_mix_(uint64_t a, uint64_t b)
+{
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+static inline uint64_t _cctr_hash_read_(const uint8_t *ptr)
+{
+    uint64_t ret;
+    memcpy(&ret, ptr, sizeof(ret));
+    return ret;
+}
+
+static inline void _cctr_hash_stripe_(uint64_t *lane, const uint8_t *ptr)
+{
+    // added rather than assigned, a zero product must not wipe the lane
+    for (int i = 0; i < 4; i++)
+        lane[i] += _cctr_hash_mix_(_cctr_hash_read_(ptr + 16 * i) ^ _cctr_hash_secret_[i],
+                                   _cctr_hash_read_(ptr + 16 * i + 8) ^ lane[i]);
+}
+
+static inline void cctr_hash_init(Cctr_Hash_t *self, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+        self->lane[i] = seed ^ _cctr_hash_secret_[(i + 1) & 3];
+    self->total = 0;
+    self->len = 0;
+}
+
+static inline void cctr_hash_update(Cctr_Hash_t *self, const void *data, uint64_t len)
+{
+    const uint8_t *ptr = (const uint8_t *)data;
+    self->total += len;
+    if (len < CCTR_HASH_STRIPE - self->len)
+    {
+        // small pieces, one payload of a list node
+        if (len > 0)
+            memcpy(self->buf + self->len, ptr, len);
+        self->len += (uint32_t)len;
+        return;
+    }
+    if (self->len > 0)
+    {
+        uint32_t n = CCTR_HASH_STRIPE - self->len;
+        memcpy(self->buf + self->len, ptr, n);
+        _cctr_hash_stripe_(self->lane, self->buf);
+        ptr += n;
+        len -= n;
+    }
+    // whole stripes straight from the input
+    for (; len >= CCTR_HASH_STRIPE; ptr += CCTR_HASH_STRIPE, len -= CCTR_HASH_STRIPE)
+        _cctr_hash_stripe_(self->lane, ptr);
+    memcpy(self->buf, ptr, len);
+    self->len = (uint32_t)len;
+}
+
+static inline uint64_t cctr_hash_final(const Cctr_Hash_t *self)
+{
+    uint64_t h = _cctr_hash_mix_(self->lane[0] ^ _cctr_hash_secret_[1], self->lane[1]) ^
+                 _cctr_hash_mix_(self->lane[2] ^ _cctr_hash_secret_[3], self->lane[3]);
+
+    // the rest in 16 byte pieces, zero padded
+    uint8_t tail[CCTR_HASH_STRIPE] = {0};
+    memcpy(tail, self->buf, self->len);
+    for (uint32_t i = 0; i < self->len; i += 16)
+        h += _cctr_hash_mix_(_cctr_hash_read_(tail + i) ^ _cctr_hash_secret_[1], _cctr_hash_read_(tail + i + 8) ^ h);
+    return _cctr_hash_mix_(h ^ _cctr_hash_secret_[0], self->total ^ _cctr_hash_secret_[1]);
+}
+
+static inline uint64_t cctr_hash(const void *data, uint64_t len, uint64_t seed)
+{
+    Cctr_Hash_t h;
+    cctr_hash_init(&h, seed);
+    cctr_hash_update(&h, data, len);
+    return cctr_hash_final(&h);
+}
@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "huge.h"
+
+void *cctr_huge_map(uint64_t bytes, uint64_t *map_size)
+{
+    assert(map_size != NULL);
+    uint64_t size = (bytes + CCTR_HUGE_PAGE - 1) & ~(CCTR_HUGE_PAGE - 1);
+    size = size ? size : CCTR_HUGE_PAGE;
+
+    // one huge page more than needed, the unaligned head and the tail are given back
+    uint8_t *map = (uint8_t *)mmap(NULL, size + CCTR_HUGE_PAGE, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED)
+    {
+        void *ret = calloc(1, bytes ? bytes : 1);
+        assert(ret != NULL);
+        *map_size = 0;
+        return ret;
+    }
+    uint8_t *aligned = (uint8_t *)(((uintptr_t)map + CCTR_HUGE_PAGE - 1) & ~(uintptr_t)(CCTR_HUGE_PAGE - 1));
+    if (aligned > map)
+        munmap(map, aligned - map);
+    munmap(aligned + size, map + size + CCTR_HUGE_PAGE - (aligned + size));
+#ifdef MADV_HUGEPAGE
+    // refused when the kernel has no transparent huge pages, the pages stay small
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    *map_size = size;
+    return aligned;
+}
+
+void cctr_huge_unmap(void *ptr, uint64_t map_size)
+{
+    if (map_size != 0)
+        munmap(ptr, map_size);
+    else
+        free(ptr);
+}
+
+// ------------------------------------------------------------------
+Cctr_Huge_t *cctr_huge_construct(uint64_t stride)
+{
+    assert(stride > 0 && stride <= CCTR_HUGE_REGION - CCTR_BLOCK_HEADER);
+    Cctr_Huge_t *ret = (Cctr_Huge_t *)calloc(1, sizeof(Cctr_Huge_t));
+    assert(ret != NULL);
+    ret->stride = CCTR_ALIGN(stride);
+    return ret;
+}
+
+void *cctr_huge_alloc(Cctr_Huge_t *self, Cctr_Block_t **block)
+{
+    assert(self != NULL && block != NULL);
+    if (self->next == self->count)
+    {
+        // the arena holds one reference on the region it carves from
+        if (self->block != NULL)
+            cctr_block_release(self->block);
+        uint64_t map_size;
+        self->block = (Cctr_Block_t *)cctr_huge_map(CCTR_HUGE_REGION, &map_size);
+        self->block->refs = 1;
+        self->block->map_size = map_size;
+        self->next = 0;
+        self->count = (CCTR_HUGE_REGION - CCTR_BLOCK_HEADER) / self->stride;
+    }
+    cctr_block_retain(self->block);
+    *block = self->block;
+    return cctr_block_at(self->block, self->stride, self->next++);
+}
+
+void cctr_huge_destroy(Cctr_Huge_t *self)
+{
+    assert(self != NULL);
+    if (self->block != NULL)
+        cctr_block_release(self->block);
+    free(self);
+}
@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "block.h"
+
+#pragma once
+
+/*
+ * Huge pages
+ * Opt-in storage for big containers. Memory is mapped in whole CCTR_HUGE_PAGE
+ * pages, aligned to one and advised with MADV_HUGEPAGE, so the kernel can
+ * back it with huge pages: a traversal of millions of nodes then needs one
+ * TLB entry per 2 MB instead of one per 4 KB. Without transparent huge pages
+ * the mapping keeps ordinary pages, and without mmap it falls back to malloc.
+ *
+ * Cctr_Huge_t hands out node slots of one stride from regions of
+ * CCTR_HUGE_REGION bytes. Every region is a Cctr_Block_t, a slot holds a
+ * reference to its region like a node of a batch, and the region is unmapped
+ * with its last slot. Slots are not reused, a region whose nodes were erased
+ * one by one stays mapped until the last of them goes (list_compact moves the
+ * survivors).
+ */
+#define CCTR_HUGE_PAGE (2ULL << 20)
+#define CCTR_HUGE_REGION CCTR_HUGE_PAGE
+
+typedef struct Cctr_Huge_t
+{
+    Cctr_Block_t *block; // region slots are carved from, NULL before the first
+    uint64_t stride;
+    uint64_t next;  // next slot of block
+    uint64_t count; // slots in block
+} Cctr_Huge_t;
+
+/*
+ * Mapping
+ * cctr_huge_map returns at least bytes of zeroed memory, *map_size is the
+ * length of the mapping or 0 when it came from malloc. cctr_huge_unmap frees
+ * either kind.
+ */
+void *cctr_huge_map(uint64_t bytes, uint64_t *map_size);
+void cctr_huge_unmap(void *ptr, uint64_t map_size);
+
+/*
+ * Node slots
+ * cctr_huge_alloc returns a slot of stride bytes and the region it holds a
+ * reference to, release it with cctr_block_release. cctr_huge_destroy drops
+ * the arena, regions stay until their slots are released.
+ */
+Cctr_Huge_t *cctr_huge_construct(uint64_t stride);
+void *cctr_huge_alloc(Cctr_Huge_t *self, Cctr_Block_t **block);
+void cctr_huge_destroy(Cctr_Huge_t *self);
@@ -20,7 +20,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <assert.h>
+#include "block.h"
+#include "hash.h"
+#include "huge.h"
 #include "list.h"
+#include "reclaim.h"
 
 List_t *list_init(uint32_t dsize)
 {
@@ -30,9 +34,205 @@ List_t *list_init(uint32_t dsize)
     ret->head = NULL;
     ret->tail = NULL;
     ret->dsize = dsize;
+    ret->huge = NULL;
+    ret->defer = NULL;
+    ret->version = 1;
+    ret->hash = 0;
+    ret->hash_version = 0;
+#ifdef CCTR_STATS
+    cctr_stats_register(&ret->stats, "List_t", ret);
+    ret->compact_ratio = 0;
+#endif
+#ifdef CCTR_PREFETCH
+    ret->skip = NULL;
+    ret->skip_version = 0;
+#endif
     return ret;
 }
 
+List_t *list_init_huge(uint32_t dsize)
+{
+    // node and payload in one slot, the layout of a batch
+    List_t *ret = list_init(dsize);
+    ret->huge = cctr_huge_construct(CCTR_ALIGN(sizeof(List_Node_t)) + CCTR_ALIGN(dsize));
+    return ret;
+}
+
+// ------------------------------------------------------------------
+/*
+ * Prefetch
+ * A long list gets an array of its nodes on the second search at the same
+ * version, so a traversal can prefetch a node and its payload ahead of use
+ * instead of stalling on every next pointer. A list changed between searches
+ * is walked plainly and never pays for an array it drops right away. Anything
+ * which links or frees a node drops the array and bumps the version
+ * (list_hash).
+ */
+#ifdef CCTR_PREFETCH
+#define _LIST_MODIFIED_(self) _list_skip_reset_(self)
+
+static List_Node_t **_list_skip_(List_t *self)
+{
+    if (self->skip == NULL && self->size >= CCTR_PREFETCH_MIN)
+    {
+        if (self->skip_version != self->version)
+        {
+            self->skip_version = self->version;
+            return NULL;
+        }
+        self->skip = (List_Node_t **)malloc((uint64_t)self->size * sizeof(List_Node_t *));
+        assert(self->skip != NULL);
+        uint32_t i = 0;
+        for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next)
+            self->skip[i++] = ptr;
+    }
+    return self->skip;
+}
+
+static inline void _list_prefetch_(List_Node_t **skip, uint32_t size, uint32_t i)
+{
+    if (i + 2 * CCTR_PREFETCH_DIST < size)
+        __builtin_prefetch(skip[i + 2 * CCTR_PREFETCH_DIST]);
+    if (i + CCTR_PREFETCH_DIST < size)
+        __builtin_prefetch(skip[i + CCTR_PREFETCH_DIST]->data);
+}
+#else
+#define _LIST_MODIFIED_(self) ((self)->version++)
+#endif
+
+void _list_skip_reset_(List_t *self)
+{
+    self->version++;
+#ifdef CCTR_PREFETCH
+    free(self->skip);
+    self->skip = NULL;
+#endif
+}
+
+static inline int _list_data_equal_(uint32_t dsize, void *a, void *b)
+{
+    // same comparison as list_find
+    switch (dsize)
+    {
+    case sizeof(uint8_t):
+        return *(uint8_t *)a == *(uint8_t *)b;
+    case sizeof(uint16_t):
+        return *(uint16_t *)a == *(uint16_t *)b;
+    case sizeof(uint32_t):
+        return *(uint32_t *)a == *(uint32_t *)b;
+    case sizeof(uint64_t):
+        return *(uint64_t *)a == *(uint64_t *)b;
+    default:
+        return !memcmp(a, b, dsize);
+    }
+}
+
+static inline List_Node_t *_list_node_huge_(List_t *self)
+{
+    // a slot of the huge page arena, counted as an allocation when it opened a region
+    Cctr_Block_t *block;
+    List_Node_t *node = (List_Node_t *)cctr_huge_alloc(self->huge, &block);
+    node->data = (uint8_t *)node + CCTR_ALIGN(sizeof(List_Node_t));
+    node->block = block;
+    CCTR_STATS_ALLOC(&self->stats, self->huge->next == 1, sizeof(List_Node_t) + self->dsize);
+    return node;
+}
+
+static inline List_Node_t *_list_node_construct_(List_t *self, void *data)
+{
+    _LIST_MODIFIED_(self);
+    if (self->huge != NULL)
+    {
+        List_Node_t *node = _list_node_huge_(self);
+        node->prev = NULL;
+        node->next = NULL;
+        memcpy(node->data, data, self->dsize);
+        return node;
+    }
+    void *node_data;
+    List_Node_t *node = (List_Node_t *)cctr_node_alloc(sizeof(List_Node_t), self->dsize, &node_data);
+    node->data = node_data;
+    node->prev = NULL;
+    node->next = NULL;
+    node->block = NULL;
+    memcpy(node->data, data, self->dsize);
+    CCTR_STATS_ALLOC(&self->stats, CCTR_NODE_ALLOCS(self->dsize), sizeof(List_Node_t) + self->dsize);
+    return node;
+}
+
+static inline void _list_node_release_(List_t *self, List_Node_t *node, Cctr_Reclaim_Batch_t *batch)
+{
+    // freed in place, or added to batch unless it is NULL
+    _LIST_MODIFIED_(self);
+    // nodes of a batch share one block with their payloads, see _list_node_block_
+    if (node->block == NULL)
+    {
+        CCTR_STATS_FREE(&self->stats, CCTR_NODE_ALLOCS(self->dsize), sizeof(List_Node_t) + self->dsize);
+        if (batch != NULL)
+            cctr_reclaim_add(batch, node, self->dsize > CCTR_SMALL_DSIZE ? node->data : NULL, 0);
+        else
+            cctr_node_free(node, node->data, self->dsize);
+        return;
+    }
+    Cctr_Block_t *block = node->block;
+    int last = cctr_block_drop(block);
+    CCTR_STATS_FREE(&self->stats, last, sizeof(List_Node_t) + self->dsize);
+    if (!last)
+        return;
+    if (batch == NULL)
+        cctr_block_free(block);
+    else
+        // the references are dropped on this thread, only the unused block is queued
+        cctr_reclaim_add(batch, block, NULL, block->map_size);
+}
+
+static inline void _list_node_destruct_(List_t *self, List_Node_t *node)
+{
+    _list_node_release_(self, node, self->defer);
+    if (self->defer != NULL && self->defer->count >= CCTR_RECLAIM_STAGE)
+        cctr_reclaim_push(self->defer);
+}
+
+static List_Node_t *_list_node_block_(List_t *self, void *array, uint32_t asize, List_Node_t **last)
+{
+    // links asize nodes carved from one block, in array order, returns the first one
+    const uint64_t node_size = CCTR_ALIGN(sizeof(List_Node_t));
+    const uint64_t stride = node_size + CCTR_ALIGN(self->dsize);
+    Cctr_Block_t *block = NULL;
+    _LIST_MODIFIED_(self);
+    if (self->huge == NULL)
+    {
+        block = cctr_block_construct(asize, stride);
+        CCTR_STATS_ALLOC(&self->stats, 1, (uint64_t)asize * (sizeof(List_Node_t) + self->dsize));
+    }
+
+    uint8_t *aptr = (uint8_t *)array;
+    List_Node_t *first = NULL;
+    List_Node_t *prev = NULL;
+    for (uint32_t i = 0; i < asize; i++)
+    {
+        List_Node_t *node;
+        if (block != NULL)
+        {
+            node = (List_Node_t *)cctr_block_at(block, stride, i);
+            node->data = (uint8_t *)node + node_size;
+            node->block = block;
+        }
+        else
+            node = _list_node_huge_(self);
+        memcpy(node->data, aptr, self->dsize);
+        first = first != NULL ? first : node;
+        node->prev = prev;
+        node->next = NULL;
+        if (prev != NULL)
+            prev->next = node;
+        prev = node;
+        aptr += self->dsize;
+    }
+    *last = prev;
+    return first;
+}
+
 void *list_front(List_t *self)
 {
     assert(self != NULL);
@@ -51,11 +251,7 @@ void *list_back(List_t *self)
 
 void list_push_front(List_t *self, void *data)
 {
-    List_Node_t *tmp = (List_Node_t *)calloc(sizeof(List_Node_t), 1);
-    assert(tmp != NULL);
-    tmp->data = malloc(self->dsize);
-    assert(tmp->data != NULL);
-    memcpy(tmp->data, data, self->dsize);
+    List_Node_t *tmp = _list_node_construct_(self, data);
 
     if (self->head == NULL && self->tail == NULL)
     {
@@ -70,15 +266,13 @@ void list_push_front(List_t *self, void *data)
     }
 
     self->size++;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_PUSH_FRONT);
+    CCTR_STATS_SIZE(&self->stats, self->size);
 }
 
 void list_push_back(List_t *self, void *data)
 {
-    List_Node_t *tmp = (List_Node_t *)calloc(sizeof(List_Node_t), 1);
-    assert(tmp != NULL);
-    tmp->data = malloc(self->dsize);
-    assert(tmp->data != NULL);
-    memcpy(tmp->data, data, self->dsize);
+    List_Node_t *tmp = _list_node_construct_(self, data);
 
     if (self->head == NULL && self->tail == NULL)
     {
@@ -93,6 +287,8 @@ void list_push_back(List_t *self, void *data)
     }
 
     self->size++;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_PUSH_BACK);
+    CCTR_STATS_SIZE(&self->stats, self->size);
 }
 
 void list_pop_front(List_t *self)
@@ -106,9 +302,9 @@ void list_pop_front(List_t *self)
     if (self->head != NULL)
         self->head->prev = NULL;
 
-    free(tmp->data);
-    free(tmp);
+    _list_node_destruct_(self, tmp);
     self->size--;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_POP_FRONT);
 
     if (self->size == 0)
         self->tail = NULL;
@@ -125,19 +321,147 @@ void list_pop_back(List_t *self)
     if (self->tail != NULL)
         self->tail->next = NULL;
 
-    free(tmp->data);
-    free(tmp);
+    _list_node_destruct_(self, tmp);
     self->size--;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_POP_BACK);
 
     if (self->size == 0)
         self->head = NULL;
 }
 
+// ------------------------------------------------------------------
+/*
+ * Batch, the nodes of one call come from one block
+ */
+void list_push_front_n(List_t *self, void *array, uint32_t asize)
+{
+    // array[0] becomes the front
+    assert(self != NULL);
+    if (asize == 0)
+        return;
+
+    List_Node_t *last;
+    List_Node_t *first = _list_node_block_(self, array, asize, &last);
+    if (self->head != NULL)
+    {
+        last->next = self->head;
+        self->head->prev = last;
+    }
+    else
+        self->tail = last;
+    self->head = first;
+
+    self->size += asize;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_PUSH_FRONT);
+    CCTR_STATS_SIZE(&self->stats, self->size);
+}
+
+void list_push_back_n(List_t *self, void *array, uint32_t asize)
+{
+    assert(self != NULL);
+    if (asize == 0)
+        return;
+
+    List_Node_t *last;
+    List_Node_t *first = _list_node_block_(self, array, asize, &last);
+    if (self->tail != NULL)
+    {
+        self->tail->next = first;
+        first->prev = self->tail;
+    }
+    else
+        self->head = first;
+    self->tail = last;
+
+    self->size += asize;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_PUSH_BACK);
+    CCTR_STATS_SIZE(&self->stats, self->size);
+}
+
+static void _list_pop_chain_(List_t *self, List_Node_t *ptr, uint32_t n, void *out)
+{
+    // copies n unlinked nodes from ptr onwards to out (if not NULL) and frees them
+    uint8_t *optr = (uint8_t *)out;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        List_Node_t *to_del = ptr;
+        ptr = ptr->next;
+        if (optr != NULL)
+        {
+            memcpy(optr, to_del->data, self->dsize);
+            optr += self->dsize;
+        }
+        _list_node_release_(self, to_del, self->defer);
+    }
+    if (self->defer != NULL && self->defer->count >= CCTR_RECLAIM_STAGE)
+        cctr_reclaim_push(self->defer);
+}
+
+uint32_t list_pop_front_n(List_t *self, void *out, uint32_t n)
+{
+    // out receives the popped elements in list order, returns the number popped
+    assert(self != NULL);
+    if (n > self->size)
+        n = self->size;
+    if (n == 0)
+        return 0;
+
+    List_Node_t *first = self->head;
+    List_Node_t *rest = first;
+    for (uint32_t i = 0; i < n; i++)
+        rest = rest->next;
+
+    self->head = rest;
+    if (rest != NULL)
+        rest->prev = NULL;
+    else
+        self->tail = NULL;
+    self->size -= n;
+
+    _list_pop_chain_(self, first, n, out);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_POP_FRONT);
+    return n;
+}
+
+uint32_t list_pop_back_n(List_t *self, void *out, uint32_t n)
+{
+    // out receives the popped elements in list order, returns the number popped
+    assert(self != NULL);
+    if (n > self->size)
+        n = self->size;
+    if (n == 0)
+        return 0;
+
+    List_Node_t *first = self->tail;
+    for (uint32_t i = 1; i < n; i++)
+        first = first->prev;
+
+    self->tail = first->prev;
+    if (self->tail != NULL)
+        self->tail->next = NULL;
+    else
+        self->head = NULL;
+    self->size -= n;
+
+    _list_pop_chain_(self, first, n, out);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_POP_BACK);
+    return n;
+}
+
+// ------------------------------------------------------------------
 void *list_at(List_t *self, int32_t pos)
 {
-    if (pos >= self->size || pos < -self->size)
+    CCTR_STATS_OP(&self->stats, CCTR_OP_AT);
+    if (pos >= (int64_t)self->size || pos < -(int64_t)self->size)
         return NULL;
 
+#ifdef CCTR_PREFETCH
+    // indexes an array a search built, a positioned walk does not build one
+    List_Node_t **skip = self->skip;
+    if (skip != NULL)
+        return skip[pos >= 0 ? pos : (int64_t)self->size + pos]->data;
+#endif
+
     if (pos >= 0)
     {
         List_Node_t *ptr = self->head;
@@ -147,6 +471,7 @@ void *list_at(List_t *self, int32_t pos)
             ptr = ptr->next;
             i++;
         }
+        CCTR_STATS_WALK(&self->stats, CCTR_OP_AT, i);
         return ptr->data;
     }
     else // pos < 0
@@ -158,38 +483,97 @@ void *list_at(List_t *self, int32_t pos)
             ptr = ptr->prev;
             i--;
         }
+        CCTR_STATS_WALK(&self->stats, CCTR_OP_AT, -1 - i);
         return ptr->data;
     }
 }
 
 void list_clear(List_t *self)
 {
+    CCTR_STATS_OP(&self->stats, CCTR_OP_CLEAR);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_CLEAR, self->size);
+    // a deferred list hands all its nodes over at once
     List_Node_t *ptr = self->head;
     while (ptr != NULL)
     {
         List_Node_t *to_del = ptr;
         ptr = ptr->next;
-        free(to_del->data);
-        free(to_del);
+        _list_node_release_(self, to_del, self->defer);
     }
+    if (self->defer != NULL)
+        cctr_reclaim_push(self->defer);
+    self->head = NULL;
+    self->tail = NULL;
     self->size = 0;
 }
 
 void list_destroy(List_t *self)
 {
     list_clear(self);
+    if (self->huge != NULL)
+    {
+        // the region the arena carves from goes the way of the nodes
+        Cctr_Block_t *block = self->huge->block;
+        if (self->defer != NULL && block != NULL)
+        {
+            if (cctr_block_drop(block))
+                cctr_reclaim_add(self->defer, block, NULL, block->map_size);
+            self->huge->block = NULL;
+        }
+        cctr_huge_destroy(self->huge);
+    }
+    list_defer_free(self, 0);
+#ifdef CCTR_STATS
+    cctr_stats_unregister(&self->stats);
+#endif
     free(self);
 }
 
 List_t *list_copy(List_t *self)
 {
-    List_t *ret = list_init(self->dsize);
-    for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next)
-        list_push_back(ret, ptr->data);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_COPY);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_COPY, self->size);
+    List_t *ret = self->huge != NULL ? list_init_huge(self->dsize) : list_init(self->dsize);
+    list_defer_free(ret, self->defer != NULL);
+#ifdef CCTR_PREFETCH
+    // only an existing array is used, building one would cost a walk of its own
+    if (self->skip != NULL)
+    {
+        for (uint32_t i = 0; i < self->size; i++)
+        {
+            _list_prefetch_(self->skip, self->size, i);
+            list_push_back(ret, self->skip[i]->data);
+        }
+    }
+    else
+#endif
+        for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next)
+            list_push_back(ret, ptr->data);
+    // same elements, a current hash holds for the copy too
+    if (self->hash_version == self->version)
+    {
+        ret->hash = self->hash;
+        ret->hash_version = ret->version;
+    }
     return ret;
 }
 
-void _list_border_(List_t *self, int32_t pos, uintptr_t *left, uintptr_t *right)
+void list_defer_free(List_t *self, int on)
+{
+    if (on && self->defer == NULL)
+    {
+        self->defer = (Cctr_Reclaim_Batch_t *)calloc(1, sizeof(Cctr_Reclaim_Batch_t));
+        assert(self->defer != NULL);
+    }
+    else if (!on && self->defer != NULL)
+    {
+        cctr_reclaim_push(self->defer);
+        free(self->defer);
+        self->defer = NULL;
+    }
+}
+
+void _list_border_(List_t *self, int64_t pos, uintptr_t *left, uintptr_t *right)
 {
     // ! requires optimization, decide left to right or right to left
     // ! cautious of pos exceeds range
@@ -199,18 +583,20 @@ void _list_border_(List_t *self, int32_t pos, uintptr_t *left, uintptr_t *right)
     // |-3|-2|-1|
     // _________|3| <- list size
 
+    const int64_t size = self->size;
     List_Node_t *ptr;
-    if (pos == self->size)
+    CCTR_STATS_OP(&self->stats, CCTR_OP_BORDER);
+    if (pos == size)
     {
         *left = (uintptr_t)self->tail;
         *right = (uintptr_t)NULL;
     }
-    else if (pos == 0 || pos == -self->size)
+    else if (pos == 0 || pos == -size)
     {
         *left = (uintptr_t)NULL;
         *right = (uintptr_t)self->head;
     }
-    else if (pos > self->size || pos < -self->size)
+    else if (pos > size || pos < -size)
     {
         *left = (uintptr_t)NULL;
         *right = (uintptr_t)NULL;
@@ -221,6 +607,7 @@ void _list_border_(List_t *self, int32_t pos, uintptr_t *left, uintptr_t *right)
         ptr = self->head;
         for (int32_t i = 0; i < pos; i++)
             ptr = ptr->next;
+        CCTR_STATS_WALK(&self->stats, CCTR_OP_BORDER, pos);
         *left = (uintptr_t)ptr->prev;
         *right = (uintptr_t)ptr;
     }
@@ -230,6 +617,7 @@ void _list_border_(List_t *self, int32_t pos, uintptr_t *left, uintptr_t *right)
         ptr = self->tail;
         for (int32_t i = 0; pos < i; i--)
             ptr = ptr->prev;
+        CCTR_STATS_WALK(&self->stats, CCTR_OP_BORDER, -pos);
         *left = (uintptr_t)ptr;
         *right = (uintptr_t)ptr->next;
     }
@@ -237,20 +625,19 @@ void _list_border_(List_t *self, int32_t pos, uintptr_t *left, uintptr_t *right)
 
 // ------------------------------------------------------------------
 
-void list_insert(List_t *self, int32_t pos, void *data)
+void list_insert(List_t *self, int64_t pos, void *data)
 {
-    List_Node_t *left;
-    List_Node_t *right;
+    uintptr_t left_addr;
+    uintptr_t right_addr;
 
-    _list_border_(self, pos, (uintptr_t *)&left, (uintptr_t *)&right);
+    // read back through uintptr_t, writing the node pointers through a casted pointer breaks strict aliasing
+    _list_border_(self, pos, &left_addr, &right_addr);
+    List_Node_t *left = (List_Node_t *)left_addr;
+    List_Node_t *right = (List_Node_t *)right_addr;
     if (left == NULL && right == NULL)
         return;
 
-    List_Node_t *center = (List_Node_t *)calloc(sizeof(List_Node_t), 1);
-    assert(center != NULL);
-    center->data = malloc(self->dsize);
-    assert(center->data != NULL);
-    memcpy(center->data, data, self->dsize);
+    List_Node_t *center = _list_node_construct_(self, data);
     center->prev = left;
     center->next = right;
 
@@ -270,25 +657,31 @@ void list_insert(List_t *self, int32_t pos, void *data)
         right->prev = center;
     }
     self->size++;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_INSERT);
+    CCTR_STATS_SIZE(&self->stats, self->size);
 }
 
 void list_erase(List_t *self, int32_t pos)
 {
-    if (pos == 0 || pos == -self->size)
+    const int64_t size = self->size;
+    if (pos == 0 || pos == -size)
     {
         list_pop_front(self);
         return;
     }
-    if (pos == -1 || pos == self->size - 1)
+    if (pos == -1 || pos == size - 1)
     {
         list_pop_back(self);
         return;
     }
 
-    List_Node_t *left;
-    List_Node_t *right;
+    uintptr_t left_addr;
+    uintptr_t right_addr;
 
-    _list_border_(self, pos, (uintptr_t *)&left, (uintptr_t *)&right);
+    // read back through uintptr_t, writing the node pointers through a casted pointer breaks strict aliasing
+    _list_border_(self, pos, &left_addr, &right_addr);
+    List_Node_t *left = (List_Node_t *)left_addr;
+    List_Node_t *right = (List_Node_t *)right_addr;
     if (left == NULL && right == NULL)
         return;
 
@@ -298,30 +691,48 @@ void list_erase(List_t *self, int32_t pos)
     left->next = right;
     right->prev = left;
 
-    free(to_del->data);
-    free(to_del);
+    _list_node_destruct_(self, to_del);
     self->size--;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_ERASE);
 }
 
 void list_insert_list(List_t *self, int32_t pos, List_t *object)
 {
-    List_t *cpy = list_copy(object);
+    if (object->size == 0)
+        return;
 
-    if (self->size == 0)
+    List_Node_t *left = NULL;
+    List_Node_t *right = NULL;
+    if (self->size > 0)
     {
-        *self = *cpy;
-        return;
-    }
+        uintptr_t left_addr;
+        uintptr_t right_addr;
 
-    List_Node_t *left;
-    List_Node_t *right;
+        // read back through uintptr_t, writing the node pointers through a casted pointer breaks strict aliasing
+        _list_border_(self, pos, &left_addr, &right_addr);
+        left = (List_Node_t *)left_addr;
+        right = (List_Node_t *)right_addr;
 
-    _list_border_(self, pos, (uintptr_t *)&left, (uintptr_t *)&right);
+        if (left == NULL && right == NULL)
+            return;
+    }
 
-    if (left == NULL && right == NULL)
-        return;
+    List_t *cpy = list_copy(object);
+    _LIST_MODIFIED_(self);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_INSERT_LIST);
+    CCTR_STATS_ALLOC(&self->stats, CCTR_NODE_ALLOCS(self->dsize) * (uint64_t)cpy->size,
+                     (uint64_t)cpy->size * (sizeof(List_Node_t) + self->dsize));
+#ifdef CCTR_STATS
+    // the nodes are moved over to self, cpy is released without its own accounting
+    cctr_stats_unregister(&cpy->stats);
+#endif
 
-    if (left == NULL && right != NULL)
+    if (self->size == 0)
+    {
+        self->head = cpy->head;
+        self->tail = cpy->tail;
+    }
+    else if (left == NULL && right != NULL)
     {
         cpy->tail->next = self->head;
         self->head->prev = cpy->tail;
@@ -340,20 +751,19 @@ void list_insert_list(List_t *self, int32_t pos, List_t *object)
         left->next = cpy->head;
         right->prev = cpy->tail;
     }
+    self->size += cpy->size;
+    CCTR_STATS_SIZE(&self->stats, self->size);
+    // moved nodes keep their huge page regions alive by themselves
+    if (cpy->huge != NULL)
+        cctr_huge_destroy(cpy->huge);
+    list_defer_free(cpy, 0);
     free(cpy);
 }
 
 List_t *list_from_array(void *array, uint32_t asize, uint32_t dsize)
 {
     List_t *ret = list_init(dsize);
-
-    uint8_t *aptr = (uint8_t *)array;
-    for (uint32_t i = 0; i < asize; i++)
-    {
-        list_push_back(ret, (void *)aptr);
-        aptr += dsize;
-    }
-
+    list_push_back_n(ret, array, asize);
     return ret;
 }
 
@@ -364,24 +774,207 @@ void list_insert_array(List_t *self, int32_t pos, void *array, uint32_t asize)
     list_destroy(atmp);
 }
 
+// ---------------------------------------------------------------------------------------
+/*
+ * Bulk erase
+ * Matching nodes are unlinked during one traversal and collected in a chain
+ * through their next pointers, the chain is freed in one go at the end.
+ */
+typedef int (*_List_Match_t_)(List_t *self, List_Node_t *kept, List_Node_t *node, void *ctx);
+
+static uint32_t _list_remove_(List_t *self, _List_Match_t_ match, void *ctx)
+{
+    List_Node_t *kept = NULL; // last node which stays
+    List_Node_t *garbage = NULL;
+    List_Node_t *garbage_tail = NULL;
+    uint32_t removed = 0;
+
+    for (List_Node_t *ptr = self->head, *next; ptr != NULL; ptr = next)
+    {
+        next = ptr->next;
+        if (!match(self, kept, ptr, ctx))
+        {
+            ptr->prev = kept;
+            if (kept != NULL)
+                kept->next = ptr;
+            else
+                self->head = ptr;
+            kept = ptr;
+            continue;
+        }
+
+        ptr->next = NULL;
+        if (garbage_tail != NULL)
+            garbage_tail->next = ptr;
+        else
+            garbage = ptr;
+        garbage_tail = ptr;
+        removed++;
+    }
+
+    if (kept != NULL)
+        kept->next = NULL;
+    else
+        self->head = NULL;
+    self->tail = kept;
+    self->size -= removed;
+
+    CCTR_STATS_OP(&self->stats, CCTR_OP_REMOVE);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_REMOVE, self->size + removed);
+    _list_pop_chain_(self, garbage, removed, NULL);
+    return removed;
+}
+
+typedef struct
+{
+    int (*predicate)(void *data, void *ctx);
+    void *ctx;
+} _List_Predicate_t_;
+
+static int _list_match_predicate_(List_t *self, List_Node_t *kept, List_Node_t *node, void *ctx)
+{
+    _List_Predicate_t_ *pred = (_List_Predicate_t_ *)ctx;
+    return pred->predicate(node->data, pred->ctx);
+}
+
+static int _list_match_value_(List_t *self, List_Node_t *kept, List_Node_t *node, void *ctx)
+{
+    return _list_data_equal_(self->dsize, node->data, ctx);
+}
+
+static int _list_match_adjacent_(List_t *self, List_Node_t *kept, List_Node_t *node, void *ctx)
+{
+    return kept != NULL && _list_data_equal_(self->dsize, kept->data, node->data);
+}
+
+uint32_t list_remove_if(List_t *self, int (*predicate)(void *data, void *ctx), void *ctx)
+{
+    assert(self != NULL);
+    assert(predicate != NULL);
+    _List_Predicate_t_ pred = {predicate, ctx};
+    return _list_remove_(self, _list_match_predicate_, &pred);
+}
+
+uint32_t list_remove_value(List_t *self, void *data)
+{
+    assert(self != NULL);
+    assert(data != NULL);
+    return _list_remove_(self, _list_match_value_, data);
+}
+
+uint32_t list_unique(List_t *self)
+{
+    // keeps the first of every run of equal elements
+    assert(self != NULL);
+    return _list_remove_(self, _list_match_adjacent_, NULL);
+}
+
+uint32_t list_erase_range(List_t *self, int32_t from, int32_t to)
+{
+    // erases [from, to), positions as in list_at, the range is clipped to the list
+    assert(self != NULL);
+    const int64_t size = self->size;
+    int64_t begin = from < 0 ? from + size : from;
+    int64_t end = to < 0 ? to + size : to;
+    if (begin < 0)
+        begin = 0;
+    if (end > size)
+        end = size;
+    if (begin >= end)
+        return 0;
+    uint32_t n = (uint32_t)(end - begin);
+
+    // walk to the first node from the closer end
+    List_Node_t *first;
+    if (begin <= size - end)
+    {
+        first = self->head;
+        for (int64_t i = 0; i < begin; i++)
+            first = first->next;
+    }
+    else
+    {
+        first = self->tail;
+        for (int64_t i = size - 1; i > begin; i--)
+            first = first->prev;
+    }
+    List_Node_t *last = first;
+    for (uint32_t i = 1; i < n; i++)
+        last = last->next;
+
+    List_Node_t *left = first->prev;
+    List_Node_t *right = last->next;
+    if (left != NULL)
+        left->next = right;
+    else
+        self->head = right;
+    if (right != NULL)
+        right->prev = left;
+    else
+        self->tail = left;
+    self->size -= n;
+
+    CCTR_STATS_OP(&self->stats, CCTR_OP_ERASE);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_ERASE, (begin <= size - end ? begin : size - 1 - begin) + n);
+    _list_pop_chain_(self, first, n, NULL);
+    return n;
+}
+
 // ---------------------------------------------------------------------------------------
 int32_t list_find_data_range(List_t *self, void *data, uint32_t offset, uint32_t dsize)
 {
     if ((offset + dsize) > self->dsize)
         return -1;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_FIND);
+#ifdef CCTR_PREFETCH
+    List_Node_t **skip = _list_skip_(self);
+    if (skip != NULL)
+    {
+        for (uint32_t i = 0; i < self->size; i++)
+        {
+            _list_prefetch_(skip, self->size, i);
+            if (!memcmp(data, skip[i]->data + offset, dsize))
+            {
+                CCTR_STATS_WALK(&self->stats, CCTR_OP_FIND, i + 1);
+                return i;
+            }
+        }
+        CCTR_STATS_WALK(&self->stats, CCTR_OP_FIND, self->size);
+        return -1;
+    }
+#endif
     int32_t pos = 0;
     for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next, pos++)
         if (!memcmp(data, ptr->data + offset, dsize))
+        {
+            CCTR_STATS_WALK(&self->stats, CCTR_OP_FIND, pos + 1);
             return pos;
+        }
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_FIND, pos);
     return -1;
 }
 
-int32_t list_find(List_t *self, void *data)
+static inline int32_t _list_find_(List_t *self, void *data)
 {
     // ! check optimization for single memcmp or switch for different data size is better
+#ifdef CCTR_PREFETCH
+    List_Node_t **skip = _list_skip_(self);
+    if (skip != NULL)
+    {
+        for (uint32_t i = 0; i < self->size; i++)
+        {
+            _list_prefetch_(skip, self->size, i);
+            CCTR_STATS_HOP(&self->stats, skip[i]->prev, skip[i]);
+            if (_list_data_equal_(self->dsize, data, skip[i]->data))
+                return i;
+        }
+        return -1;
+    }
+#endif
     int32_t pos = 0;
     for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next, pos++)
     {
+        CCTR_STATS_HOP(&self->stats, ptr->prev, ptr);
         switch (self->dsize)
         {
         case sizeof(uint8_t):
@@ -412,27 +1005,160 @@ int32_t list_find(List_t *self, void *data)
     return -1;
 }
 
-// ------------------------------------ Test --------------------------------------------------
-void list_print(List_t *self)
+int32_t list_find(List_t *self, void *data)
+{
+    int32_t pos = _list_find_(self, data);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_FIND);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_FIND, pos >= 0 ? (uint32_t)pos + 1 : self->size);
+#ifdef CCTR_STATS
+    // decided once the whole list has been walked since the last compaction
+    if (self->compact_ratio > 0 && self->stats.hops >= self->size &&
+        (double)self->stats.hops_far > self->compact_ratio * (double)self->stats.hops)
+        list_compact(self);
+#endif
+    return pos;
+}
+
+// ------------------------------------------------------------------
+int list_equal(List_t *self, List_t *other)
+{
+    if (self == other)
+        return 1;
+    if (self->size != other->size || self->dsize != other->dsize)
+        return 0;
+    // two current hashes which differ settle it without a walk
+    if (self->hash_version == self->version && other->hash_version == other->version && self->hash != other->hash)
+        return 0;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_COMPARE);
+    uint32_t pos = 0;
+    for (List_Node_t *a = self->head, *b = other->head; a != NULL; a = a->next, b = b->next, pos++)
+        if (!_list_data_equal_(self->dsize, a->data, b->data))
+        {
+            CCTR_STATS_WALK(&self->stats, CCTR_OP_COMPARE, pos + 1);
+            return 0;
+        }
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_COMPARE, pos);
+    return 1;
+}
+
+int list_compare(List_t *self, List_t *other)
 {
-    int itr = 0;
-    for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next)
+    assert(self->dsize == other->dsize);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_COMPARE);
+    List_Node_t *a = self->head;
+    List_Node_t *b = other->head;
+    uint32_t pos = 0;
+    for (; a != NULL && b != NULL && a != b; a = a->next, b = b->next, pos++)
     {
-        printf("itr-%i: ", itr++);
+        int ret = memcmp(a->data, b->data, self->dsize);
+        if (ret != 0)
+        {
+            CCTR_STATS_WALK(&self->stats, CCTR_OP_COMPARE, pos + 1);
+            return ret < 0 ? -1 : 1;
+        }
+    }
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_COMPARE, pos);
+    // a == b only for a list compared with itself
+    if (a == b)
+        return 0;
+    return a == NULL ? -1 : 1;
+}
+
+uint64_t list_hash(List_t *self)
+{
+    if (self->hash_version == self->version)
+        return self->hash;
 
-        uint8_t *data = (uint8_t *)ptr->data;
+    CCTR_STATS_OP(&self->stats, CCTR_OP_HASH);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_HASH, self->size);
+    Cctr_Hash_t hash;
+    cctr_hash_init(&hash, CCTR_HASH_SEED);
+#ifdef CCTR_PREFETCH
+    List_Node_t **skip = _list_skip_(self);
+    if (skip != NULL)
+        for (uint32_t i = 0; i < self->size; i++)
+        {
+            _list_prefetch_(skip, self->size, i);
+            cctr_hash_update(&hash, skip[i]->data, self->dsize);
+        }
+    else
+#endif
+        for (List_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next)
+            cctr_hash_update(&hash, ptr->data, self->dsize);
+    self->hash = cctr_hash_final(&hash);
+    self->hash_version = self->version;
+    return self->hash;
+}
 
-        for (uint32_t i = 0; i < self->dsize; i++)
-            printf("%02x ", data[i]);
+void list_touch(List_t *self)
+{
+    self->version++;
+}
+
+// ------------------------------------------------------------------
+void list_compact(List_t *self)
+{
+    CCTR_STATS_OP(&self->stats, CCTR_OP_COMPACT);
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_COMPACT, self->size);
+#ifdef CCTR_STATS
+    self->stats.hops = 0;
+    self->stats.hops_far = 0;
+#endif
+    if (self->size == 0)
+        return;
 
-        // if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
-        //     for (int i = self->size; i > 0; i--)
-        //         printf("%02x", data[i - 1]);
+    // same layout as a batch, each old node is freed once copied, a huge list
+    // copies into fresh slots of its arena
+    const uint64_t node_size = CCTR_ALIGN(sizeof(List_Node_t));
+    const uint64_t stride = node_size + CCTR_ALIGN(self->dsize);
+    Cctr_Block_t *block = NULL;
+    if (self->huge == NULL)
+    {
+        block = cctr_block_construct(self->size, stride);
+        CCTR_STATS_ALLOC(&self->stats, 1, (uint64_t)self->size * (sizeof(List_Node_t) + self->dsize));
+    }
 
-        // if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
-        //     for (int i = 0; i < self->size; i--)
-        //         printf("%02x", data[i]);
+    List_Node_t *old = self->head;
+    List_Node_t *first = NULL;
+    List_Node_t *prev = NULL;
+    for (uint32_t i = 0; i < self->size; i++)
+    {
+        List_Node_t *node;
+        if (block != NULL)
+        {
+            node = (List_Node_t *)cctr_block_at(block, stride, i);
+            node->data = (uint8_t *)node + node_size;
+            node->block = block;
+        }
+        else
+            node = _list_node_huge_(self);
+        memcpy(node->data, old->data, self->dsize);
+        first = first != NULL ? first : node;
+        node->prev = prev;
+        node->next = NULL;
+        if (prev != NULL)
+            prev->next = node;
+        prev = node;
 
-        printf("\n");
+        List_Node_t *next = old->next;
+        _list_node_destruct_(self, old);
+        old = next;
     }
+    self->head = first;
+    self->tail = prev;
+}
+
+// ------------------------------------ Test --------------------------------------------------
+#ifdef CCTR_STATS
+void list_stats(List_t *self, Cctr_Stats_t *snapshot)
+{
+    assert(self != NULL);
+    cctr_stats_snapshot(&self->stats, snapshot);
+}
+
+void list_compact_auto(List_t *self, double ratio)
+{
+    assert(self != NULL && ratio >= 0 && ratio <= 1);
+    self->compact_ratio = ratio;
 }
+#endif
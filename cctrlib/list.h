@@ -25,16 +25,28 @@ SOFTWARE.
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "stats.h"
+
 #pragma once
 
 /*
  * Strcture
  */
+#ifdef CCTR_PREFETCH
+#ifndef CCTR_PREFETCH_DIST
+#define CCTR_PREFETCH_DIST 8 // nodes ahead, payloads are prefetched this far and nodes twice as far
+#endif
+#ifndef CCTR_PREFETCH_MIN
+#define CCTR_PREFETCH_MIN 4096 // shorter lists are walked without a skip array
+#endif
+#endif
+
 typedef struct List_Node_t
 {
     void *data;
     struct List_Node_t *prev;
     struct List_Node_t *next;
+    struct Cctr_Block_t *block; // NULL unless allocated by a batch
 } List_Node_t;
 
 typedef struct
@@ -43,16 +55,42 @@ typedef struct
     List_Node_t *tail;
     uint32_t size; // !shorter length to do positive and negative pos
     uint32_t dsize;
+    struct Cctr_Huge_t *huge; // node storage of list_init_huge, NULL for malloc
+    struct Cctr_Reclaim_Batch_t *defer; // frees staged for the reclaim queue, NULL unless list_defer_free
+    uint64_t version;      // bumped by every change of the elements
+    uint64_t hash;         // list_hash of the elements at hash_version
+    uint64_t hash_version; // differs from version while hash is stale
+#ifdef CCTR_STATS
+    Cctr_Stats_t stats;
+    double compact_ratio; // share of far list_find steps which triggers list_compact, 0 never
+#endif
+#ifdef CCTR_PREFETCH
+    List_Node_t **skip;    // every node in list order, built by a long traversal, dropped on modification
+    uint64_t skip_version; // version at the last long traversal without the array
+#endif
 } List_t;
 
 /*
  * Construct & Desctruct
+ * list_init_huge keeps the nodes and payloads in huge page regions (huge.h),
+ * for lists of millions of nodes, copies of it do the same
  */
 List_t *list_init(uint32_t dsize);
+List_t *list_init_huge(uint32_t dsize);
 void list_clear(List_t *self);
 void list_destroy(List_t *self);
 List_t *list_copy(List_t *self);
 
+/*
+ * Deferred free
+ * With on != 0 the nodes this list lets go of, by pops, erases, clear and
+ * destroy alike, are queued for cctr_reclaim (reclaim.h) instead of freed
+ * in place, so the cost of free stays off the calling thread. They are
+ * staged in the list and pushed CCTR_RECLAIM_STAGE at a time, by clear and
+ * destroy and when the mode is switched off. Copies keep the mode.
+ */
+void list_defer_free(List_t *self, int on);
+
 /*
  * Basic Usage
  */
@@ -64,7 +102,16 @@ void list_pop_front(List_t *self);
 void list_pop_back(List_t *self);
 void *list_at(List_t *self, int32_t pos);
 
+/*
+ * Batch
+ */
+void list_push_front_n(List_t *self, void *array, uint32_t asize);
+void list_push_back_n(List_t *self, void *array, uint32_t asize);
+uint32_t list_pop_front_n(List_t *self, void *out, uint32_t n);
+uint32_t list_pop_back_n(List_t *self, void *out, uint32_t n);
+
 void _list_border_(List_t *self, int64_t pos, uintptr_t *left, uintptr_t *right);
+void _list_skip_reset_(List_t *self); // after relinking nodes outside list.c
 
 /*
  * Additional
@@ -75,6 +122,21 @@ void list_insert_list(List_t *self, int32_t pos, List_t *object);
 List_t *list_from_array(void *array, uint32_t asize, uint32_t dsize);
 void list_insert_array(List_t *self, int32_t pos, void *array, uint32_t asize);
 
+/*
+ * Bulk erase, one traversal each, returns the number of erased elements
+ */
+uint32_t list_remove_if(List_t *self, int (*predicate)(void *data, void *ctx), void *ctx);
+uint32_t list_remove_value(List_t *self, void *data);
+uint32_t list_unique(List_t *self);
+uint32_t list_erase_range(List_t *self, int32_t from, int32_t to);
+
+/*
+ * Layout
+ * Moves every node with its payload into one block in list order. Data
+ * pointers taken from the list before the call are no longer valid.
+ */
+void list_compact(List_t *self);
+
 /*
  * Searching
  */
@@ -82,6 +144,29 @@ int32_t list_find_data_range(List_t *self, void *data, uint32_t offset, uint32_t
 int32_t list_find(List_t *self, void *data);
 
 /*
- * Print
+ * Comparing
+ * One traversal each. list_compare orders like memcmp over the payloads, a
+ * shorter list first on a common prefix, and returns -1, 0 or 1. list_hash
+ * is cctr_hash (hash.h) of the payloads back to back, the value of an array
+ * with the same bytes, kept until the next change: while version is the same
+ * as at an earlier reading the list is unchanged and list_hash costs O(1).
+ * Payloads written in place through list_at and the like are no change the
+ * list sees, list_touch announces them.
+ */
+int list_equal(List_t *self, List_t *other);
+int list_compare(List_t *self, List_t *other);
+uint64_t list_hash(List_t *self);
+void list_touch(List_t *self);
+
+/*
+ * Print, defined in dump.c, see dump.h for ranges, raw and CSV output
+ */
+void list_print(List_t *self);
+
+/*
+ * Statistics, only with CCTR_STATS
  */
-void list_print(List_t *self);
\ No newline at end of file
+#ifdef CCTR_STATS
+void list_stats(List_t *self, Cctr_Stats_t *snapshot);
+void list_compact_auto(List_t *self, double ratio);
+#endif
\ No newline at end of file
@@ -0,0 +1,307 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * Type specialized list, the element type is known at compile time so the
+ * payload is stored inline in the node and copied / compared directly.
+ *
+ *     #define CCTR_T uint32_t
+ *     #include "cctrlib/list_tmpl.h"
+ *
+ * generates List_uint32_t, List_Node_uint32_t and list_uint32_t_*().
+ * The header can be included once per element type.
+ *
+ * CCTR_NAME    name part of the generated identifiers, required when CCTR_T
+ *              is not a single identifier (e.g. struct types or pointers)
+ * CCTR_EQ(a,b) element equality, defaults to ==, required for struct types
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <assert.h>
+
+#ifndef CCTR_T
+#error "CCTR_T has to be defined before including list_tmpl.h"
+#endif
+
+#ifndef CCTR_NAME
+#define CCTR_NAME CCTR_T
+#endif
+
+#ifndef CCTR_EQ
+#define CCTR_EQ(a, b) ((a) == (b))
+#endif
+
+#define _CCTR_CAT_(a, b) a##b
+#define _CCTR_CAT(a, b) _CCTR_CAT_(a, b)
+#define _CCTR_LIST_ _CCTR_CAT(List_, CCTR_NAME)
+#define _CCTR_NODE_ _CCTR_CAT(List_Node_, CCTR_NAME)
+#define _CCTR_FN_(fn) _CCTR_CAT(_CCTR_CAT(list_, CCTR_NAME), _##fn)
+#define _CCTR_IFN_(fn) _CCTR_CAT(_CCTR_CAT(_list_, CCTR_NAME), _##fn##_)
+
+// ==============================================================
+/*
+ * Strcture
+ */
+typedef struct _CCTR_NODE_
+{
+    struct _CCTR_NODE_ *prev;
+    struct _CCTR_NODE_ *next;
+    CCTR_T data;
+} _CCTR_NODE_;
+
+typedef struct
+{
+    _CCTR_NODE_ *head;
+    _CCTR_NODE_ *tail;
+    uint32_t size;
+} _CCTR_LIST_;
+
+// ==============================================================
+/*
+ * Construct & Desctruct
+ */
+static inline _CCTR_LIST_ *_CCTR_FN_(init)(void)
+{
+    _CCTR_LIST_ *ret = (_CCTR_LIST_ *)calloc(1, sizeof(_CCTR_LIST_));
+    assert(ret != NULL);
+    return ret;
+}
+static inline void _CCTR_FN_(clear)(_CCTR_LIST_ *self)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *ptr = self->head;
+    while (ptr != NULL)
+    {
+        _CCTR_NODE_ *to_del = ptr;
+        ptr = ptr->next;
+        free(to_del);
+    }
+    self->head = NULL;
+    self->tail = NULL;
+    self->size = 0;
+}
+static inline void _CCTR_FN_(destroy)(_CCTR_LIST_ *self)
+{
+    _CCTR_FN_(clear)(self);
+    free(self);
+}
+
+/*
+ * Basic Usage
+ */
+static inline _CCTR_NODE_ *_CCTR_IFN_(node)(CCTR_T data)
+{
+    _CCTR_NODE_ *node = (_CCTR_NODE_ *)malloc(sizeof(_CCTR_NODE_));
+    assert(node != NULL);
+    node->data = data;
+    return node;
+}
+static inline CCTR_T *_CCTR_FN_(front)(_CCTR_LIST_ *self)
+{
+    assert(self != NULL);
+    assert(self->head != NULL);
+    return &self->head->data;
+}
+static inline CCTR_T *_CCTR_FN_(back)(_CCTR_LIST_ *self)
+{
+    assert(self != NULL);
+    assert(self->tail != NULL);
+    return &self->tail->data;
+}
+static inline void _CCTR_FN_(push_front)(_CCTR_LIST_ *self, CCTR_T data)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *node = _CCTR_IFN_(node)(data);
+    node->prev = NULL;
+    node->next = self->head;
+
+    if (self->head != NULL)
+        self->head->prev = node;
+    else
+        self->tail = node;
+    self->head = node;
+    self->size++;
+}
+static inline void _CCTR_FN_(push_back)(_CCTR_LIST_ *self, CCTR_T data)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *node = _CCTR_IFN_(node)(data);
+    node->prev = self->tail;
+    node->next = NULL;
+
+    if (self->tail != NULL)
+        self->tail->next = node;
+    else
+        self->head = node;
+    self->tail = node;
+    self->size++;
+}
+static inline void _CCTR_FN_(pop_front)(_CCTR_LIST_ *self)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *rmv = self->head;
+    if (rmv == NULL)
+        return;
+
+    self->head = rmv->next;
+    if (self->head != NULL)
+        self->head->prev = NULL;
+    else
+        self->tail = NULL;
+
+    free(rmv);
+    self->size--;
+}
+static inline void _CCTR_FN_(pop_back)(_CCTR_LIST_ *self)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *rmv = self->tail;
+    if (rmv == NULL)
+        return;
+
+    self->tail = rmv->prev;
+    if (self->tail != NULL)
+        self->tail->next = NULL;
+    else
+        self->head = NULL;
+
+    free(rmv);
+    self->size--;
+}
+static inline _CCTR_NODE_ *_CCTR_IFN_(node_at)(_CCTR_LIST_ *self, int64_t pos)
+{
+    // same position convention as list_at, walks from the closer end
+    const int64_t size = self->size;
+    if (pos >= size || pos < -size)
+        return NULL;
+    if (pos < 0)
+        pos += size;
+
+    _CCTR_NODE_ *ptr;
+    if (pos <= size / 2)
+        for (ptr = self->head; pos > 0; pos--)
+            ptr = ptr->next;
+    else
+        for (ptr = self->tail, pos = size - 1 - pos; pos > 0; pos--)
+            ptr = ptr->prev;
+    return ptr;
+}
+static inline CCTR_T *_CCTR_FN_(at)(_CCTR_LIST_ *self, int32_t pos)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *node = _CCTR_IFN_(node_at)(self, pos);
+    return node != NULL ? &node->data : NULL;
+}
+
+/*
+ * Additional
+ */
+static inline void _CCTR_FN_(insert)(_CCTR_LIST_ *self, int64_t pos, CCTR_T data)
+{
+    assert(self != NULL);
+    const int64_t size = self->size;
+    if (pos > size || pos < -size)
+        return;
+    if (pos < 0)
+        pos += size; // -1 inserts in front of the last element, as in list_insert
+    if (pos == size)
+    {
+        _CCTR_FN_(push_back)(self, data);
+        return;
+    }
+    if (pos == 0)
+    {
+        _CCTR_FN_(push_front)(self, data);
+        return;
+    }
+
+    _CCTR_NODE_ *right = _CCTR_IFN_(node_at)(self, pos);
+    _CCTR_NODE_ *node = _CCTR_IFN_(node)(data);
+    node->prev = right->prev;
+    node->next = right;
+    right->prev->next = node;
+    right->prev = node;
+    self->size++;
+}
+static inline void _CCTR_FN_(erase)(_CCTR_LIST_ *self, int32_t pos)
+{
+    assert(self != NULL);
+    _CCTR_NODE_ *rmv = _CCTR_IFN_(node_at)(self, pos);
+    if (rmv == NULL)
+        return;
+    if (rmv == self->head)
+    {
+        _CCTR_FN_(pop_front)(self);
+        return;
+    }
+    if (rmv == self->tail)
+    {
+        _CCTR_FN_(pop_back)(self);
+        return;
+    }
+
+    rmv->prev->next = rmv->next;
+    rmv->next->prev = rmv->prev;
+    free(rmv);
+    self->size--;
+}
+static inline _CCTR_LIST_ *_CCTR_FN_(copy)(_CCTR_LIST_ *self)
+{
+    assert(self != NULL);
+    _CCTR_LIST_ *ret = _CCTR_FN_(init)();
+    for (_CCTR_NODE_ *ptr = self->head; ptr != NULL; ptr = ptr->next)
+        _CCTR_FN_(push_back)(ret, ptr->data);
+    return ret;
+}
+static inline _CCTR_LIST_ *_CCTR_FN_(from_array)(const CCTR_T *array, uint32_t asize)
+{
+    _CCTR_LIST_ *ret = _CCTR_FN_(init)();
+    for (uint32_t i = 0; i < asize; i++)
+        _CCTR_FN_(push_back)(ret, array[i]);
+    return ret;
+}
+
+/*
+ * Searching
+ */
+static inline int32_t _CCTR_FN_(find)(_CCTR_LIST_ *self, CCTR_T data)
+{
+    assert(self != NULL);
+    int32_t pos = 0;
+    for (_CCTR_NODE_ *ptr = self->head; ptr != NULL; ptr = ptr->next, pos++)
+        if (CCTR_EQ(ptr->data, data))
+            return pos;
+    return -1;
+}
+
+#undef _CCTR_IFN_
+#undef _CCTR_FN_
+#undef _CCTR_NODE_
+#undef _CCTR_LIST_
+#undef _CCTR_CAT
+#undef _CCTR_CAT_
+#undef CCTR_EQ
+#undef CCTR_NAME
+#undef CCTR_T
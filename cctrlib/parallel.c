@@ -0,0 +1,356 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include "parallel.h"
+
+/*
+ * Segments per thread, more than one so a slow segment does not hold the others
+ */
+#define _PAR_SPLIT_ 4
+
+/*
+ * Partials are a cache line apart, threads would otherwise share the line
+ */
+#define _PAR_LINE_ 64
+
+typedef struct
+{
+    // source, either the segments of a list or a range of an array
+    List_Index_t *index;
+    Array_t *array;
+    uint64_t size;
+    uint32_t count;
+
+    void *ctx;
+    Cctr_Visit_t visit;
+    Cctr_Pred_t pred;
+    Cctr_Reduce_t reduce;
+
+    uint8_t *parts; // reduce, count partials, stride bytes apart
+    uint32_t stride;
+    int64_t best; // find_first, atomic
+} _Par_Job_t_;
+
+typedef int (*_Par_Step_t_)(_Par_Job_t_ *job, uint32_t seg, void *data, uint64_t pos);
+
+/*
+ * Internal
+ */
+static uint32_t _par_segments_(Cctr_Pool_t *pool, uint64_t size)
+{
+    uint64_t ret = (uint64_t)cctr_pool_concurrency(pool) * _PAR_SPLIT_;
+    if (ret > size)
+        ret = size;
+    return (uint32_t)ret;
+}
+
+static inline uint64_t _par_begin_(_Par_Job_t_ *job, uint32_t seg)
+{
+    return job->size * seg / job->count;
+}
+
+/*
+ * Walks the segment until step returns nonzero
+ */
+static inline void _par_walk_(_Par_Job_t_ *job, uint32_t seg, _Par_Step_t_ step)
+{
+    uint64_t pos = _par_begin_(job, seg);
+    uint64_t end = _par_begin_(job, seg + 1);
+
+    if (job->array != NULL)
+    {
+        uint32_t dsize = job->array->dsize;
+        uint8_t *data = (uint8_t *)job->array->data + pos * dsize;
+        for (; pos < end; pos++, data += dsize)
+            if (step(job, seg, data, pos))
+                return;
+        return;
+    }
+
+    List_Node_t *node = job->index->start[seg];
+    for (; pos < end; pos++, node = node->next)
+        if (step(job, seg, node->data, pos))
+            return;
+}
+
+static List_Index_t *_par_index_(List_t *self, List_Index_t *index, Cctr_Pool_t *pool)
+{
+    // the same size says nothing after an erase and an insert, the version is bumped by every change
+    assert(index == NULL || index->list == self);
+    if (index == NULL || index->version != self->version)
+        return list_index_build(self, _par_segments_(pool, self->size));
+    return index;
+}
+
+static void _par_run_(_Par_Job_t_ *job, Cctr_Pool_t *pool, Cctr_Task_t task)
+{
+    if (job->count > 0)
+        cctr_pool_run(pool, job->count, task, job);
+}
+
+static void _par_list_job_(_Par_Job_t_ *job, List_Index_t *index, void *ctx)
+{
+    memset(job, 0, sizeof(_Par_Job_t_));
+    job->index = index;
+    job->size = index->size;
+    job->count = index->count;
+    job->ctx = ctx;
+}
+
+static void _par_array_job_(_Par_Job_t_ *job, Array_t *self, Cctr_Pool_t *pool, void *ctx)
+{
+    memset(job, 0, sizeof(_Par_Job_t_));
+    job->array = self;
+    job->size = self->size;
+    job->count = _par_segments_(pool, self->size);
+    job->ctx = ctx;
+}
+
+/*
+ * Kernels
+ */
+static int _par_visit_step_(_Par_Job_t_ *job, uint32_t seg, void *data, uint64_t pos)
+{
+    job->visit(data, job->ctx);
+    return 0;
+}
+
+static void _par_visit_task_(void *ctx, uint32_t seg)
+{
+    _par_walk_((_Par_Job_t_ *)ctx, seg, _par_visit_step_);
+}
+
+static int _par_reduce_step_(_Par_Job_t_ *job, uint32_t seg, void *data, uint64_t pos)
+{
+    job->reduce(job->parts + (uint64_t)seg * job->stride, data, job->ctx);
+    return 0;
+}
+
+static void _par_reduce_task_(void *ctx, uint32_t seg)
+{
+    _par_walk_((_Par_Job_t_ *)ctx, seg, _par_reduce_step_);
+}
+
+static int _par_count_step_(_Par_Job_t_ *job, uint32_t seg, void *data, uint64_t pos)
+{
+    if (job->pred(data, job->ctx))
+        (*(uint64_t *)(job->parts + (uint64_t)seg * job->stride))++;
+    return 0;
+}
+
+static void _par_count_task_(void *ctx, uint32_t seg)
+{
+    _par_walk_((_Par_Job_t_ *)ctx, seg, _par_count_step_);
+}
+
+static int _par_find_step_(_Par_Job_t_ *job, uint32_t seg, void *data, uint64_t pos)
+{
+    if ((int64_t)pos >= __atomic_load_n(&job->best, __ATOMIC_RELAXED))
+        return 1; // an earlier segment has matched already
+
+    if (!job->pred(data, job->ctx))
+        return 0;
+
+    int64_t best = __atomic_load_n(&job->best, __ATOMIC_RELAXED);
+    while ((int64_t)pos < best &&
+           !__atomic_compare_exchange_n(&job->best, &best, (int64_t)pos, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    return 1;
+}
+
+static void _par_find_task_(void *ctx, uint32_t seg)
+{
+    _par_walk_((_Par_Job_t_ *)ctx, seg, _par_find_step_);
+}
+
+/*
+ * Shared drivers
+ */
+static void _par_for_each_(_Par_Job_t_ *job, Cctr_Pool_t *pool, Cctr_Visit_t fn)
+{
+    assert(fn != NULL);
+    job->visit = fn;
+    _par_run_(job, pool, _par_visit_task_);
+}
+
+static void _par_reduce_(_Par_Job_t_ *job, Cctr_Pool_t *pool, void *result, uint32_t rsize,
+                         Cctr_Reduce_t reduce, Cctr_Combine_t combine)
+{
+    assert(result != NULL && rsize > 0);
+    assert(reduce != NULL && combine != NULL);
+    if (job->count == 0)
+        return;
+
+    job->reduce = reduce;
+    job->stride = (rsize + _PAR_LINE_ - 1) / _PAR_LINE_ * _PAR_LINE_;
+    job->parts = (uint8_t *)aligned_alloc(_PAR_LINE_, (uint64_t)job->count * job->stride);
+    assert(job->parts != NULL);
+    for (uint32_t i = 0; i < job->count; i++)
+        memcpy(job->parts + (uint64_t)i * job->stride, result, rsize);
+
+    _par_run_(job, pool, _par_reduce_task_);
+
+    for (uint32_t i = 0; i < job->count; i++)
+        combine(result, job->parts + (uint64_t)i * job->stride, job->ctx);
+    free(job->parts);
+}
+
+static int64_t _par_find_first_(_Par_Job_t_ *job, Cctr_Pool_t *pool, Cctr_Pred_t pred)
+{
+    assert(pred != NULL);
+    job->pred = pred;
+    job->best = INT64_MAX;
+    _par_run_(job, pool, _par_find_task_);
+    return job->best == INT64_MAX ? -1 : job->best;
+}
+
+static uint64_t _par_count_(_Par_Job_t_ *job, Cctr_Pool_t *pool, Cctr_Pred_t pred)
+{
+    assert(pred != NULL);
+    if (job->count == 0)
+        return 0;
+
+    job->pred = pred;
+    job->stride = _PAR_LINE_;
+    job->parts = (uint8_t *)aligned_alloc(_PAR_LINE_, (uint64_t)job->count * job->stride);
+    assert(job->parts != NULL);
+    memset(job->parts, 0, (uint64_t)job->count * job->stride);
+    _par_run_(job, pool, _par_count_task_);
+
+    uint64_t ret = 0;
+    for (uint32_t i = 0; i < job->count; i++)
+        ret += *(uint64_t *)(job->parts + (uint64_t)i * job->stride);
+    free(job->parts);
+    return ret;
+}
+
+/*
+ * Construct & Desctruct
+ */
+List_Index_t *list_index_build(List_t *self, uint32_t segments)
+{
+    assert(self != NULL);
+    List_Index_t *ret = (List_Index_t *)malloc(sizeof(List_Index_t));
+    assert(ret != NULL);
+
+    ret->list = self;
+    ret->size = self->size;
+    ret->version = self->version;
+    ret->count = segments < self->size ? segments : self->size;
+    if (ret->count == 0 && self->size > 0)
+        ret->count = 1;
+    ret->start = (List_Node_t **)malloc((ret->count > 0 ? ret->count : 1) * sizeof(List_Node_t *));
+    assert(ret->start != NULL);
+
+    List_Node_t *node = self->head;
+    uint64_t pos = 0;
+    for (uint32_t i = 0; i < ret->count; i++)
+    {
+        uint64_t begin = (uint64_t)ret->size * i / ret->count;
+        for (; pos < begin; pos++)
+            node = node->next;
+        ret->start[i] = node;
+    }
+    return ret;
+}
+
+void list_index_destroy(List_Index_t *self)
+{
+    assert(self != NULL);
+    free(self->start);
+    free(self);
+}
+
+/*
+ * Parallel
+ */
+void list_par_for_each(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, Cctr_Visit_t fn, void *ctx)
+{
+    _Par_Job_t_ job;
+    List_Index_t *idx = _par_index_(self, index, pool);
+    _par_list_job_(&job, idx, ctx);
+    _par_for_each_(&job, pool, fn);
+    if (idx != index)
+        list_index_destroy(idx);
+}
+
+void list_par_reduce(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, void *result, uint32_t rsize,
+                     Cctr_Reduce_t reduce, Cctr_Combine_t combine, void *ctx)
+{
+    _Par_Job_t_ job;
+    List_Index_t *idx = _par_index_(self, index, pool);
+    _par_list_job_(&job, idx, ctx);
+    _par_reduce_(&job, pool, result, rsize, reduce, combine);
+    if (idx != index)
+        list_index_destroy(idx);
+}
+
+int64_t list_par_find_first(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx)
+{
+    _Par_Job_t_ job;
+    List_Index_t *idx = _par_index_(self, index, pool);
+    _par_list_job_(&job, idx, ctx);
+    int64_t ret = _par_find_first_(&job, pool, pred);
+    if (idx != index)
+        list_index_destroy(idx);
+    return ret;
+}
+
+uint64_t list_par_count(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx)
+{
+    _Par_Job_t_ job;
+    List_Index_t *idx = _par_index_(self, index, pool);
+    _par_list_job_(&job, idx, ctx);
+    uint64_t ret = _par_count_(&job, pool, pred);
+    if (idx != index)
+        list_index_destroy(idx);
+    return ret;
+}
+
+void array_par_for_each(Array_t *self, Cctr_Pool_t *pool, Cctr_Visit_t fn, void *ctx)
+{
+    _Par_Job_t_ job;
+    _par_array_job_(&job, self, pool, ctx);
+    _par_for_each_(&job, pool, fn);
+}
+
+void array_par_reduce(Array_t *self, Cctr_Pool_t *pool, void *result, uint32_t rsize,
+                      Cctr_Reduce_t reduce, Cctr_Combine_t combine, void *ctx)
+{
+    _Par_Job_t_ job;
+    _par_array_job_(&job, self, pool, ctx);
+    _par_reduce_(&job, pool, result, rsize, reduce, combine);
+}
+
+int64_t array_par_find_first(Array_t *self, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx)
+{
+    _Par_Job_t_ job;
+    _par_array_job_(&job, self, pool, ctx);
+    return _par_find_first_(&job, pool, pred);
+}
+
+uint64_t array_par_count(Array_t *self, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx)
+{
+    _Par_Job_t_ job;
+    _par_array_job_(&job, self, pool, ctx);
+    return _par_count_(&job, pool, pred);
+}
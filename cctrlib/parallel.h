@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include "list.h"
+#include "array.h"
+#include "pool.h"
+
+#pragma once
+
+/*
+ * Strcture
+ * Segment index of a List_t, start[i] is the first node of segment i which
+ * covers the positions [i * size / count, (i + 1) * size / count). It is built
+ * in one walk and can be reused by any number of parallel calls until the
+ * list is modified. A call given an index older than the list walks a
+ * temporary one instead.
+ */
+typedef struct
+{
+    List_t *list;
+    List_Node_t **start;
+    uint32_t count;
+    uint32_t size;    // list size when built
+    uint64_t version; // list version when built, see list_hash
+} List_Index_t;
+
+typedef void (*Cctr_Visit_t)(void *data, void *ctx);
+typedef int (*Cctr_Pred_t)(void *data, void *ctx);
+typedef void (*Cctr_Reduce_t)(void *acc, void *data, void *ctx);
+typedef void (*Cctr_Combine_t)(void *acc, void *part, void *ctx);
+
+/*
+ * Construct & Desctruct
+ */
+List_Index_t *list_index_build(List_t *self, uint32_t segments);
+void list_index_destroy(List_Index_t *self);
+
+/*
+ * Parallel
+ * pool may be NULL to run on the caller, index may be NULL to build a
+ * temporary one. The callbacks run concurrently on distinct elements, for_each
+ * may modify the element in place. reduce starts every segment from a copy of
+ * *result (the identity, rsize bytes), folds the elements into it and then
+ * combines the partials into *result in list order. find_first returns the
+ * smallest matching position or -1, segments behind a match stop early.
+ */
+void list_par_for_each(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, Cctr_Visit_t fn, void *ctx);
+void list_par_reduce(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, void *result, uint32_t rsize,
+                     Cctr_Reduce_t reduce, Cctr_Combine_t combine, void *ctx);
+int64_t list_par_find_first(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx);
+uint64_t list_par_count(List_t *self, List_Index_t *index, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx);
+
+void array_par_for_each(Array_t *self, Cctr_Pool_t *pool, Cctr_Visit_t fn, void *ctx);
+void array_par_reduce(Array_t *self, Cctr_Pool_t *pool, void *result, uint32_t rsize,
+                      Cctr_Reduce_t reduce, Cctr_Combine_t combine, void *ctx);
+int64_t array_par_find_first(Array_t *self, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx);
+uint64_t array_par_count(Array_t *self, Cctr_Pool_t *pool, Cctr_Pred_t pred, void *ctx);
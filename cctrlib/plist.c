@@ -0,0 +1,369 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include <stddef.h>
+#include "plist.h"
+
+/*
+ * Nodes
+ */
+static inline uint64_t _plist_leaf_bytes_(Plist_t *self)
+{
+    uint64_t ret = offsetof(Plist_Node_t, data) + (uint64_t)self->leaf_cap * self->dsize;
+    return ret > sizeof(Plist_Node_t) ? ret : sizeof(Plist_Node_t);
+}
+
+static Plist_Node_t *_plist_node_(Plist_t *self, int leaf)
+{
+    Plist_Node_t *ret = (Plist_Node_t *)malloc(leaf ? _plist_leaf_bytes_(self) : sizeof(Plist_Node_t));
+    assert(ret != NULL);
+    ret->refs = 1;
+    ret->count = 0;
+    ret->leaf = (uint16_t)leaf;
+    ret->size = 0;
+    return ret;
+}
+
+static inline void _plist_retain_(Plist_Node_t *node)
+{
+    __atomic_fetch_add(&node->refs, 1, __ATOMIC_RELAXED);
+}
+
+static void _plist_release_(Plist_Node_t *node)
+{
+    if (__atomic_fetch_sub(&node->refs, 1, __ATOMIC_ACQ_REL) != 1)
+        return;
+    if (!node->leaf)
+        for (uint32_t i = 0; i < node->count; i++)
+            _plist_release_(node->child[i]);
+    free(node);
+}
+
+/*
+ * Returns a node the caller may change, the node itself when nobody else
+ * holds it. Owning the nodes top down is enough, once a parent is copied its
+ * children are shared and get copied on the way down too.
+ */
+static Plist_Node_t *_plist_own_(Plist_t *self, Plist_Node_t *node)
+{
+    if (__atomic_load_n(&node->refs, __ATOMIC_ACQUIRE) == 1)
+        return node;
+
+    // refs is left out of the copy, other holders may be releasing the node meanwhile
+    Plist_Node_t *ret = _plist_node_(self, node->leaf);
+    ret->count = node->count;
+    ret->size = node->size;
+    if (ret->leaf)
+        memcpy(ret->data, node->data, (uint64_t)node->count * self->dsize);
+    else
+    {
+        memcpy(ret->child, node->child, node->count * sizeof(Plist_Node_t *));
+        for (uint32_t i = 0; i < ret->count; i++)
+            _plist_retain_(ret->child[i]);
+    }
+    _plist_release_(node);
+    return ret;
+}
+
+static inline uint32_t _plist_child_(Plist_Node_t *node, uint64_t *pos)
+{
+    // child holding pos, pos becomes relative to it, the end falls into the last child
+    uint32_t i = 0;
+    while (i + 1 < node->count && *pos >= node->child[i]->size)
+        *pos -= node->child[i++]->size;
+    return i;
+}
+
+static void _plist_resize_(Plist_Node_t *node)
+{
+    node->size = 0;
+    for (uint32_t i = 0; i < node->count; i++)
+        node->size += node->child[i]->size;
+}
+
+/*
+ * Insert & Erase, on owned nodes
+ */
+static void _plist_leaf_put_(Plist_t *self, Plist_Node_t *leaf, uint64_t pos, void *data)
+{
+    uint32_t ds = self->dsize;
+    memmove(leaf->data + (pos + 1) * ds, leaf->data + pos * ds, (leaf->count - pos) * ds);
+    memcpy(leaf->data + pos * ds, data, ds);
+    leaf->count++;
+    leaf->size = leaf->count;
+}
+
+static void _plist_inner_put_(Plist_Node_t *node, uint32_t idx, Plist_Node_t *child)
+{
+    memmove(node->child + idx + 1, node->child + idx, (node->count - idx) * sizeof(Plist_Node_t *));
+    node->child[idx] = child;
+    node->count++;
+}
+
+/*
+ * Returns the new right sibling when node had to split. A node split by an
+ * append keeps all its entries, so pushing back fills nodes completely.
+ */
+static Plist_Node_t *_plist_insert_(Plist_t *self, Plist_Node_t *node, uint64_t pos, void *data)
+{
+    if (node->leaf)
+    {
+        if (node->count < self->leaf_cap)
+        {
+            _plist_leaf_put_(self, node, pos, data);
+            return NULL;
+        }
+
+        uint32_t keep = pos == self->leaf_cap ? self->leaf_cap : self->leaf_cap / 2;
+        Plist_Node_t *right = _plist_node_(self, 1);
+        right->count = (uint16_t)(self->leaf_cap - keep);
+        right->size = right->count;
+        memcpy(right->data, node->data + (uint64_t)keep * self->dsize, (uint64_t)right->count * self->dsize);
+        node->count = (uint16_t)keep;
+        node->size = keep;
+
+        if (pos > keep || keep == self->leaf_cap)
+            _plist_leaf_put_(self, right, pos - keep, data);
+        else
+            _plist_leaf_put_(self, node, pos, data);
+        return right;
+    }
+
+    uint32_t i = _plist_child_(node, &pos);
+    Plist_Node_t *child = node->child[i] = _plist_own_(self, node->child[i]);
+    Plist_Node_t *split = _plist_insert_(self, child, pos, data);
+    node->size++;
+    if (split == NULL)
+        return NULL;
+
+    if (node->count < CCTR_PLIST_FANOUT)
+    {
+        _plist_inner_put_(node, i + 1, split);
+        return NULL;
+    }
+
+    uint32_t keep = i + 1 == CCTR_PLIST_FANOUT ? CCTR_PLIST_FANOUT : CCTR_PLIST_FANOUT / 2;
+    Plist_Node_t *right = _plist_node_(self, 0);
+    right->count = (uint16_t)(CCTR_PLIST_FANOUT - keep);
+    memcpy(right->child, node->child + keep, right->count * sizeof(Plist_Node_t *));
+    node->count = (uint16_t)keep;
+
+    if (i + 1 > keep || keep == CCTR_PLIST_FANOUT)
+        _plist_inner_put_(right, i + 1 - keep, split);
+    else
+        _plist_inner_put_(node, i + 1, split);
+    _plist_resize_(node);
+    _plist_resize_(right);
+    return right;
+}
+
+/*
+ * Emptied nodes are dropped, underfull ones are not merged
+ */
+static void _plist_erase_(Plist_t *self, Plist_Node_t *node, uint64_t pos)
+{
+    node->size--;
+    if (node->leaf)
+    {
+        uint32_t ds = self->dsize;
+        memmove(node->data + pos * ds, node->data + (pos + 1) * ds, (node->count - pos - 1) * ds);
+        node->count--;
+        return;
+    }
+
+    uint32_t i = _plist_child_(node, &pos);
+    Plist_Node_t *child = node->child[i] = _plist_own_(self, node->child[i]);
+    _plist_erase_(self, child, pos);
+    if (child->count == 0)
+    {
+        _plist_release_(child);
+        memmove(node->child + i, node->child + i + 1, (node->count - i - 1) * sizeof(Plist_Node_t *));
+        node->count--;
+    }
+}
+
+static void _plist_for_each_(Plist_t *self, Plist_Node_t *node, void (*fn)(const void *data, void *ctx), void *ctx)
+{
+    if (node->leaf)
+    {
+        for (uint32_t i = 0; i < node->count; i++)
+            fn(node->data + (uint64_t)i * self->dsize, ctx);
+        return;
+    }
+    for (uint32_t i = 0; i < node->count; i++)
+        _plist_for_each_(self, node->child[i], fn, ctx);
+}
+
+/*
+ * Construct & Desctruct
+ */
+Plist_t *plist_construct(uint32_t dsize)
+{
+    assert(dsize > 0);
+    Plist_t *ret = (Plist_t *)malloc(sizeof(Plist_t));
+    assert(ret != NULL);
+    ret->root = NULL;
+    ret->size = 0;
+    ret->dsize = dsize;
+    ret->leaf_cap = CCTR_PLIST_LEAF_BYTES / dsize;
+    if (ret->leaf_cap < 4)
+        ret->leaf_cap = 4;
+    return ret;
+}
+
+void plist_destroy(Plist_t *self)
+{
+    assert(self != NULL);
+    if (self->root != NULL)
+        _plist_release_(self->root);
+    free(self);
+}
+
+Plist_t *plist_snapshot(Plist_t *self)
+{
+    assert(self != NULL);
+    Plist_t *ret = (Plist_t *)malloc(sizeof(Plist_t));
+    assert(ret != NULL);
+    *ret = *self;
+    if (ret->root != NULL)
+        _plist_retain_(ret->root);
+    return ret;
+}
+
+Plist_t *plist_from_list(List_t *list)
+{
+    assert(list != NULL);
+    Plist_t *ret = plist_construct(list->dsize);
+    for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next)
+        plist_push_back(ret, ptr->data);
+    return ret;
+}
+
+static void _plist_to_list_(const void *data, void *ctx)
+{
+    list_push_back((List_t *)ctx, (void *)data);
+}
+
+List_t *plist_to_list(Plist_t *self)
+{
+    List_t *ret = list_init(self->dsize);
+    plist_for_each(self, _plist_to_list_, ret);
+    return ret;
+}
+
+/*
+ * Usage
+ */
+const void *plist_at(Plist_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    if (pos >= self->size)
+        return NULL;
+
+    Plist_Node_t *node = self->root;
+    while (!node->leaf)
+        node = node->child[_plist_child_(node, &pos)];
+    return node->data + pos * self->dsize;
+}
+
+void plist_set(Plist_t *self, uint64_t pos, void *data)
+{
+    assert(self != NULL && pos < self->size);
+    Plist_Node_t *node = self->root = _plist_own_(self, self->root);
+    while (!node->leaf)
+    {
+        uint32_t i = _plist_child_(node, &pos);
+        node = node->child[i] = _plist_own_(self, node->child[i]);
+    }
+    memcpy(node->data + pos * self->dsize, data, self->dsize);
+}
+
+void plist_insert(Plist_t *self, uint64_t pos, void *data)
+{
+    assert(self != NULL && pos <= self->size);
+    if (self->root == NULL)
+        self->root = _plist_node_(self, 1);
+
+    self->root = _plist_own_(self, self->root);
+    Plist_Node_t *split = _plist_insert_(self, self->root, pos, data);
+    if (split != NULL)
+    {
+        Plist_Node_t *root = _plist_node_(self, 0);
+        root->child[0] = self->root;
+        root->child[1] = split;
+        root->count = 2;
+        _plist_resize_(root);
+        self->root = root;
+    }
+    self->size++;
+}
+
+void plist_erase(Plist_t *self, uint64_t pos)
+{
+    assert(self != NULL && pos < self->size);
+    self->root = _plist_own_(self, self->root);
+    _plist_erase_(self, self->root, pos);
+    self->size--;
+
+    // a root with one child is replaced by the child, which may be shared
+    while (!self->root->leaf && self->root->count == 1)
+    {
+        Plist_Node_t *root = self->root;
+        self->root = root->child[0];
+        _plist_retain_(self->root);
+        _plist_release_(root);
+    }
+    if (self->root->count == 0)
+    {
+        _plist_release_(self->root);
+        self->root = NULL;
+    }
+}
+
+void plist_push_front(Plist_t *self, void *data)
+{
+    plist_insert(self, 0, data);
+}
+
+void plist_push_back(Plist_t *self, void *data)
+{
+    plist_insert(self, self->size, data);
+}
+
+void plist_pop_front(Plist_t *self)
+{
+    if (self->size > 0)
+        plist_erase(self, 0);
+}
+
+void plist_pop_back(Plist_t *self)
+{
+    if (self->size > 0)
+        plist_erase(self, self->size - 1);
+}
+
+void plist_for_each(Plist_t *self, void (*fn)(const void *data, void *ctx), void *ctx)
+{
+    assert(self != NULL && fn != NULL);
+    if (self->root != NULL)
+        _plist_for_each_(self, self->root, fn, ctx);
+}
@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "list.h"
+
+#pragma once
+
+/*
+ * Strcture
+ * Persistent sequence, a B-tree of reference counted nodes whose leaves hold
+ * the payloads inline. plist_snapshot only takes a reference on the root, a
+ * later change copies the nodes on the path it touches and shares the rest.
+ * A node referenced once is changed in place.
+ *
+ * A Plist_t handle belongs to one thread at a time, its snapshots can be read
+ * and released by other threads without locking, the counts are atomic.
+ */
+#define CCTR_PLIST_FANOUT 32    // children per inner node
+#define CCTR_PLIST_LEAF_BYTES 512 // payload bytes per leaf, at least 4 elements
+
+typedef struct Plist_Node_t
+{
+    uint32_t refs; // atomic
+    uint16_t count; // elements of a leaf, children of an inner node
+    uint16_t leaf;
+    uint64_t size; // elements below
+    union
+    {
+        struct Plist_Node_t *child[CCTR_PLIST_FANOUT];
+        uint8_t data[1]; // leaf_cap elements
+    };
+} Plist_Node_t;
+
+typedef struct
+{
+    Plist_Node_t *root; // NULL when empty
+    uint64_t size;
+    uint32_t dsize;
+    uint32_t leaf_cap;
+} Plist_t;
+
+/*
+ * Construct & Desctruct
+ */
+Plist_t *plist_construct(uint32_t dsize);
+void plist_destroy(Plist_t *self);
+Plist_t *plist_snapshot(Plist_t *self);
+Plist_t *plist_from_list(List_t *list);
+List_t *plist_to_list(Plist_t *self);
+
+/*
+ * Usage
+ * plist_at points into a node which may be shared, change elements through plist_set
+ */
+const void *plist_at(Plist_t *self, uint64_t pos);
+void plist_set(Plist_t *self, uint64_t pos, void *data);
+void plist_insert(Plist_t *self, uint64_t pos, void *data);
+void plist_erase(Plist_t *self, uint64_t pos);
+void plist_push_front(Plist_t *self, void *data);
+void plist_push_back(Plist_t *self, void *data);
+void plist_pop_front(Plist_t *self);
+void plist_pop_back(Plist_t *self);
+void plist_for_each(Plist_t *self, void (*fn)(const void *data, void *ctx), void *ctx);
@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "pool.h"
+
+static void _cctr_pool_claim_(Cctr_Pool_t *self, Cctr_Task_t fn, void *ctx, uint32_t ntasks)
+{
+    for (;;)
+    {
+        uint32_t task = __atomic_fetch_add(&self->next, 1, __ATOMIC_RELAXED);
+        if (task >= ntasks)
+            return;
+        fn(ctx, task);
+    }
+}
+
+static void *_cctr_pool_worker_(void *arg)
+{
+    Cctr_Pool_t *self = (Cctr_Pool_t *)arg;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&self->lock);
+    for (;;)
+    {
+        while (self->generation == seen && !self->stop)
+            pthread_cond_wait(&self->wake, &self->lock);
+        if (self->stop)
+            break;
+        seen = self->generation;
+        Cctr_Task_t fn = self->fn;
+        void *ctx = self->ctx;
+        uint32_t ntasks = self->ntasks;
+        pthread_mutex_unlock(&self->lock);
+
+        _cctr_pool_claim_(self, fn, ctx, ntasks);
+
+        pthread_mutex_lock(&self->lock);
+        if (++self->checked_out == self->nthreads)
+            pthread_cond_signal(&self->done);
+    }
+    pthread_mutex_unlock(&self->lock);
+    return NULL;
+}
+
+Cctr_Pool_t *cctr_pool_construct(uint32_t nthreads)
+{
+    Cctr_Pool_t *ret = (Cctr_Pool_t *)calloc(1, sizeof(Cctr_Pool_t));
+    assert(ret != NULL);
+    pthread_mutex_init(&ret->lock, NULL);
+    pthread_cond_init(&ret->wake, NULL);
+    pthread_cond_init(&ret->done, NULL);
+
+    ret->threads = (pthread_t *)calloc(nthreads > 0 ? nthreads : 1, sizeof(pthread_t));
+    assert(ret->threads != NULL);
+    for (uint32_t i = 0; i < nthreads; i++)
+    {
+        int err = pthread_create(&ret->threads[i], NULL, _cctr_pool_worker_, ret);
+        assert(err == 0);
+        (void)err;
+        ret->nthreads++;
+    }
+    return ret;
+}
+
+void cctr_pool_destroy(Cctr_Pool_t *self)
+{
+    assert(self != NULL);
+    pthread_mutex_lock(&self->lock);
+    self->stop = 1;
+    pthread_cond_broadcast(&self->wake);
+    pthread_mutex_unlock(&self->lock);
+
+    for (uint32_t i = 0; i < self->nthreads; i++)
+        pthread_join(self->threads[i], NULL);
+
+    pthread_cond_destroy(&self->done);
+    pthread_cond_destroy(&self->wake);
+    pthread_mutex_destroy(&self->lock);
+    free(self->threads);
+    free(self);
+}
+
+void cctr_pool_run(Cctr_Pool_t *self, uint32_t ntasks, Cctr_Task_t fn, void *ctx)
+{
+    assert(fn != NULL);
+    if (ntasks == 0)
+        return;
+    if (self == NULL || self->nthreads == 0 || ntasks == 1)
+    {
+        for (uint32_t task = 0; task < ntasks; task++)
+            fn(ctx, task);
+        return;
+    }
+
+    pthread_mutex_lock(&self->lock);
+    self->fn = fn;
+    self->ctx = ctx;
+    self->ntasks = ntasks;
+    self->next = 0;
+    self->checked_out = 0;
+    self->generation++;
+    pthread_cond_broadcast(&self->wake);
+    pthread_mutex_unlock(&self->lock);
+
+    _cctr_pool_claim_(self, fn, ctx, ntasks);
+
+    // every worker has to leave the job before the next one may reset next
+    pthread_mutex_lock(&self->lock);
+    while (self->checked_out < self->nthreads)
+        pthread_cond_wait(&self->done, &self->lock);
+    pthread_mutex_unlock(&self->lock);
+}
+
+uint32_t cctr_pool_concurrency(Cctr_Pool_t *self)
+{
+    return self != NULL ? self->nthreads + 1 : 1;
+}
+
+uint32_t cctr_cpu_count(void)
+{
+    long ret = sysconf(_SC_NPROCESSORS_ONLN);
+    return ret > 0 ? (uint32_t)ret : 1;
+}
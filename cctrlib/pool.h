@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <pthread.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Fixed-size fork-join thread pool. cctr_pool_run splits a job into ntasks
+ * tasks, the workers and the calling thread claim tasks until all are done
+ * and the call returns after every worker has left the job. A job must not
+ * call cctr_pool_run on the same pool.
+ */
+typedef void (*Cctr_Task_t)(void *ctx, uint32_t task);
+
+typedef struct
+{
+    pthread_t *threads;
+    uint32_t nthreads;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake; // workers wait for a new generation
+    pthread_cond_t done; // caller waits for the workers to check out
+    uint64_t generation;
+    uint32_t checked_out;
+    int stop;
+
+    // current job
+    Cctr_Task_t fn;
+    void *ctx;
+    uint32_t ntasks;
+    uint32_t next; // next task to claim, atomic
+} Cctr_Pool_t;
+
+/*
+ * Construct & Desctruct
+ * nthreads is the number of workers besides the caller, 0 runs everything on the caller
+ */
+Cctr_Pool_t *cctr_pool_construct(uint32_t nthreads);
+void cctr_pool_destroy(Cctr_Pool_t *self);
+
+/*
+ * Usage
+ */
+void cctr_pool_run(Cctr_Pool_t *self, uint32_t ntasks, Cctr_Task_t fn, void *ctx);
+uint32_t cctr_pool_concurrency(Cctr_Pool_t *self);
+uint32_t cctr_cpu_count(void);
@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "reclaim.h"
+
+/*
+ * Queue
+ * Producers swap their batch in as the new top of a stack of batches, the
+ * items stay linked through next, so the stack is one chain. Reclaimers take
+ * the whole chain under _reclaim_lock_ and release from their private part
+ * until the budget is spent, what is left waits for the next call.
+ */
+static Cctr_Reclaim_Item_t *_reclaim_top_; // atomic
+static Cctr_Reclaim_Item_t *_reclaim_taken_; // under _reclaim_lock_
+static pthread_mutex_t _reclaim_lock_ = PTHREAD_MUTEX_INITIALIZER;
+static Cctr_Reclaim_Stats_t _reclaim_stats_; // atomic fields
+
+static pthread_t _reclaim_thread_; // under _reclaim_thread_lock_
+static int _reclaim_running_; // atomic, written under _reclaim_thread_lock_
+static pthread_mutex_t _reclaim_thread_lock_ = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t _reclaim_budget_;
+static uint32_t _reclaim_interval_;
+
+void cctr_reclaim_push(Cctr_Reclaim_Batch_t *batch)
+{
+    assert(batch != NULL);
+    if (batch->count == 0)
+        return;
+
+    // counted before it can be taken, the depth never drops below zero
+    uint64_t depth = __atomic_add_fetch(&_reclaim_stats_.depth, batch->count, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&_reclaim_stats_.deferred, batch->count, __ATOMIC_RELAXED);
+    uint64_t peak = __atomic_load_n(&_reclaim_stats_.peak, __ATOMIC_RELAXED);
+    while (depth > peak &&
+           !__atomic_compare_exchange_n(&_reclaim_stats_.peak, &peak, depth, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+
+    // only whole chains are taken off, so a push has no ABA problem
+    Cctr_Reclaim_Item_t *top = __atomic_load_n(&_reclaim_top_, __ATOMIC_RELAXED);
+    do
+        batch->tail->next = top;
+    while (!__atomic_compare_exchange_n(&_reclaim_top_, &top, batch->head, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    batch->head = NULL;
+    batch->tail = NULL;
+    batch->count = 0;
+}
+
+uint64_t cctr_reclaim(uint64_t budget)
+{
+    uint64_t ret = 0;
+    pthread_mutex_lock(&_reclaim_lock_);
+    while (ret < budget)
+    {
+        if (_reclaim_taken_ == NULL)
+        {
+            _reclaim_taken_ = __atomic_exchange_n(&_reclaim_top_, NULL, __ATOMIC_ACQUIRE);
+            if (_reclaim_taken_ == NULL)
+                break;
+        }
+        Cctr_Reclaim_Item_t *item = _reclaim_taken_;
+        _reclaim_taken_ = item->next;
+        if (item->data != NULL)
+            free(item->data);
+        if (item->map_size != 0)
+            munmap(item, item->map_size);
+        else
+            free(item);
+        ret++;
+    }
+    pthread_mutex_unlock(&_reclaim_lock_);
+    __atomic_sub_fetch(&_reclaim_stats_.depth, ret, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&_reclaim_stats_.reclaimed, ret, __ATOMIC_RELAXED);
+    return ret;
+}
+
+// ------------------------------------------------------------------
+static void *_reclaim_task_(void *arg)
+{
+    (void)arg;
+    while (__atomic_load_n(&_reclaim_running_, __ATOMIC_ACQUIRE))
+        if (cctr_reclaim(_reclaim_budget_) < _reclaim_budget_)
+        {
+            struct timespec ts = {_reclaim_interval_ / 1000000, (long)(_reclaim_interval_ % 1000000) * 1000};
+            nanosleep(&ts, NULL);
+        }
+    return NULL;
+}
+
+int cctr_reclaim_start(uint64_t budget, uint32_t interval_us)
+{
+    assert(budget > 0);
+    // start and stop hold the lock over the flag and the thread handle, a stop
+    // joins exactly the thread the start before it created
+    pthread_mutex_lock(&_reclaim_thread_lock_);
+    if (__atomic_load_n(&_reclaim_running_, __ATOMIC_ACQUIRE))
+    {
+        pthread_mutex_unlock(&_reclaim_thread_lock_);
+        errno = EBUSY;
+        return -1;
+    }
+    _reclaim_budget_ = budget;
+    _reclaim_interval_ = interval_us;
+    __atomic_store_n(&_reclaim_running_, 1, __ATOMIC_RELEASE);
+    int err = pthread_create(&_reclaim_thread_, NULL, _reclaim_task_, NULL);
+    if (err != 0)
+        __atomic_store_n(&_reclaim_running_, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_reclaim_thread_lock_);
+    if (err != 0)
+    {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+void cctr_reclaim_stop(void)
+{
+    pthread_mutex_lock(&_reclaim_thread_lock_);
+    if (__atomic_exchange_n(&_reclaim_running_, 0, __ATOMIC_ACQ_REL))
+        pthread_join(_reclaim_thread_, NULL);
+    pthread_mutex_unlock(&_reclaim_thread_lock_);
+    cctr_reclaim(UINT64_MAX);
+}
+
+// ------------------------------------------------------------------
+void cctr_reclaim_stats(Cctr_Reclaim_Stats_t *snapshot)
+{
+    assert(snapshot != NULL);
+    snapshot->depth = __atomic_load_n(&_reclaim_stats_.depth, __ATOMIC_RELAXED);
+    snapshot->peak = __atomic_load_n(&_reclaim_stats_.peak, __ATOMIC_RELAXED);
+    snapshot->deferred = __atomic_load_n(&_reclaim_stats_.deferred, __ATOMIC_RELAXED);
+    snapshot->reclaimed = __atomic_load_n(&_reclaim_stats_.reclaimed, __ATOMIC_RELAXED);
+}
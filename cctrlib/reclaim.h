@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#pragma once
+
+/*
+ * Deferred free
+ * Memory released on a latency critical thread can be queued instead of
+ * freed in place and given back later, by cctr_reclaim(budget) calls of
+ * bounded cost or by a reclaimer thread. Lists opt in with list_defer_free.
+ *
+ * The queue item is written into the dead allocation itself, which has to
+ * hold a Cctr_Reclaim_Item_t (24 bytes, every node does), so queueing never
+ * allocates. A Cctr_Reclaim_Batch_t collects items on one thread and goes to
+ * the queue with a single atomic exchange, many threads may push at once.
+ * Only memory nobody uses any more is queued: a node of a batch block only
+ * drops its reference, the block is queued with its last node.
+ */
+typedef struct Cctr_Reclaim_Item_t
+{
+    struct Cctr_Reclaim_Item_t *next;
+    void *data;        // freed along with the item, NULL when none
+    uint64_t map_size; // the item starts a mapping of this length, 0 for malloc
+} Cctr_Reclaim_Item_t;
+
+#define CCTR_RECLAIM_STAGE 64 // items a deferred list gathers before it pushes them
+
+typedef struct Cctr_Reclaim_Batch_t
+{
+    Cctr_Reclaim_Item_t *head;
+    Cctr_Reclaim_Item_t *tail;
+    uint64_t count;
+} Cctr_Reclaim_Batch_t;
+
+typedef struct
+{
+    uint64_t depth;     // items queued and not released yet
+    uint64_t peak;      // largest depth seen
+    uint64_t deferred;  // items queued in total
+    uint64_t reclaimed; // items released in total
+} Cctr_Reclaim_Stats_t;
+
+static inline void cctr_reclaim_add(Cctr_Reclaim_Batch_t *batch, void *ptr, void *data, uint64_t map_size)
+{
+    // ptr is freed, or unmapped when map_size != 0, data is freed too
+    Cctr_Reclaim_Item_t *item = (Cctr_Reclaim_Item_t *)ptr;
+    item->next = NULL;
+    item->data = data;
+    item->map_size = map_size;
+    if (batch->tail != NULL)
+        batch->tail->next = item;
+    else
+        batch->head = item;
+    batch->tail = item;
+    batch->count++;
+}
+
+/*
+ * Queue
+ * cctr_reclaim_push hands the batch over and empties it. cctr_reclaim
+ * releases up to budget items, oldest batches not necessarily first, and
+ * returns how many. cctr_reclaim_start runs a thread which reclaims budget
+ * items at a time and sleeps interval_us whenever the queue ran dry,
+ * cctr_reclaim_stop ends it and releases what is left. Start and stop may
+ * race from any threads, a stop joins the thread of the start it follows.
+ */
+void cctr_reclaim_push(Cctr_Reclaim_Batch_t *batch);
+uint64_t cctr_reclaim(uint64_t budget);
+int cctr_reclaim_start(uint64_t budget, uint32_t interval_us);
+void cctr_reclaim_stop(void);
+
+/*
+ * Statistics
+ */
+void cctr_reclaim_stats(Cctr_Reclaim_Stats_t *snapshot);
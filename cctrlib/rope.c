@@ -0,0 +1,359 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include "rope.h"
+
+/*
+ * Nodes
+ */
+static Rope_Node_t *_rope_node_(Rope_t *self, int leaf)
+{
+    uint64_t bytes = offsetof(Rope_Node_t, data) + (uint64_t)self->leaf_cap * self->dsize;
+    if (!leaf || bytes < sizeof(Rope_Node_t))
+        bytes = sizeof(Rope_Node_t);
+    Rope_Node_t *ret = (Rope_Node_t *)malloc(bytes);
+    assert(ret != NULL);
+    ret->size = 0;
+    ret->count = 0;
+    ret->leaf = (uint32_t)leaf;
+    return ret;
+}
+
+static void _rope_node_destroy_(Rope_Node_t *node)
+{
+    if (!node->leaf)
+        for (uint32_t i = 0; i < node->count; i++)
+            _rope_node_destroy_(node->child[i]);
+    free(node);
+}
+
+static inline uint32_t _rope_child_(Rope_Node_t *node, uint64_t *pos)
+{
+    // child holding pos, pos becomes relative to it, the end falls into the last child
+    uint32_t i = 0;
+    while (i + 1 < node->count && *pos >= node->child[i]->size)
+        *pos -= node->child[i++]->size;
+    return i;
+}
+
+static void _rope_inner_put_(Rope_Node_t *node, uint32_t idx, Rope_Node_t *child)
+{
+    memmove(node->child + idx + 1, node->child + idx, (node->count - idx) * sizeof(Rope_Node_t *));
+    node->child[idx] = child;
+    node->count++;
+}
+
+static void _rope_resize_(Rope_Node_t *node)
+{
+    node->size = 0;
+    for (uint32_t i = 0; i < node->count; i++)
+        node->size += node->child[i]->size;
+}
+
+/*
+ * Insert
+ * a run of m <= leaf_cap elements, so a leaf splits into two at most and
+ * every level above adds one child at most. Returns the new right sibling
+ * when node split. A leaf appended to is filled up before the rest of the
+ * run goes to the new one, so runs pushed at the end pack the leaves.
+ */
+static Rope_Node_t *_rope_insert_(Rope_t *self, Rope_Node_t *node, uint64_t pos, const uint8_t *run, uint32_t m)
+{
+    const uint32_t ds = self->dsize;
+    if (node->leaf)
+    {
+        uint32_t count = node->count;
+        if (count + m <= self->leaf_cap)
+        {
+            memmove(node->data + (pos + m) * ds, node->data + pos * ds, (count - pos) * ds);
+            memcpy(node->data + pos * ds, run, (uint64_t)m * ds);
+            node->count += m;
+            node->size = node->count;
+            return NULL;
+        }
+
+        // the leaf with the run in it is cut at keep, the right part goes to a new leaf
+        const uint32_t total = count + m;
+        const uint32_t keep = pos == count ? self->leaf_cap : total / 2;
+        Rope_Node_t *right = _rope_node_(self, 1);
+        uint8_t *dst = right->data;
+        for (uint32_t idx = keep; idx < total;)
+        {
+            // one piece at a time out of the front, the run or the back
+            const uint8_t *src;
+            uint32_t len;
+            if (idx < pos)
+            {
+                src = node->data + (uint64_t)idx * ds;
+                len = (uint32_t)pos - idx;
+            }
+            else if (idx < pos + m)
+            {
+                src = run + (idx - pos) * ds;
+                len = (uint32_t)pos + m - idx;
+            }
+            else
+            {
+                src = node->data + (uint64_t)(idx - m) * ds;
+                len = total - idx;
+            }
+            memcpy(dst, src, (uint64_t)len * ds);
+            dst += (uint64_t)len * ds;
+            idx += len;
+        }
+        right->count = total - keep;
+        right->size = right->count;
+
+        if (keep > pos)
+        {
+            uint32_t in_run = keep - (uint32_t)pos < m ? keep - (uint32_t)pos : m;
+            if (keep > pos + m)
+                memmove(node->data + (pos + m) * ds, node->data + pos * ds, (keep - pos - m) * ds);
+            memcpy(node->data + pos * ds, run, (uint64_t)in_run * ds);
+        }
+        node->count = keep;
+        node->size = keep;
+        return right;
+    }
+
+    uint32_t i = _rope_child_(node, &pos);
+    Rope_Node_t *split = _rope_insert_(self, node->child[i], pos, run, m);
+    node->size += m;
+    if (split == NULL)
+        return NULL;
+    if (node->count < CCTR_ROPE_FANOUT)
+    {
+        _rope_inner_put_(node, i + 1, split);
+        return NULL;
+    }
+
+    uint32_t keep = i + 1 == CCTR_ROPE_FANOUT ? CCTR_ROPE_FANOUT : CCTR_ROPE_FANOUT / 2;
+    Rope_Node_t *right = _rope_node_(self, 0);
+    right->count = CCTR_ROPE_FANOUT - keep;
+    memcpy(right->child, node->child + keep, right->count * sizeof(Rope_Node_t *));
+    node->count = keep;
+    if (i + 1 > keep || keep == CCTR_ROPE_FANOUT)
+        _rope_inner_put_(right, i + 1 - keep, split);
+    else
+        _rope_inner_put_(node, i + 1, split);
+    _rope_resize_(node);
+    _rope_resize_(right);
+    return right;
+}
+
+/*
+ * Erase
+ * children covered completely are dropped whole, afterwards neighbours which
+ * fit into one node are merged, so two neighbours always hold more than one
+ * node can
+ */
+static void _rope_merge_(Rope_t *self, Rope_Node_t *node)
+{
+    for (uint32_t i = 0; i + 1 < node->count;)
+    {
+        Rope_Node_t *left = node->child[i];
+        Rope_Node_t *right = node->child[i + 1];
+        uint32_t cap = left->leaf ? self->leaf_cap : CCTR_ROPE_FANOUT;
+        if (left->count + right->count > cap)
+        {
+            i++;
+            continue;
+        }
+        if (left->leaf)
+            memcpy(left->data + (uint64_t)left->count * self->dsize, right->data, (uint64_t)right->count * self->dsize);
+        else
+            memcpy(left->child + left->count, right->child, right->count * sizeof(Rope_Node_t *));
+        left->count += right->count;
+        left->size += right->size;
+        free(right);
+        memmove(node->child + i + 1, node->child + i + 2, (node->count - i - 2) * sizeof(Rope_Node_t *));
+        node->count--;
+    }
+}
+
+static void _rope_erase_(Rope_t *self, Rope_Node_t *node, uint64_t pos, uint64_t n)
+{
+    node->size -= n;
+    if (node->leaf)
+    {
+        const uint32_t ds = self->dsize;
+        memmove(node->data + pos * ds, node->data + (pos + n) * ds, (node->count - pos - n) * ds);
+        node->count -= (uint32_t)n;
+        return;
+    }
+
+    uint32_t i = 0;
+    while (pos >= node->child[i]->size)
+        pos -= node->child[i++]->size;
+    while (n > 0)
+    {
+        Rope_Node_t *child = node->child[i];
+        uint64_t take = child->size - pos < n ? child->size - pos : n;
+        if (take == child->size)
+        {
+            _rope_node_destroy_(child);
+            memmove(node->child + i, node->child + i + 1, (node->count - i - 1) * sizeof(Rope_Node_t *));
+            node->count--;
+        }
+        else
+        {
+            _rope_erase_(self, child, pos, take);
+            i++;
+        }
+        n -= take;
+        pos = 0;
+    }
+    _rope_merge_(self, node);
+}
+
+static void _rope_copy_out_(Rope_t *self, Rope_Node_t *node, uint64_t pos, uint64_t n, uint8_t **out)
+{
+    if (node->leaf)
+    {
+        memcpy(*out, node->data + pos * self->dsize, n * self->dsize);
+        *out += n * self->dsize;
+        return;
+    }
+    uint32_t i = 0;
+    while (pos >= node->child[i]->size)
+        pos -= node->child[i++]->size;
+    for (; n > 0; i++, pos = 0)
+    {
+        uint64_t take = node->child[i]->size - pos < n ? node->child[i]->size - pos : n;
+        _rope_copy_out_(self, node->child[i], pos, take, out);
+        n -= take;
+    }
+}
+
+/*
+ * Construct & Desctruct
+ */
+Rope_t *rope_construct(uint32_t dsize)
+{
+    assert(dsize > 0);
+    Rope_t *ret = (Rope_t *)malloc(sizeof(Rope_t));
+    assert(ret != NULL);
+    ret->root = NULL;
+    ret->size = 0;
+    ret->dsize = dsize;
+    ret->leaf_cap = CCTR_ROPE_LEAF_BYTES / dsize;
+    if (ret->leaf_cap < 4)
+        ret->leaf_cap = 4;
+    return ret;
+}
+
+Rope_t *rope_from_array(const void *array, uint64_t asize, uint32_t dsize)
+{
+    Rope_t *ret = rope_construct(dsize);
+    rope_insert(ret, 0, array, asize);
+    return ret;
+}
+
+void rope_clear(Rope_t *self)
+{
+    assert(self != NULL);
+    if (self->root != NULL)
+        _rope_node_destroy_(self->root);
+    self->root = NULL;
+    self->size = 0;
+}
+
+void rope_destroy(Rope_t *self)
+{
+    rope_clear(self);
+    free(self);
+}
+
+/*
+ * Usage
+ */
+void rope_insert(Rope_t *self, uint64_t pos, const void *array, uint64_t n)
+{
+    assert(self != NULL && pos <= self->size && (array != NULL || n == 0));
+    const uint8_t *run = (const uint8_t *)array;
+    while (n > 0)
+    {
+        uint32_t m = n < self->leaf_cap ? (uint32_t)n : self->leaf_cap;
+        if (self->root == NULL)
+            self->root = _rope_node_(self, 1);
+        Rope_Node_t *split = _rope_insert_(self, self->root, pos, run, m);
+        if (split != NULL)
+        {
+            Rope_Node_t *root = _rope_node_(self, 0);
+            root->child[0] = self->root;
+            root->child[1] = split;
+            root->count = 2;
+            _rope_resize_(root);
+            self->root = root;
+        }
+        self->size += m;
+        pos += m;
+        run += (uint64_t)m * self->dsize;
+        n -= m;
+    }
+}
+
+void rope_erase(Rope_t *self, uint64_t pos, uint64_t n)
+{
+    assert(self != NULL && pos + n <= self->size);
+    if (n == 0)
+        return;
+    if (n == self->size)
+    {
+        rope_clear(self);
+        return;
+    }
+    _rope_erase_(self, self->root, pos, n);
+    self->size -= n;
+    while (!self->root->leaf && self->root->count == 1)
+    {
+        Rope_Node_t *root = self->root;
+        self->root = root->child[0];
+        free(root);
+    }
+}
+
+void *rope_at(Rope_t *self, uint64_t pos)
+{
+    assert(self != NULL);
+    if (pos >= self->size)
+        return NULL;
+    Rope_Node_t *node = self->root;
+    while (!node->leaf)
+        node = node->child[_rope_child_(node, &pos)];
+    return node->data + pos * self->dsize;
+}
+
+void rope_copy_out(Rope_t *self, uint64_t pos, uint64_t n, void *out)
+{
+    assert(self != NULL && pos + n <= self->size);
+    uint8_t *ptr = (uint8_t *)out;
+    if (n > 0)
+        _rope_copy_out_(self, self->root, pos, n, &ptr);
+}
+
+void rope_export(Rope_t *self, void *out)
+{
+    rope_copy_out(self, 0, self->size, out);
+}
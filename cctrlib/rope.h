@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Rope, a balanced tree whose leaves hold chunks of up to leaf_cap elements
+ * and whose inner nodes know the number of elements below every child. Runs
+ * are inserted, erased and copied out at any position in O(log n) plus their
+ * length. Neighbouring nodes which fit into one are merged after an erase.
+ * Unlike Plist_t the nodes are never shared.
+ */
+#define CCTR_ROPE_FANOUT 32        // children per inner node
+#define CCTR_ROPE_LEAF_BYTES 1024 // payload bytes per leaf, at least 4 elements
+
+typedef struct Rope_Node_t
+{
+    uint64_t size;  // elements below
+    uint32_t count; // elements of a leaf, children of an inner node
+    uint32_t leaf;
+    union
+    {
+        struct Rope_Node_t *child[CCTR_ROPE_FANOUT];
+        uint8_t data[1]; // leaf_cap elements
+    };
+} Rope_Node_t;
+
+typedef struct
+{
+    Rope_Node_t *root; // NULL when empty
+    uint64_t size;
+    uint32_t dsize;
+    uint32_t leaf_cap;
+} Rope_t;
+
+/*
+ * Construct & Desctruct
+ */
+Rope_t *rope_construct(uint32_t dsize);
+Rope_t *rope_from_array(const void *array, uint64_t asize, uint32_t dsize);
+void rope_clear(Rope_t *self);
+void rope_destroy(Rope_t *self);
+
+/*
+ * Usage
+ * rope_copy_out copies n elements from pos on into out, rope_export all of them
+ */
+void rope_insert(Rope_t *self, uint64_t pos, const void *array, uint64_t n);
+void rope_erase(Rope_t *self, uint64_t pos, uint64_t n);
+void *rope_at(Rope_t *self, uint64_t pos);
+void rope_copy_out(Rope_t *self, uint64_t pos, uint64_t n, void *out);
+void rope_export(Rope_t *self, void *out);
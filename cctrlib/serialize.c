@@ -0,0 +1,269 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "serialize.h"
+
+#define CCTR_FILE_BUFFER (1 << 20)
+
+static void _cctr_file_header_(Cctr_File_Header_t *header, Cctr_File_Kind_t kind, uint32_t dsize, uint64_t count)
+{
+    memset(header, 0, sizeof(Cctr_File_Header_t));
+    header->magic = CCTR_FILE_MAGIC;
+    header->version = CCTR_FILE_VERSION;
+    header->kind = kind;
+    header->endian = CCTR_FILE_ENDIAN;
+    header->dsize = dsize;
+    header->count = count;
+    header->header_size = sizeof(Cctr_File_Header_t);
+}
+
+static int _cctr_file_check_(Cctr_File_Header_t *header, uint64_t file_size)
+{
+    if (file_size < sizeof(Cctr_File_Header_t) || header->magic != CCTR_FILE_MAGIC ||
+        header->endian != CCTR_FILE_ENDIAN || header->version != CCTR_FILE_VERSION ||
+        header->dsize == 0 || header->header_size < sizeof(Cctr_File_Header_t) ||
+        header->header_size > file_size ||
+        header->count > (file_size - header->header_size) / header->dsize)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+static int _cctr_write_all_(int fd, const void *buf, uint64_t len)
+{
+    const uint8_t *ptr = (const uint8_t *)buf;
+    while (len > 0)
+    {
+        ssize_t ret = write(fd, ptr, len);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        ptr += ret;
+        len -= (uint64_t)ret;
+    }
+    return 0;
+}
+
+static int _cctr_read_all_(int fd, void *buf, uint64_t len)
+{
+    uint8_t *ptr = (uint8_t *)buf;
+    while (len > 0)
+    {
+        ssize_t ret = read(fd, ptr, len);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+        {
+            if (ret == 0)
+                errno = EINVAL; // truncated
+            return -1;
+        }
+        ptr += ret;
+        len -= (uint64_t)ret;
+    }
+    return 0;
+}
+
+static int _cctr_close_(int fd, int ret)
+{
+    // keeps the errno of the first failure
+    int err = errno;
+    if (close(fd) < 0 && ret == 0)
+        return -1;
+    errno = err;
+    return ret;
+}
+
+static int _cctr_open_(const char *path, Cctr_File_Header_t *header, uint64_t *file_size)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+        goto fail;
+    if ((uint64_t)st.st_size < sizeof(Cctr_File_Header_t))
+    {
+        errno = EINVAL;
+        goto fail;
+    }
+    if (_cctr_read_all_(fd, header, sizeof(Cctr_File_Header_t)) < 0 ||
+        _cctr_file_check_(header, (uint64_t)st.st_size) < 0 ||
+        lseek(fd, (off_t)header->header_size, SEEK_SET) < 0)
+        goto fail;
+
+    *file_size = (uint64_t)st.st_size;
+    return fd;
+
+fail:
+    _cctr_close_(fd, -1);
+    return -1;
+}
+
+// ------------------------------------------------------------------
+int list_save(List_t *self, const char *path)
+{
+    assert(self != NULL);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return -1;
+
+    Cctr_File_Header_t header;
+    _cctr_file_header_(&header, CCTR_FILE_LIST, self->dsize, self->size);
+    if (_cctr_write_all_(fd, &header, sizeof(header)) < 0)
+        return _cctr_close_(fd, -1);
+
+    // payloads are gathered into a buffer, one write per buffer
+    uint64_t cap = CCTR_FILE_BUFFER / self->dsize > 0 ? CCTR_FILE_BUFFER / self->dsize * self->dsize : self->dsize;
+    uint8_t *buf = (uint8_t *)malloc(cap);
+    assert(buf != NULL);
+    uint64_t len = 0;
+    int ret = 0;
+    for (List_Node_t *ptr = self->head; ptr != NULL && ret == 0; ptr = ptr->next)
+    {
+        memcpy(buf + len, ptr->data, self->dsize);
+        len += self->dsize;
+        if (len == cap || ptr->next == NULL)
+        {
+            ret = _cctr_write_all_(fd, buf, len);
+            len = 0;
+        }
+    }
+    free(buf);
+    return _cctr_close_(fd, ret);
+}
+
+int array_save(Array_t *self, const char *path)
+{
+    assert(self != NULL);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return -1;
+
+    Cctr_File_Header_t header;
+    _cctr_file_header_(&header, CCTR_FILE_ARRAY, self->dsize, self->size);
+    int ret = _cctr_write_all_(fd, &header, sizeof(header));
+    if (ret == 0)
+        ret = _cctr_write_all_(fd, self->data, self->size * self->dsize);
+    return _cctr_close_(fd, ret);
+}
+
+// ------------------------------------------------------------------
+List_t *list_load(const char *path)
+{
+    Cctr_File_Header_t header;
+    uint64_t file_size;
+    int fd = _cctr_open_(path, &header, &file_size);
+    if (fd < 0)
+        return NULL;
+    if (header.count > UINT32_MAX)
+    {
+        // a valid file, of an array maybe, but more than the 32 bit size of a List_t
+        errno = EINVAL;
+        _cctr_close_(fd, -1);
+        return NULL;
+    }
+
+    uint64_t cap = CCTR_FILE_BUFFER / header.dsize > 0 ? CCTR_FILE_BUFFER / header.dsize : 1;
+    uint8_t *buf = (uint8_t *)malloc(cap * header.dsize);
+    assert(buf != NULL);
+    List_t *ret = list_init(header.dsize);
+
+    for (uint64_t done = 0; done < header.count;)
+    {
+        uint64_t n = header.count - done < cap ? header.count - done : cap;
+        if (_cctr_read_all_(fd, buf, n * header.dsize) < 0)
+        {
+            list_destroy(ret);
+            ret = NULL;
+            break;
+        }
+        list_push_back_n(ret, buf, (uint32_t)n); // one batch of nodes per buffer read
+        done += n;
+    }
+    free(buf);
+    _cctr_close_(fd, 0);
+    return ret;
+}
+
+Array_t *array_load(const char *path)
+{
+    Cctr_File_Header_t header;
+    uint64_t file_size;
+    int fd = _cctr_open_(path, &header, &file_size);
+    if (fd < 0)
+        return NULL;
+
+    Array_t *ret = array_construct(header.dsize);
+    if (header.count > 0)
+    {
+        array_reserve(ret, header.count);
+        if (_cctr_read_all_(fd, ret->data, header.count * header.dsize) < 0)
+        {
+            array_destroy(ret);
+            _cctr_close_(fd, -1);
+            return NULL;
+        }
+        ret->size = header.count;
+    }
+    _cctr_close_(fd, 0);
+    return ret;
+}
+
+Array_t *array_map(const char *path)
+{
+    Cctr_File_Header_t header;
+    uint64_t file_size;
+    int fd = _cctr_open_(path, &header, &file_size);
+    if (fd < 0)
+        return NULL;
+
+    // private and read-only, array_promote turns it into a copy-on-write mapping
+    void *map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    _cctr_close_(fd, 0);
+    if (map == MAP_FAILED)
+    {
+        errno = err;
+        return NULL;
+    }
+
+    Array_t *ret = array_construct(header.dsize);
+    ret->data = (uint8_t *)map + header.header_size;
+    ret->size = header.count;
+    ret->capacity = header.count;
+    ret->flags = CCTR_ARRAY_MAPPED | CCTR_ARRAY_READONLY;
+    ret->map = map;
+    ret->map_size = file_size;
+    return ret;
+}
@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * Binary container file
+ *
+ * | Cctr_File_Header_t (64 bytes) | count * dsize bytes of packed payload |
+ *
+ * Values are stored in host byte order, the endian field tells a file from a
+ * host with the other order apart. The payload starts at header_size, which
+ * keeps it aligned for array_map.
+ */
+
+#include <stdint.h>
+
+#include "list.h"
+#include "array.h"
+
+#pragma once
+
+#define CCTR_FILE_MAGIC 0x52544343 // "CCTR"
+#define CCTR_FILE_VERSION 1
+#define CCTR_FILE_ENDIAN 0x01020304
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind; // Cctr_File_Kind_t of the saved container, informational
+    uint32_t endian;
+    uint32_t dsize;
+    uint64_t count;
+    uint64_t header_size;
+    uint8_t reserved[32];
+} Cctr_File_Header_t;
+
+typedef enum
+{
+    CCTR_FILE_LIST = 1,
+    CCTR_FILE_ARRAY = 2,
+    CCTR_FILE_BITSET = 3,
+} Cctr_File_Kind_t;
+
+/*
+ * Save, 0 on success and -1 with errno set on failure
+ */
+int list_save(List_t *self, const char *path);
+int array_save(Array_t *self, const char *path);
+
+/*
+ * Load, NULL on failure. Any file can be loaded into any container kind.
+ */
+List_t *list_load(const char *path);
+Array_t *array_load(const char *path);
+Array_t *array_map(const char *path);
@@ -0,0 +1,453 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include "setop.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Compare
+ */
+enum
+{
+    _SETOP_UNION_,
+    _SETOP_INTERSECTION_,
+    _SETOP_DIFFERENCE_,
+    _SETOP_SYMMETRIC_,
+};
+
+typedef struct
+{
+    uint32_t dsize;
+    Cctr_Cmp_t cmp;
+    void *ctx;
+} _Setop_t_;
+
+static inline uint64_t _setop_int_(uint32_t dsize, const void *data)
+{
+    switch (dsize)
+    {
+    case 1:
+        return *(const uint8_t *)data;
+    case 2:
+        return *(const uint16_t *)data;
+    case 4:
+        return *(const uint32_t *)data;
+    default:
+        return *(const uint64_t *)data;
+    }
+}
+
+static inline int _setop_cmp_(const _Setop_t_ *s, const void *a, const void *b)
+{
+    if (s->cmp)
+        return s->cmp(a, b, s->ctx);
+    uint64_t x = _setop_int_(s->dsize, a);
+    uint64_t y = _setop_int_(s->dsize, b);
+    return (x > y) - (x < y);
+}
+
+// bound on the result length, the room out needs
+static inline uint64_t _setop_bound_(int op, uint64_t na, uint64_t nb)
+{
+    if (op == _SETOP_UNION_ || op == _SETOP_SYMMETRIC_)
+        return na + nb;
+    return op == _SETOP_INTERSECTION_ ? (na < nb ? na : nb) : na;
+}
+
+/*
+ * Merge
+ * one pass over both inputs, which elements are kept depends on op
+ */
+#define _SETOP_KEEP_A_(op) ((op) != _SETOP_INTERSECTION_)
+#define _SETOP_KEEP_B_(op) ((op) == _SETOP_UNION_ || (op) == _SETOP_SYMMETRIC_)
+#define _SETOP_KEEP_BOTH_(op) ((op) == _SETOP_UNION_ || (op) == _SETOP_INTERSECTION_)
+
+#define _SETOP_MERGE_(T)                                                                           \
+    static uint64_t _setop_merge_##T##_(int op, T *out, const T *a, uint64_t na, const T *b, uint64_t nb) \
+    {                                                                                              \
+        uint64_t i = 0, j = 0, n = 0;                                                              \
+        while (i < na && j < nb)                                                                   \
+        {                                                                                          \
+            if (a[i] < b[j])                                                                       \
+            {                                                                                      \
+                if (_SETOP_KEEP_A_(op))                                                            \
+                    out[n++] = a[i];                                                               \
+                i++;                                                                               \
+            }                                                                                      \
+            else if (b[j] < a[i])                                                                  \
+            {                                                                                      \
+                if (_SETOP_KEEP_B_(op))                                                            \
+                    out[n++] = b[j];                                                               \
+                j++;                                                                               \
+            }                                                                                      \
+            else                                                                                   \
+            {                                                                                      \
+                if (_SETOP_KEEP_BOTH_(op))                                                         \
+                    out[n++] = a[i];                                                               \
+                i++;                                                                               \
+                j++;                                                                               \
+            }                                                                                      \
+        }                                                                                          \
+        if (_SETOP_KEEP_A_(op))                                                                    \
+        {                                                                                          \
+            memcpy(out + n, a + i, (na - i) * sizeof(T));                                          \
+            n += na - i;                                                                           \
+        }                                                                                          \
+        if (_SETOP_KEEP_B_(op))                                                                    \
+        {                                                                                          \
+            memcpy(out + n, b + j, (nb - j) * sizeof(T));                                          \
+            n += nb - j;                                                                           \
+        }                                                                                          \
+        return n;                                                                                  \
+    }                                                                                              \
+    /* intersection without branches on the data, out[n] is written ahead and kept on a match */  \
+    static uint64_t _setop_intersect_##T##_(T *out, const T *a, uint64_t na, const T *b, uint64_t nb, \
+                                            uint64_t i, uint64_t j, uint64_t n)                    \
+    {                                                                                              \
+        while (i < na && j < nb)                                                                   \
+        {                                                                                          \
+            T x = a[i];                                                                            \
+            T y = b[j];                                                                            \
+            out[n] = x;                                                                            \
+            n += x == y;                                                                           \
+            i += x <= y;                                                                           \
+            j += y <= x;                                                                           \
+        }                                                                                          \
+        return n;                                                                                  \
+    }
+_SETOP_MERGE_(uint8_t)
+_SETOP_MERGE_(uint16_t)
+_SETOP_MERGE_(uint32_t)
+_SETOP_MERGE_(uint64_t)
+
+static uint64_t _setop_merge_(const _Setop_t_ *s, int op, uint8_t *out, const uint8_t *a, uint64_t na,
+                              const uint8_t *b, uint64_t nb)
+{
+    const uint32_t dsize = s->dsize;
+    uint64_t i = 0, j = 0, n = 0;
+    while (i < na && j < nb)
+    {
+        int c = _setop_cmp_(s, a + i * dsize, b + j * dsize);
+        if (c < 0)
+        {
+            if (_SETOP_KEEP_A_(op))
+                memcpy(out + n++ * dsize, a + i * dsize, dsize);
+            i++;
+        }
+        else if (c > 0)
+        {
+            if (_SETOP_KEEP_B_(op))
+                memcpy(out + n++ * dsize, b + j * dsize, dsize);
+            j++;
+        }
+        else
+        {
+            if (_SETOP_KEEP_BOTH_(op))
+                memcpy(out + n++ * dsize, a + i * dsize, dsize);
+            i++;
+            j++;
+        }
+    }
+    if (_SETOP_KEEP_A_(op))
+    {
+        memcpy(out + n * dsize, a + i * dsize, (na - i) * dsize);
+        n += na - i;
+    }
+    if (_SETOP_KEEP_B_(op))
+    {
+        memcpy(out + n * dsize, b + j * dsize, (nb - j) * dsize);
+        n += nb - j;
+    }
+    return n;
+}
+
+/*
+ * Vector intersection
+ * four 4 byte integers of each input compared all against all, the block with
+ * the smaller last element moves on, both on a tie
+ */
+#ifdef __SSE2__
+static uint64_t _setop_intersect_sse2_u32_(uint32_t *out, const uint32_t *a, uint64_t na, const uint32_t *b, uint64_t nb)
+{
+    // a round stores four elements from out + n on, it only runs while they fit
+    // in the min(na, nb) the caller has room for, the scalar merge takes the rest
+    const uint64_t cap = na < nb ? na : nb;
+    uint64_t i = 0, j = 0, n = 0;
+    while (i + 4 <= na && j + 4 <= nb && n + 4 <= cap)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        // all four written, the count only moves on a match, no branch on the mask
+        uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(m));
+        out[n] = a[i];
+        n += mask & 1;
+        out[n] = a[i + 1];
+        n += (mask >> 1) & 1;
+        out[n] = a[i + 2];
+        n += (mask >> 2) & 1;
+        out[n] = a[i + 3];
+        n += mask >> 3;
+        uint32_t amax = a[i + 3];
+        uint32_t bmax = b[j + 3];
+        i += (amax <= bmax) * 4;
+        j += (bmax <= amax) * 4;
+    }
+    return _setop_intersect_uint32_t_(out, a, na, b, nb, i, j, n);
+}
+#endif
+
+/*
+ * Galloping
+ * first position from start on whose element is >= key, doubling steps then
+ * a binary search over the last one
+ */
+static uint64_t _setop_gallop_(const _Setop_t_ *s, const uint8_t *base, uint64_t n, uint64_t start, const void *key)
+{
+    const uint32_t dsize = s->dsize;
+    uint64_t lo = start;
+    uint64_t hi = start;
+    uint64_t step = 1;
+    while (hi < n && _setop_cmp_(s, base + hi * dsize, key) < 0)
+    {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    if (hi > n)
+        hi = n;
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (_setop_cmp_(s, base + mid * dsize, key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static uint64_t _setop_gallop_intersect_(const _Setop_t_ *s, uint8_t *out, const uint8_t *small, uint64_t ns,
+                                         const uint8_t *large, uint64_t nl)
+{
+    const uint32_t dsize = s->dsize;
+    uint64_t j = 0, n = 0;
+    for (uint64_t i = 0; i < ns && j < nl; i++)
+    {
+        j = _setop_gallop_(s, large, nl, j, small + i * dsize);
+        if (j < nl && _setop_cmp_(s, large + j * dsize, small + i * dsize) == 0)
+            memcpy(out + n++ * dsize, small + i * dsize, dsize);
+    }
+    return n;
+}
+
+static uint64_t _setop_gallop_difference_(const _Setop_t_ *s, uint8_t *out, const uint8_t *a, uint64_t na,
+                                          const uint8_t *b, uint64_t nb)
+{
+    const uint32_t dsize = s->dsize;
+    uint64_t n = 0;
+    if (na < nb)
+    {
+        // every element of a looked up in b
+        uint64_t j = 0;
+        for (uint64_t i = 0; i < na; i++)
+        {
+            j = _setop_gallop_(s, b, nb, j, a + i * dsize);
+            if (j >= nb || _setop_cmp_(s, b + j * dsize, a + i * dsize) != 0)
+                memcpy(out + n++ * dsize, a + i * dsize, dsize);
+        }
+        return n;
+    }
+    // the runs of a between the elements of b copied whole
+    uint64_t i = 0;
+    for (uint64_t j = 0; j < nb && i < na; j++)
+    {
+        uint64_t k = _setop_gallop_(s, a, na, i, b + j * dsize);
+        memcpy(out + n * dsize, a + i * dsize, (k - i) * dsize);
+        n += k - i;
+        i = k < na && _setop_cmp_(s, a + k * dsize, b + j * dsize) == 0 ? k + 1 : k;
+    }
+    memcpy(out + n * dsize, a + i * dsize, (na - i) * dsize);
+    return n + na - i;
+}
+
+static uint64_t _setop_run_(int op, void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                            uint32_t dsize, Cctr_Cmp_t cmp, void *ctx)
+{
+    assert(cmp != NULL || dsize == 1 || dsize == 2 || dsize == 4 || dsize == 8);
+    const _Setop_t_ s = {dsize, cmp, ctx};
+    const int skewed = na >= CCTR_SETOP_SKEW * nb || nb >= CCTR_SETOP_SKEW * na;
+
+    if (op == _SETOP_INTERSECTION_)
+    {
+        if (na == 0 || nb == 0)
+            return 0;
+        if (skewed)
+            return na < nb ? _setop_gallop_intersect_(&s, out, a, na, b, nb) : _setop_gallop_intersect_(&s, out, b, nb, a, na);
+    }
+    if (op == _SETOP_DIFFERENCE_ && skewed && na > 0 && nb > 0)
+        return _setop_gallop_difference_(&s, out, a, na, b, nb);
+    if (cmp != NULL)
+        return _setop_merge_(&s, op, out, a, na, b, nb);
+
+    switch (dsize)
+    {
+    case 1:
+        if (op == _SETOP_INTERSECTION_)
+            return _setop_intersect_uint8_t_(out, a, na, b, nb, 0, 0, 0);
+        return _setop_merge_uint8_t_(op, out, a, na, b, nb);
+    case 2:
+        if (op == _SETOP_INTERSECTION_)
+            return _setop_intersect_uint16_t_(out, a, na, b, nb, 0, 0, 0);
+        return _setop_merge_uint16_t_(op, out, a, na, b, nb);
+    case 4:
+#ifdef __SSE2__
+        if (op == _SETOP_INTERSECTION_)
+            return _setop_intersect_sse2_u32_(out, a, na, b, nb);
+#else
+        if (op == _SETOP_INTERSECTION_)
+            return _setop_intersect_uint32_t_(out, a, na, b, nb, 0, 0, 0);
+#endif
+        return _setop_merge_uint32_t_(op, out, a, na, b, nb);
+    default:
+        // SSE2 has no 64 bit compare, two 32 bit ones lose to the scalar merge
+        if (op == _SETOP_INTERSECTION_)
+            return _setop_intersect_uint64_t_(out, a, na, b, nb, 0, 0, 0);
+        return _setop_merge_uint64_t_(op, out, a, na, b, nb);
+    }
+}
+
+/*
+ * Buffers
+ */
+uint64_t cctr_set_union(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                        uint32_t dsize, Cctr_Cmp_t cmp, void *ctx)
+{
+    return _setop_run_(_SETOP_UNION_, out, a, na, b, nb, dsize, cmp, ctx);
+}
+
+uint64_t cctr_set_intersection(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                               uint32_t dsize, Cctr_Cmp_t cmp, void *ctx)
+{
+    return _setop_run_(_SETOP_INTERSECTION_, out, a, na, b, nb, dsize, cmp, ctx);
+}
+
+uint64_t cctr_set_difference(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                             uint32_t dsize, Cctr_Cmp_t cmp, void *ctx)
+{
+    return _setop_run_(_SETOP_DIFFERENCE_, out, a, na, b, nb, dsize, cmp, ctx);
+}
+
+uint64_t cctr_set_symmetric_difference(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                                       uint32_t dsize, Cctr_Cmp_t cmp, void *ctx)
+{
+    return _setop_run_(_SETOP_SYMMETRIC_, out, a, na, b, nb, dsize, cmp, ctx);
+}
+
+/*
+ * Containers
+ */
+static void _array_setop_(int op, Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    assert(dst != NULL && a != NULL && b != NULL);
+    assert(dst != a && dst != b);
+    assert(a->dsize == b->dsize && dst->dsize == a->dsize);
+    array_reserve(dst, dst->size + _setop_bound_(op, a->size, b->size));
+    uint8_t *out = (uint8_t *)dst->data + dst->size * dst->dsize;
+    dst->size += _setop_run_(op, out, a->data, a->size, b->data, b->size, a->dsize, cmp, ctx);
+}
+
+void array_set_union(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _array_setop_(_SETOP_UNION_, dst, a, b, cmp, ctx);
+}
+
+void array_set_intersection(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _array_setop_(_SETOP_INTERSECTION_, dst, a, b, cmp, ctx);
+}
+
+void array_set_difference(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _array_setop_(_SETOP_DIFFERENCE_, dst, a, b, cmp, ctx);
+}
+
+void array_set_symmetric_difference(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _array_setop_(_SETOP_SYMMETRIC_, dst, a, b, cmp, ctx);
+}
+
+// the payloads of a list packed in list order
+static uint8_t *_setop_gather_(List_t *self)
+{
+    uint8_t *ret = (uint8_t *)malloc((uint64_t)self->size * self->dsize + 1);
+    assert(ret != NULL);
+    uint8_t *ptr = ret;
+    for (List_Node_t *node = self->head; node != NULL; node = node->next, ptr += self->dsize)
+        memcpy(ptr, node->data, self->dsize);
+    return ret;
+}
+
+static void _list_setop_(int op, List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    // a list has no random access to gallop or load vectors from, both are packed first
+    assert(dst != NULL && a != NULL && b != NULL);
+    assert(dst != a && dst != b);
+    assert(a->dsize == b->dsize && dst->dsize == a->dsize);
+    uint8_t *pa = _setop_gather_(a);
+    uint8_t *pb = _setop_gather_(b);
+    uint8_t *out = (uint8_t *)malloc(_setop_bound_(op, a->size, b->size) * a->dsize + 1);
+    assert(out != NULL);
+    uint64_t n = _setop_run_(op, out, pa, a->size, pb, b->size, a->dsize, cmp, ctx);
+    // a union of two long lists can outgrow the 32 bit size of a List_t
+    assert(n <= UINT32_MAX - dst->size);
+    list_push_back_n(dst, out, (uint32_t)n);
+    free(pa);
+    free(pb);
+    free(out);
+}
+
+void list_set_union(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _list_setop_(_SETOP_UNION_, dst, a, b, cmp, ctx);
+}
+
+void list_set_intersection(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _list_setop_(_SETOP_INTERSECTION_, dst, a, b, cmp, ctx);
+}
+
+void list_set_difference(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _list_setop_(_SETOP_DIFFERENCE_, dst, a, b, cmp, ctx);
+}
+
+void list_set_symmetric_difference(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx)
+{
+    _list_setop_(_SETOP_SYMMETRIC_, dst, a, b, cmp, ctx);
+}
@@ -0,0 +1,72 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "list.h"
+#include "array.h"
+#include "sort.h"
+
+#pragma once
+
+/*
+ * Set algebra
+ * Inputs are sorted ascending without duplicates, the result is too. Without
+ * a comparator the elements are unsigned integers of 1, 2, 4 or 8 bytes like
+ * the keys of Bset_t, otherwise cmp orders them (sort.h). All operations are
+ * one merge pass over both inputs. Intersection and difference gallop through
+ * the longer input when the lengths differ by CCTR_SETOP_SKEW or more, and
+ * intersect 4 byte integers a vector at a time where SSE2 is available,
+ * other integers with a merge free of data dependent branches.
+ */
+#define CCTR_SETOP_SKEW 32
+
+/*
+ * Buffers
+ * out has room for na + nb elements (union, symmetric difference), min(na, nb)
+ * (intersection) or na (difference), the number written is returned
+ */
+uint64_t cctr_set_union(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                        uint32_t dsize, Cctr_Cmp_t cmp, void *ctx);
+uint64_t cctr_set_intersection(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                               uint32_t dsize, Cctr_Cmp_t cmp, void *ctx);
+uint64_t cctr_set_difference(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                             uint32_t dsize, Cctr_Cmp_t cmp, void *ctx);
+uint64_t cctr_set_symmetric_difference(void *out, const void *a, uint64_t na, const void *b, uint64_t nb,
+                                       uint32_t dsize, Cctr_Cmp_t cmp, void *ctx);
+
+/*
+ * Containers
+ * the result is appended to dst, which must not be a or b. An Array_t is
+ * written in place once its capacity is reserved, a List_t gets all result
+ * nodes from one batch allocation.
+ */
+void array_set_union(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx);
+void array_set_intersection(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx);
+void array_set_difference(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx);
+void array_set_symmetric_difference(Array_t *dst, Array_t *a, Array_t *b, Cctr_Cmp_t cmp, void *ctx);
+void list_set_union(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx);
+void list_set_intersection(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx);
+void list_set_difference(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx);
+void list_set_symmetric_difference(List_t *dst, List_t *a, List_t *b, Cctr_Cmp_t cmp, void *ctx);
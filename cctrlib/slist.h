@@ -26,6 +26,9 @@ SOFTWARE.
 
 #include <assert.h>
 
+#include "block.h"
+#include "huge.h"
+
 #pragma once
 
 // ==============================================================
@@ -36,23 +39,77 @@ typedef struct Slist_Node_t
 {
     void *data;
     struct Slist_Node_t *next;
+    struct Cctr_Block_t *block; // NULL unless allocated by a batch
 } Slist_Node_t;
 
-inline Slist_Node_t *_slist_node_construct_(void *data, uint32_t dsize)
+static inline Slist_Node_t *_slist_node_huge_(Cctr_Huge_t *huge)
+{
+    // node and payload in one slot of the arena, the layout of a batch
+    Cctr_Block_t *block;
+    Slist_Node_t *node = (Slist_Node_t *)cctr_huge_alloc(huge, &block);
+    node->data = (uint8_t *)node + CCTR_ALIGN(sizeof(Slist_Node_t));
+    node->block = block;
+    return node;
+}
+static inline Slist_Node_t *_slist_node_construct_(void *data, uint32_t dsize, Cctr_Huge_t *huge)
 {
     assert(data != NULL);
-    Slist_Node_t *node = (Slist_Node_t *)malloc(sizeof(Slist_Node_t));
-    assert(node != NULL);
-    node->data = malloc(dsize);
-    assert(node->data != NULL);
+    if (huge != NULL)
+    {
+        Slist_Node_t *node = _slist_node_huge_(huge);
+        memcpy(node->data, data, dsize);
+        node->next = NULL;
+        return node;
+    }
+    void *node_data;
+    Slist_Node_t *node = (Slist_Node_t *)cctr_node_alloc(sizeof(Slist_Node_t), dsize, &node_data);
+    node->data = node_data;
     memcpy(node->data, data, dsize);
+    node->next = NULL;
+    node->block = NULL;
     return node;
 }
-inline void _slist_node_destruct_(Slist_Node_t *self)
+static inline void _slist_node_destruct_(Slist_Node_t *self, uint32_t dsize)
 {
     assert(self != NULL);
-    free(self->data);
-    free(self);
+    if (self->block != NULL)
+    {
+        cctr_block_release(self->block);
+        return;
+    }
+    cctr_node_free(self, self->data, dsize);
+}
+static inline Slist_Node_t *_slist_node_block_(void *array, uint64_t asize, uint32_t dsize, Cctr_Huge_t *huge, Slist_Node_t **last)
+{
+    // links asize nodes carved from one block (or the huge page arena), in array order, returns the first one
+    const uint64_t node_size = CCTR_ALIGN(sizeof(Slist_Node_t));
+    const uint64_t stride = node_size + CCTR_ALIGN(dsize);
+    Cctr_Block_t *block = huge == NULL ? cctr_block_construct(asize, stride) : NULL;
+
+    uint8_t *aptr = (uint8_t *)array;
+    Slist_Node_t *first = NULL;
+    Slist_Node_t *node = NULL;
+    for (uint64_t i = 0; i < asize; i++)
+    {
+        Slist_Node_t *prev = node;
+        if (block != NULL)
+        {
+            node = (Slist_Node_t *)cctr_block_at(block, stride, i);
+            node->data = (uint8_t *)node + node_size;
+            node->block = block;
+        }
+        else
+            node = _slist_node_huge_(huge);
+        memcpy(node->data, aptr, dsize);
+        node->next = NULL;
+        if (prev != NULL)
+            prev->next = node;
+        else
+            first = node;
+        aptr += dsize;
+    }
+    *last = node;
+    return first;
 }
 
 // ==============================================================
@@ -65,58 +122,65 @@ typedef struct
     Slist_Node_t *tail;
     uint64_t size; // ! since it is read in single way, so it can be uint64_t, but it probably wont use so much
     uint32_t dsize;
+    Cctr_Huge_t *huge; // node storage of slist_construct_huge, NULL for malloc
 } Slist_t;
 
 /*
  * Construct & Desctruct
+ * slist_construct_huge keeps the nodes and payloads in huge page regions
+ * (huge.h), copies of it do the same
  */
-Slist_t *slist_construct(uint32_t dsize)
+static inline Slist_t *slist_construct(uint32_t dsize)
 {
-    Slist_t *ret = (Slist_t *)calloc(1, sizeof(Slist_Node_t));
+    Slist_t *ret = (Slist_t *)calloc(1, sizeof(Slist_t));
     assert(ret != NULL);
     ret->dsize = dsize;
     return ret;
 }
-void slist_clear(Slist_t *self)
+static inline Slist_t *slist_construct_huge(uint32_t dsize)
+{
+    Slist_t *ret = slist_construct(dsize);
+    ret->huge = cctr_huge_construct(CCTR_ALIGN(sizeof(Slist_Node_t)) + CCTR_ALIGN(dsize));
+    return ret;
+}
+static inline void slist_clear(Slist_t *self)
 {
     assert(self != NULL);
-    assert(self->head != NULL);
     Slist_Node_t *ptr = self->head;
     while (ptr != NULL)
     {
         Slist_Node_t *rmv = ptr;
         ptr = ptr->next;
-        _slist_node_destruct_(rmv);
+        _slist_node_destruct_(rmv, self->dsize);
     }
     self->head = NULL;
     self->tail = NULL;
     self->size = 0;
 }
-void slist_destroy(Slist_t *self)
+static inline void slist_destroy(Slist_t *self)
 {
     slist_clear(self);
+    if (self->huge != NULL)
+        cctr_huge_destroy(self->huge);
     free(self);
 }
-Slist_t *slist_copy(Slist_t *self)
+static inline Slist_t *slist_copy(Slist_t *self)
 {
     assert(self != NULL);
-    Slist_t *ret = slist_construct(self->dsize);
+    Slist_t *ret = self->huge != NULL ? slist_construct_huge(self->dsize) : slist_construct(self->dsize);
 
     Slist_Node_t *prev = NULL;
     for (Slist_Node_t *ptr = self->head; ptr != NULL; ptr = ptr->next)
     {
-        Slist_Node_t *node = _slist_node_construct_(ptr->data, self->dsize);
+        Slist_Node_t *node = _slist_node_construct_(ptr->data, self->dsize, ret->huge);
 
         if (prev != NULL)
             prev->next = node;
-        prev = node;
-
-        if (ptr == self->head)
+        else
             ret->head = node;
-        else if (ptr == self->tail)
-            ret->tail = node;
+        prev = node;
     }
-    ret->tail->next = NULL;
+    ret->tail = prev;
 
     ret->size = self->size;
     return ret;
@@ -125,24 +189,24 @@ Slist_t *slist_copy(Slist_t *self)
 /*
  * Basic Usage
  */
-void *slist_front(Slist_t *self)
+static inline void *slist_front(Slist_t *self)
 {
     assert(self != NULL);
     assert(self->head != NULL);
     return self->head->data;
 }
-void *slist_back(Slist_t *self)
+static inline void *slist_back(Slist_t *self)
 {
     assert(self != NULL);
     assert(self->tail != NULL);
     return self->tail->data;
 }
-void slist_push_front(Slist_t *self, void *data)
+static inline void slist_push_front(Slist_t *self, void *data)
 {
     assert(self != NULL);
     assert(data != NULL);
 
-    Slist_Node_t *node = _slist_node_construct_(data, self->dsize);
+    Slist_Node_t *node = _slist_node_construct_(data, self->dsize, self->huge);
     node->next = self->head;
 
     self->head = node;
@@ -151,12 +215,12 @@ void slist_push_front(Slist_t *self, void *data)
 
     self->size++;
 }
-void slist_push_back(Slist_t *self, void *data)
+static inline void slist_push_back(Slist_t *self, void *data)
 {
     assert(self != NULL);
     assert(data != NULL);
 
-    Slist_Node_t *node = _slist_node_construct_(data, self->dsize);
+    Slist_Node_t *node = _slist_node_construct_(data, self->dsize, self->huge);
     node->next = NULL;
 
     if (self->tail != NULL)
@@ -167,7 +231,7 @@ void slist_push_back(Slist_t *self, void *data)
 
     self->size++;
 }
-void slist_pop_front(Slist_t *self)
+static inline void slist_pop_front(Slist_t *self)
 {
     assert(self != NULL);
     Slist_Node_t *rmv = self->head;
@@ -181,19 +245,31 @@ void slist_pop_front(Slist_t *self)
     if (self->size == 0)
         self->tail = NULL;
 
-    _slist_node_destruct_(rmv);
+    _slist_node_destruct_(rmv, self->dsize);
 }
 
 /*
  * Iteration
+ * An iterator is a node pointer, NULL stands for "before head" so that
+ * the front of the list can be reached through the *_after functions.
  */
-Slist_Node_t *_slist_at_(Slist_t *self, uint64_t position)
+static inline Slist_Node_t *slist_begin(Slist_t *self)
+{
+    assert(self != NULL);
+    return self->head;
+}
+static inline Slist_Node_t *slist_next(Slist_Node_t *node)
+{
+    assert(node != NULL);
+    return node->next;
+}
+static inline Slist_Node_t *_slist_at_(Slist_t *self, uint64_t position)
 {
     assert(self != NULL);
 
-    if (position > self->size)
+    if (position >= self->size)
         return NULL;
-    else if (position == self->size)
+    else if (position == self->size - 1)
         return self->tail;
 
     Slist_Node_t *node = self->head;
@@ -202,43 +278,241 @@ Slist_Node_t *_slist_at_(Slist_t *self, uint64_t position)
 
     return node;
 }
-void *slist_at(Slist_t *self, uint64_t position)
+static inline void *slist_at(Slist_t *self, uint64_t position)
 {
     Slist_Node_t *node = _slist_at_(self, position);
-    return node->data;
+    return node != NULL ? node->data : NULL;
 }
-void slist_insert(Slist_t *self, uint64_t position, void *data)
+static inline Slist_Node_t *slist_insert_after(Slist_t *self, Slist_Node_t *prev_node, void *data)
 {
     assert(self != NULL);
     assert(data != NULL);
-    assert(position <= self->size);
 
-    Slist_Node_t *prev_node;
-    Slist_Node_t *next_node;
+    Slist_Node_t *node = _slist_node_construct_(data, self->dsize, self->huge);
 
-    if (position > 0)
+    if (prev_node != NULL)
     {
-        prev_node = _slist_at_(self, position - 1);
-        next_node = prev_node->next;
+        node->next = prev_node->next;
+        prev_node->next = node;
     }
     else
     {
+        node->next = self->head;
+        self->head = node;
+    }
+
+    if (node->next == NULL)
+        self->tail = node;
+    self->size++;
+    return node;
+}
+static inline void slist_erase_after(Slist_t *self, Slist_Node_t *prev_node)
+{
+    assert(self != NULL);
+
+    Slist_Node_t *rmv = prev_node != NULL ? prev_node->next : self->head;
+    if (rmv == NULL)
+        return;
+
+    if (prev_node != NULL)
+        prev_node->next = rmv->next;
+    else
+        self->head = rmv->next;
+
+    if (rmv == self->tail)
+        self->tail = prev_node;
+    self->size--;
+
+    _slist_node_destruct_(rmv, self->dsize);
+}
+static inline void slist_insert(Slist_t *self, uint64_t position, void *data)
+{
+    assert(self != NULL);
+    assert(data != NULL);
+    assert(position <= self->size);
+
+    // the tail is known, so only positions in the middle have to walk
+    Slist_Node_t *prev_node;
+    if (position == 0)
         prev_node = NULL;
-        next_node = self->head;
+    else if (position == self->size)
+        prev_node = self->tail;
+    else
+        prev_node = _slist_at_(self, position - 1);
+
+    slist_insert_after(self, prev_node, data);
+}
+static inline void slist_erase(Slist_t *self, uint64_t position)
+{
+    assert(self != NULL);
+    assert(position < self->size);
+
+    Slist_Node_t *prev_node = position > 0 ? _slist_at_(self, position - 1) : NULL;
+    slist_erase_after(self, prev_node);
+}
+
+/*
+ * Additional
+ */
+static inline void slist_splice(Slist_t *self, Slist_t *object)
+{
+    // moves every node of object onto the tail of self, object is left empty
+    assert(self != NULL);
+    assert(object != NULL);
+    assert(self->dsize == object->dsize);
+
+    if (self == object || object->head == NULL)
+        return;
+
+    if (self->tail != NULL)
+        self->tail->next = object->head;
+    else
+        self->head = object->head;
+    self->tail = object->tail;
+    self->size += object->size;
+
+    object->head = NULL;
+    object->tail = NULL;
+    object->size = 0;
+}
+static inline void slist_reverse(Slist_t *self)
+{
+    assert(self != NULL);
+
+    Slist_Node_t *prev = NULL;
+    Slist_Node_t *ptr = self->head;
+    while (ptr != NULL)
+    {
+        Slist_Node_t *next = ptr->next;
+        ptr->next = prev;
+        prev = ptr;
+        ptr = next;
+    }
+    self->tail = self->head;
+    self->head = prev;
+}
+static inline Slist_t *slist_split_front(Slist_t *self, uint64_t n)
+{
+    // detaches the first n nodes as a new list, the nodes are handed over and not copied and
+    // may keep sharing their batch blocks with self (block.h)
+    assert(self != NULL);
+
+    Slist_t *ret = slist_construct(self->dsize);
+    if (n == 0 || self->head == NULL)
+        return ret;
+
+    if (n >= self->size)
+    {
+        // the arena stays with self, the nodes keep their regions alive
+        *ret = *self;
+        ret->huge = NULL;
+        self->head = NULL;
+        self->tail = NULL;
+        self->size = 0;
+        return ret;
     }
 
-    Slist_Node_t *node = _slist_node_construct_(data, self->dsize);
+    Slist_Node_t *last = _slist_at_(self, n - 1);
+    ret->head = self->head;
+    ret->tail = last;
+    ret->size = n;
 
-    if (position > 0)
-        prev_node->next = node;
+    self->head = last->next;
+    self->size -= n;
+    last->next = NULL;
+    return ret;
+}
+
+/*
+ * Batch, the nodes of one call come from one block
+ * the _n calls copy elements in or out like those of List_t and Xlist_t, counts
+ * are uint64_t as the size of Slist_t
+ */
+static inline void slist_push_front_n(Slist_t *self, void *array, uint64_t asize)
+{
+    // array[0] becomes the front
+    assert(self != NULL);
+    if (asize == 0)
+        return;
+
+    Slist_Node_t *last;
+    Slist_Node_t *first = _slist_node_block_(array, asize, self->dsize, self->huge, &last);
+    last->next = self->head;
+    if (self->head == NULL)
+        self->tail = last;
+    self->head = first;
+    self->size += asize;
+}
+static inline void slist_push_back_n(Slist_t *self, void *array, uint64_t asize)
+{
+    assert(self != NULL);
+    if (asize == 0)
+        return;
+
+    Slist_Node_t *last;
+    Slist_Node_t *first = _slist_node_block_(array, asize, self->dsize, self->huge, &last);
+    if (self->tail != NULL)
+        self->tail->next = first;
     else
-        self->head = node;
-    node->next = next_node;
-    self->size++;
+        self->head = first;
+    self->tail = last;
+    self->size += asize;
 }
-void slist_erase(Slist_t *self, uint64_t position)
+static inline void _slist_pop_chain_(Slist_Node_t *ptr, uint64_t n, void *out, uint32_t dsize)
 {
+    // copies n unlinked nodes from ptr onwards to out (if not NULL) and frees them
+    uint8_t *optr = (uint8_t *)out;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        Slist_Node_t *rmv = ptr;
+        ptr = ptr->next;
+        if (optr != NULL)
+        {
+            memcpy(optr, rmv->data, dsize);
+            optr += dsize;
+        }
+        _slist_node_destruct_(rmv, dsize);
+    }
+}
+static inline uint64_t slist_pop_front_n(Slist_t *self, void *out, uint64_t n)
+{
+    // out receives the popped elements in list order, as list_pop_front_n and xlist_pop_front_n
+    assert(self != NULL);
+    if (n > self->size)
+        n = self->size;
+    if (n == 0)
+        return 0;
+
+    Slist_Node_t *first = self->head;
+    Slist_Node_t *last = n == self->size ? self->tail : _slist_at_(self, n - 1);
+
+    self->head = last->next;
+    if (self->head == NULL)
+        self->tail = NULL;
+    self->size -= n;
+
+    _slist_pop_chain_(first, n, out, self->dsize);
+    return n;
+}
+static inline uint64_t slist_pop_back_n(Slist_t *self, void *out, uint64_t n)
+{
+    // out receives the popped elements in list order, walks once to the new tail
     assert(self != NULL);
+    if (n > self->size)
+        n = self->size;
+    if (n == 0)
+        return 0;
 
-    Slist_Node_t *prev_node = _slist_at_(self, position - 1);
-}
\ No newline at end of file
+    Slist_Node_t *tail = n < self->size ? _slist_at_(self, self->size - n - 1) : NULL;
+    Slist_Node_t *first = tail != NULL ? tail->next : self->head;
+
+    if (tail != NULL)
+        tail->next = NULL;
+    else
+        self->head = NULL;
+    self->tail = tail;
+    self->size -= n;
+
+    _slist_pop_chain_(first, n, out, self->dsize);
+    return n;
+}
@@ -0,0 +1,327 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include "soa.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Columns
+ */
+static inline uint8_t *_soa_column_alloc_(uint64_t bytes)
+{
+    // aligned_alloc wants a multiple of the alignment
+    bytes = (bytes + CCTR_SOA_ALIGN - 1) & ~(uint64_t)(CCTR_SOA_ALIGN - 1);
+    uint8_t *ret = (uint8_t *)aligned_alloc(CCTR_SOA_ALIGN, bytes ? bytes : CCTR_SOA_ALIGN);
+    assert(ret != NULL);
+    return ret;
+}
+
+static inline void _soa_copy_(uint8_t *dst, const uint8_t *src, uint32_t size)
+{
+    // the common field sizes as one move
+    switch (size)
+    {
+    case 1:
+        *dst = *src;
+        break;
+    case 2:
+        memcpy(dst, src, 2);
+        break;
+    case 4:
+        memcpy(dst, src, 4);
+        break;
+    case 8:
+        memcpy(dst, src, 8);
+        break;
+    default:
+        memcpy(dst, src, size);
+    }
+}
+
+static void _soa_grow_(Soa_t *self, uint64_t extra)
+{
+    if (self->size + extra <= self->capacity)
+        return;
+    uint64_t capacity = self->capacity ? self->capacity * 2 : 64;
+    while (capacity < self->size + extra)
+        capacity *= 2;
+    soa_reserve(self, capacity);
+}
+
+// ------------------------------------------------------------------
+Soa_t *soa_construct(uint32_t dsize, const Soa_Field_t *fields, uint32_t nfields)
+{
+    assert(dsize > 0 && fields != NULL && nfields > 0);
+    uint32_t covered = 0;
+    for (uint32_t i = 0; i < nfields; i++)
+    {
+        assert(fields[i].size > 0 && fields[i].offset + fields[i].size <= dsize);
+        for (uint32_t j = 0; j < i; j++)
+            assert(fields[i].offset + fields[i].size <= fields[j].offset ||
+                   fields[j].offset + fields[j].size <= fields[i].offset);
+        covered += fields[i].size;
+    }
+
+    Soa_t *ret = (Soa_t *)calloc(1, sizeof(Soa_t));
+    assert(ret != NULL);
+    ret->column = (uint8_t **)calloc(nfields, sizeof(uint8_t *));
+    ret->fields = (Soa_Field_t *)malloc(nfields * sizeof(Soa_Field_t));
+    assert(ret->column != NULL && ret->fields != NULL);
+    memcpy(ret->fields, fields, nfields * sizeof(Soa_Field_t));
+    ret->nfields = nfields;
+    ret->dsize = dsize;
+    ret->gaps = dsize - covered;
+    return ret;
+}
+
+Soa_t *soa_from_list(List_t *list, const Soa_Field_t *fields, uint32_t nfields)
+{
+    assert(list != NULL);
+    Soa_t *ret = soa_construct(list->dsize, fields, nfields);
+    soa_reserve(ret, list->size);
+    for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next)
+        soa_push_back(ret, ptr->data);
+    return ret;
+}
+
+void soa_clear(Soa_t *self)
+{
+    assert(self != NULL);
+    self->size = 0;
+}
+
+void soa_destroy(Soa_t *self)
+{
+    assert(self != NULL);
+    for (uint32_t i = 0; i < self->nfields; i++)
+        free(self->column[i]);
+    free(self->column);
+    free(self->fields);
+    free(self);
+}
+
+void soa_reserve(Soa_t *self, uint64_t capacity)
+{
+    assert(self != NULL);
+    if (capacity <= self->capacity)
+        return;
+    // realloc would lose the alignment
+    for (uint32_t i = 0; i < self->nfields; i++)
+    {
+        uint8_t *column = _soa_column_alloc_(capacity * self->fields[i].size);
+        if (self->size > 0)
+            memcpy(column, self->column[i], self->size * self->fields[i].size);
+        free(self->column[i]);
+        self->column[i] = column;
+    }
+    self->capacity = capacity;
+}
+
+/*
+ * Basic Usage
+ */
+void soa_push_back(Soa_t *self, const void *record)
+{
+    assert(self != NULL && record != NULL);
+    _soa_grow_(self, 1);
+    self->size++;
+    soa_set(self, self->size - 1, record);
+}
+
+void soa_push_back_n(Soa_t *self, const void *array, uint64_t n)
+{
+    assert(self != NULL && (array != NULL || n == 0));
+    _soa_grow_(self, n);
+    // column after column, each written front to back
+    for (uint32_t i = 0; i < self->nfields; i++)
+    {
+        const uint32_t size = self->fields[i].size;
+        const uint8_t *src = (const uint8_t *)array + self->fields[i].offset;
+        uint8_t *dst = self->column[i] + self->size * size;
+        for (uint64_t r = 0; r < n; r++, src += self->dsize, dst += size)
+            _soa_copy_(dst, src, size);
+    }
+    self->size += n;
+}
+
+void soa_pop_back(Soa_t *self)
+{
+    assert(self != NULL);
+    if (self->size > 0)
+        self->size--;
+}
+
+void soa_set(Soa_t *self, uint64_t pos, const void *record)
+{
+    assert(self != NULL && pos < self->size);
+    const uint8_t *src = (const uint8_t *)record;
+    for (uint32_t i = 0; i < self->nfields; i++)
+        _soa_copy_(self->column[i] + pos * self->fields[i].size, src + self->fields[i].offset, self->fields[i].size);
+}
+
+void soa_gather(Soa_t *self, uint64_t pos, void *record)
+{
+    assert(self != NULL && pos < self->size);
+    uint8_t *dst = (uint8_t *)record;
+    if (self->gaps > 0)
+        memset(dst, 0, self->dsize);
+    for (uint32_t i = 0; i < self->nfields; i++)
+        _soa_copy_(dst + self->fields[i].offset, self->column[i] + pos * self->fields[i].size, self->fields[i].size);
+}
+
+void soa_erase_range(Soa_t *self, uint64_t from, uint64_t to)
+{
+    assert(self != NULL);
+    to = to < self->size ? to : self->size;
+    if (from >= to)
+        return;
+    for (uint32_t i = 0; i < self->nfields; i++)
+    {
+        const uint32_t size = self->fields[i].size;
+        memmove(self->column[i] + from * size, self->column[i] + to * size, (self->size - to) * size);
+    }
+    self->size -= to - from;
+}
+
+void soa_erase(Soa_t *self, uint64_t pos)
+{
+    assert(self != NULL && pos < self->size);
+    soa_erase_range(self, pos, pos + 1);
+}
+
+/*
+ * Searching
+ * Fields of 1, 2, 4 and 8 bytes are compared 64 bytes at a time: four byte
+ * wise SSE2 compares give a 64 bit mask, a row matches when all bits of its
+ * bytes are set, which folds down onto the first bit of the row. Other sizes
+ * and the rest of the column go row by row.
+ */
+static inline int _soa_equal_(const uint8_t *a, const uint8_t *b, uint32_t size)
+{
+    // fixed sizes become single loads, the value may be unaligned
+    switch (size)
+    {
+    case 1:
+        return *a == *b;
+    case 2:
+        return !memcmp(a, b, 2);
+    case 4:
+        return !memcmp(a, b, 4);
+    case 8:
+        return !memcmp(a, b, 8);
+    default:
+        return !memcmp(a, b, size);
+    }
+}
+
+#ifdef __SSE2__
+static inline uint64_t _soa_fold_(uint64_t mask, uint32_t size)
+{
+    // the first bit of a row stays set when the bits of all its bytes are
+    switch (size)
+    {
+    case 1:
+        return mask;
+    case 2:
+        return mask & (mask >> 1) & 0x5555555555555555ULL;
+    case 4:
+        mask &= mask >> 1;
+        return mask & (mask >> 2) & 0x1111111111111111ULL;
+    default:
+        mask &= mask >> 1;
+        mask &= mask >> 2;
+        return mask & (mask >> 4) & 0x0101010101010101ULL;
+    }
+}
+#endif
+
+static uint64_t _soa_scan_(Soa_t *self, uint32_t field, const void *value, uint64_t from, uint64_t *rows, uint64_t limit)
+{
+    // matches of rows [from, size) up to limit, stored in rows unless it is NULL
+    assert(self != NULL && field < self->nfields && value != NULL);
+    const uint32_t size = self->fields[field].size;
+    const uint8_t *column = self->column[field];
+    uint64_t ret = 0;
+    uint64_t r = from;
+
+#ifdef __SSE2__
+    if (size == 1 || size == 2 || size == 4 || size == 8)
+    {
+        uint8_t pattern[16];
+        for (uint32_t i = 0; i < 16; i += size)
+            memcpy(pattern + i, value, size);
+        const __m128i pat = _mm_loadu_si128((const __m128i *)pattern);
+        const uint32_t step = 64 / size; // rows per round
+        for (; r + step <= self->size && ret < limit; r += step)
+        {
+            const uint8_t *ptr = column + r * size;
+            uint64_t mask = (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)ptr), pat)) |
+                            (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + 16)), pat)) << 16 |
+                            (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + 32)), pat)) << 32 |
+                            (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + 48)), pat)) << 48;
+            mask = _soa_fold_(mask, size);
+            if (mask == 0)
+                continue;
+            if (rows == NULL && limit == UINT64_MAX)
+            {
+                ret += __builtin_popcountll(mask);
+                continue;
+            }
+            for (; mask != 0 && ret < limit; mask &= mask - 1)
+            {
+                if (rows != NULL)
+                    rows[ret] = r + __builtin_ctzll(mask) / size;
+                ret++;
+            }
+        }
+    }
+#endif
+    for (; r < self->size && ret < limit; r++)
+        if (_soa_equal_(column + r * size, (const uint8_t *)value, size))
+        {
+            if (rows != NULL)
+                rows[ret] = r;
+            ret++;
+        }
+    return ret;
+}
+
+int64_t soa_find(Soa_t *self, uint32_t field, const void *value, uint64_t from)
+{
+    uint64_t row;
+    return _soa_scan_(self, field, value, from, &row, 1) ? (int64_t)row : -1;
+}
+
+uint64_t soa_count(Soa_t *self, uint32_t field, const void *value)
+{
+    return _soa_scan_(self, field, value, 0, NULL, UINT64_MAX);
+}
+
+uint64_t soa_filter(Soa_t *self, uint32_t field, const void *value, uint64_t *rows)
+{
+    assert(rows != NULL);
+    return _soa_scan_(self, field, value, 0, rows, UINT64_MAX);
+}
@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "list.h"
+
+#pragma once
+
+/*
+ * Strcture
+ * Records of dsize bytes stored column by column: the record layout is a
+ * list of (offset, size) fields and every field lives in a contiguous column
+ * of its own, row i of each column belongs to record i. A search on one
+ * field reads that column only, 16 bytes per SSE2 compare for fields of 1,
+ * 2, 4 or 8 bytes, instead of walking whole records. Bytes of a record which
+ * no field covers are not kept and read back as zero.
+ *
+ * Columns start at CCTR_SOA_ALIGN byte boundaries and grow together, appends
+ * and erases move every column the same way.
+ */
+#define CCTR_SOA_ALIGN 64
+
+typedef struct
+{
+    uint32_t offset; // in the record
+    uint32_t size;
+} Soa_Field_t;
+
+typedef struct
+{
+    uint8_t **column; // nfields columns of capacity rows
+    Soa_Field_t *fields;
+    uint32_t nfields;
+    uint32_t dsize; // record size
+    uint32_t gaps;  // bytes of a record outside every field
+    uint64_t size;  // rows
+    uint64_t capacity;
+} Soa_t;
+
+/*
+ * Construct & Desctruct
+ * the fields must not overlap and lie inside dsize, they are copied.
+ * soa_from_list turns a List_t of records into columns.
+ */
+Soa_t *soa_construct(uint32_t dsize, const Soa_Field_t *fields, uint32_t nfields);
+Soa_t *soa_from_list(List_t *list, const Soa_Field_t *fields, uint32_t nfields);
+void soa_clear(Soa_t *self);
+void soa_destroy(Soa_t *self);
+void soa_reserve(Soa_t *self, uint64_t capacity);
+
+/*
+ * Basic Usage
+ * records go in and out as dsize byte buffers. soa_column returns the column
+ * of field, soa_field the value of field in row pos.
+ */
+void soa_push_back(Soa_t *self, const void *record);
+void soa_push_back_n(Soa_t *self, const void *array, uint64_t n);
+void soa_pop_back(Soa_t *self);
+void soa_set(Soa_t *self, uint64_t pos, const void *record);
+void soa_gather(Soa_t *self, uint64_t pos, void *record);
+void soa_erase(Soa_t *self, uint64_t pos);
+void soa_erase_range(Soa_t *self, uint64_t from, uint64_t to);
+
+static inline void *soa_column(Soa_t *self, uint32_t field)
+{
+    return self->column[field];
+}
+
+static inline void *soa_field(Soa_t *self, uint32_t field, uint64_t pos)
+{
+    return self->column[field] + pos * self->fields[field].size;
+}
+
+/*
+ * Searching, on one field, value has the size of the field
+ * soa_find returns the first row >= from whose field equals value, -1 when
+ * there is none. soa_filter stores the matching rows in ascending order in
+ * rows, which has room for all of them, and returns their number.
+ */
+int64_t soa_find(Soa_t *self, uint32_t field, const void *value, uint64_t from);
+uint64_t soa_count(Soa_t *self, uint32_t field, const void *value);
+uint64_t soa_filter(Soa_t *self, uint32_t field, const void *value, uint64_t *rows);
@@ -0,0 +1,491 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include "sort.h"
+
+#define _SORT_INSERTION_ 16 // runs are insertion sorted in blocks of this many first
+#define _SORT_RADIX_ 256
+
+typedef struct
+{
+    uint8_t *data; // caller's elements, the result ends up here
+    uint8_t *src;  // elements of the current pass
+    uint8_t *dst;  // output of the current pass
+    uint64_t size;
+    uint32_t esize;
+    uint32_t nthreads;
+    int indirect; // elements are List_Node_t *, compared through their data
+    int packed;   // elements are _Sort_Pair_t_, radix digits come from the loaded key
+
+    Cctr_Cmp_t cmp;
+    void *ctx;
+
+    uint32_t offset; // radix key
+    uint32_t ksize;
+    uint32_t flags;
+    uint32_t byte;
+    uint64_t *hist; // nruns * _SORT_RADIX_ counts, then scatter offsets
+
+    uint64_t *bounds; // run i is [bounds[i], bounds[i + 1])
+    uint32_t nruns;
+    uint32_t pieces; // merge tasks per pair of runs
+} _Sort_t_;
+
+/*
+ * A list is radix sorted as (key, node) pairs so the key is read from the
+ * payload once rather than once per pass
+ */
+typedef struct
+{
+    uint64_t key; // digits in order of significance, sign bit already flipped
+    List_Node_t *node;
+} _Sort_Pair_t_;
+
+/*
+ * Elements
+ */
+static inline const void *_sort_data_(_Sort_t_ *s, const uint8_t *elem)
+{
+    return s->indirect ? (*(List_Node_t *const *)elem)->data : elem;
+}
+
+static inline int _sort_cmp_(_Sort_t_ *s, const uint8_t *a, const uint8_t *b)
+{
+    return s->cmp(_sort_data_(s, a), _sort_data_(s, b), s->ctx);
+}
+
+static inline void _sort_copy_(uint8_t *dst, const uint8_t *src, uint32_t esize)
+{
+    // constant sizes become plain moves
+    switch (esize)
+    {
+    case 4:
+        memcpy(dst, src, 4);
+        break;
+    case 8:
+        memcpy(dst, src, 8);
+        break;
+    case 16:
+        memcpy(dst, src, 16);
+        break;
+    default:
+        memcpy(dst, src, esize);
+        break;
+    }
+}
+
+/*
+ * Merge sort
+ */
+static void _sort_merge_(_Sort_t_ *s, const uint8_t *a, uint64_t na, const uint8_t *b, uint64_t nb, uint8_t *out)
+{
+    uint32_t es = s->esize;
+    const uint8_t *a_end = a + na * es;
+    const uint8_t *b_end = b + nb * es;
+
+    while (a < a_end && b < b_end)
+    {
+        // ties take from a, which keeps the sort stable
+        if (_sort_cmp_(s, b, a) < 0)
+        {
+            _sort_copy_(out, b, es);
+            b += es;
+        }
+        else
+        {
+            _sort_copy_(out, a, es);
+            a += es;
+        }
+        out += es;
+    }
+    memcpy(out, a, a_end - a);
+    memcpy(out + (a_end - a), b, b_end - b);
+}
+
+/*
+ * Number of elements of a among the first d outputs of merging a and b
+ */
+static uint64_t _sort_corank_(_Sort_t_ *s, const uint8_t *a, uint64_t na, const uint8_t *b, uint64_t nb, uint64_t d)
+{
+    uint32_t es = s->esize;
+    uint64_t lo = d > nb ? d - nb : 0;
+    uint64_t hi = d < na ? d : na;
+    while (lo < hi)
+    {
+        uint64_t i = lo + (hi - lo) / 2;
+        uint64_t j = d - i;
+        if (_sort_cmp_(s, b + (j - 1) * es, a + i * es) >= 0)
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+static void _sort_run_(_Sort_t_ *s, uint64_t lo, uint64_t hi, uint8_t *tmp)
+{
+    uint32_t es = s->esize;
+    uint64_t n = hi - lo;
+    uint8_t *base = s->src + lo * es;
+
+    for (uint64_t b = 0; b < n; b += _SORT_INSERTION_)
+    {
+        uint64_t e = b + _SORT_INSERTION_ < n ? b + _SORT_INSERTION_ : n;
+        for (uint64_t i = b + 1; i < e; i++)
+        {
+            if (_sort_cmp_(s, base + (i - 1) * es, base + i * es) <= 0)
+                continue;
+            uint64_t j = i;
+            _sort_copy_(tmp, base + i * es, es);
+            for (; j > b && _sort_cmp_(s, base + (j - 1) * es, tmp) > 0; j--)
+                _sort_copy_(base + j * es, base + (j - 1) * es, es);
+            _sort_copy_(base + j * es, tmp, es);
+        }
+    }
+
+    uint8_t *from = base;
+    uint8_t *to = s->dst + lo * es;
+    for (uint64_t w = _SORT_INSERTION_; w < n; w *= 2)
+    {
+        for (uint64_t l = 0; l < n; l += 2 * w)
+        {
+            uint64_t m = l + w < n ? l + w : n;
+            uint64_t r = l + 2 * w < n ? l + 2 * w : n;
+            _sort_merge_(s, from + l * es, m - l, from + m * es, r - m, to + l * es);
+        }
+        uint8_t *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != base)
+        memcpy(base, from, n * es);
+}
+
+static void _sort_run_task_(void *ctx, uint32_t run)
+{
+    _Sort_t_ *s = (_Sort_t_ *)ctx;
+    uint8_t *tmp = (uint8_t *)malloc(s->esize);
+    assert(tmp != NULL);
+    _sort_run_(s, s->bounds[run], s->bounds[run + 1], tmp);
+    free(tmp);
+}
+
+static void _sort_merge_task_(void *ctx, uint32_t task)
+{
+    _Sort_t_ *s = (_Sort_t_ *)ctx;
+    uint32_t es = s->esize;
+    uint32_t pair = task / s->pieces;
+    uint32_t piece = task % s->pieces;
+
+    // a lone last run has an empty partner and is copied over
+    uint64_t lo = s->bounds[2 * pair];
+    uint64_t mid = s->bounds[2 * pair + 1 < s->nruns ? 2 * pair + 1 : s->nruns];
+    uint64_t hi = s->bounds[2 * pair + 2 < s->nruns ? 2 * pair + 2 : s->nruns];
+    const uint8_t *a = s->src + lo * es;
+    const uint8_t *b = s->src + mid * es;
+    uint64_t na = mid - lo;
+    uint64_t nb = hi - mid;
+
+    // every piece writes its own slice of the output, split along the merge path
+    uint64_t d0 = (hi - lo) * piece / s->pieces;
+    uint64_t d1 = (hi - lo) * (piece + 1) / s->pieces;
+    uint64_t i0 = _sort_corank_(s, a, na, b, nb, d0);
+    uint64_t i1 = _sort_corank_(s, a, na, b, nb, d1);
+    _sort_merge_(s, a + i0 * es, i1 - i0, b + (d0 - i0) * es, (d1 - i1) - (d0 - i0), s->dst + (lo + d0) * es);
+}
+
+static void _sort_merge_sort_(_Sort_t_ *s, Cctr_Pool_t *pool)
+{
+    assert(s->cmp != NULL);
+    cctr_pool_run(pool, s->nruns, _sort_run_task_, s);
+
+    while (s->nruns > 1)
+    {
+        uint32_t pairs = (s->nruns + 1) / 2;
+        s->pieces = s->nthreads / pairs > 1 ? s->nthreads / pairs : 1;
+        cctr_pool_run(pool, pairs * s->pieces, _sort_merge_task_, s);
+
+        for (uint32_t k = 0; k < pairs; k++)
+            s->bounds[k] = s->bounds[2 * k];
+        s->bounds[pairs] = s->size;
+        s->nruns = pairs;
+
+        uint8_t *swap = s->src;
+        s->src = s->dst;
+        s->dst = swap;
+    }
+}
+
+/*
+ * Radix sort
+ */
+static inline uint32_t _sort_digit_(_Sort_t_ *s, const uint8_t *elem)
+{
+    if (s->packed)
+        return (uint32_t)(((const _Sort_Pair_t_ *)elem)->key >> (8 * s->byte)) & 0xff;
+
+    const uint8_t *key = (const uint8_t *)_sort_data_(s, elem) + s->offset;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint32_t ret = key[s->ksize - 1 - s->byte];
+#else
+    uint32_t ret = key[s->byte];
+#endif
+    // the sign bit flipped orders negative keys first
+    if ((s->flags & CCTR_SORT_SIGNED) && s->byte == s->ksize - 1)
+        ret ^= 0x80;
+    return ret;
+}
+
+static void _sort_hist_task_(void *ctx, uint32_t run)
+{
+    _Sort_t_ *s = (_Sort_t_ *)ctx;
+    uint64_t *hist = s->hist + (uint64_t)run * _SORT_RADIX_;
+    memset(hist, 0, _SORT_RADIX_ * sizeof(uint64_t));
+
+    uint8_t *end = s->src + s->bounds[run + 1] * s->esize;
+    for (uint8_t *elem = s->src + s->bounds[run] * s->esize; elem < end; elem += s->esize)
+        hist[_sort_digit_(s, elem)]++;
+}
+
+static void _sort_scatter_task_(void *ctx, uint32_t run)
+{
+    _Sort_t_ *s = (_Sort_t_ *)ctx;
+    uint64_t *offset = s->hist + (uint64_t)run * _SORT_RADIX_;
+
+    uint8_t *end = s->src + s->bounds[run + 1] * s->esize;
+    for (uint8_t *elem = s->src + s->bounds[run] * s->esize; elem < end; elem += s->esize)
+        _sort_copy_(s->dst + offset[_sort_digit_(s, elem)]++ * s->esize, elem, s->esize);
+}
+
+static void _sort_radix_(_Sort_t_ *s, Cctr_Pool_t *pool)
+{
+    assert(s->ksize > 0 && s->ksize <= 8);
+    s->hist = (uint64_t *)malloc((uint64_t)s->nruns * _SORT_RADIX_ * sizeof(uint64_t));
+    assert(s->hist != NULL);
+
+    for (s->byte = 0; s->byte < s->ksize; s->byte++)
+    {
+        cctr_pool_run(pool, s->nruns, _sort_hist_task_, s);
+
+        // a pass where one digit holds every key would not move anything
+        int skip = 0;
+        for (uint32_t d = 0; d < _SORT_RADIX_ && !skip; d++)
+        {
+            uint64_t total = 0;
+            for (uint32_t r = 0; r < s->nruns; r++)
+                total += s->hist[(uint64_t)r * _SORT_RADIX_ + d];
+            skip = total == s->size;
+        }
+        if (skip)
+            continue;
+
+        // run r writes digit d after every smaller digit and after runs < r with digit d
+        uint64_t offset = 0;
+        for (uint32_t d = 0; d < _SORT_RADIX_; d++)
+            for (uint32_t r = 0; r < s->nruns; r++)
+            {
+                uint64_t count = s->hist[(uint64_t)r * _SORT_RADIX_ + d];
+                s->hist[(uint64_t)r * _SORT_RADIX_ + d] = offset;
+                offset += count;
+            }
+        cctr_pool_run(pool, s->nruns, _sort_scatter_task_, s);
+
+        uint8_t *swap = s->src;
+        s->src = s->dst;
+        s->dst = swap;
+    }
+    free(s->hist);
+}
+
+/*
+ * Setup
+ */
+static void _sort_init_(_Sort_t_ *s, Cctr_Pool_t *pool, void *data, uint64_t size, uint32_t esize)
+{
+    memset(s, 0, sizeof(_Sort_t_));
+    s->data = s->src = (uint8_t *)data;
+    s->size = size;
+    s->esize = esize;
+    s->dst = (uint8_t *)malloc(size * esize);
+    assert(s->dst != NULL);
+
+    s->nthreads = cctr_pool_concurrency(pool);
+    uint64_t nruns = size / _SORT_INSERTION_;
+    s->nruns = nruns == 0 ? 1 : nruns < s->nthreads ? (uint32_t)nruns : s->nthreads;
+    s->bounds = (uint64_t *)malloc((s->nruns + 1) * sizeof(uint64_t));
+    assert(s->bounds != NULL);
+    for (uint32_t i = 0; i <= s->nruns; i++)
+        s->bounds[i] = size * i / s->nruns;
+}
+
+static void _sort_copy_task_(void *ctx, uint32_t chunk)
+{
+    _Sort_t_ *s = (_Sort_t_ *)ctx;
+    uint64_t lo = s->size * chunk / s->nthreads;
+    uint64_t hi = s->size * (chunk + 1) / s->nthreads;
+    memcpy(s->data + lo * s->esize, s->src + lo * s->esize, (hi - lo) * s->esize);
+}
+
+static void _sort_finish_(_Sort_t_ *s, Cctr_Pool_t *pool)
+{
+    if (s->src != s->data)
+    {
+        cctr_pool_run(pool, s->nthreads, _sort_copy_task_, s);
+        s->dst = s->src;
+    }
+    free(s->dst);
+    free(s->bounds);
+}
+
+/*
+ * List
+ */
+static List_Node_t **_sort_nodes_(List_t *self)
+{
+    List_Node_t **ret = (List_Node_t **)malloc((uint64_t)self->size * sizeof(List_Node_t *));
+    assert(ret != NULL);
+    uint64_t i = 0;
+    for (List_Node_t *node = self->head; node != NULL; node = node->next)
+        ret[i++] = node;
+    return ret;
+}
+
+static _Sort_Pair_t_ *_sort_pairs_(List_t *self, uint32_t offset, uint32_t ksize, uint32_t flags)
+{
+    _Sort_Pair_t_ *ret = (_Sort_Pair_t_ *)malloc((uint64_t)self->size * sizeof(_Sort_Pair_t_));
+    assert(ret != NULL);
+
+    // the digits are read through the same path as the array sort
+    _Sort_t_ s;
+    memset(&s, 0, sizeof(_Sort_t_));
+    s.offset = offset;
+    s.ksize = ksize;
+    s.flags = flags;
+
+    uint64_t i = 0;
+    for (List_Node_t *node = self->head; node != NULL; node = node->next, i++)
+    {
+        ret[i].key = 0;
+        ret[i].node = node;
+        for (s.byte = 0; s.byte < ksize; s.byte++)
+            ret[i].key |= (uint64_t)_sort_digit_(&s, (const uint8_t *)node->data) << (8 * s.byte);
+    }
+    return ret;
+}
+
+static inline List_Node_t *_sort_node_(_Sort_t_ *s, uint64_t i)
+{
+    return s->packed ? ((_Sort_Pair_t_ *)s->data)[i].node : ((List_Node_t **)s->data)[i];
+}
+
+static void _sort_relink_task_(void *ctx, uint32_t chunk)
+{
+    _Sort_t_ *s = (_Sort_t_ *)ctx;
+    uint64_t lo = s->size * chunk / s->nthreads;
+    uint64_t hi = s->size * (chunk + 1) / s->nthreads;
+    for (uint64_t i = lo; i < hi; i++)
+    {
+        List_Node_t *node = _sort_node_(s, i);
+        node->prev = i > 0 ? _sort_node_(s, i - 1) : NULL;
+        node->next = i + 1 < s->size ? _sort_node_(s, i + 1) : NULL;
+    }
+}
+
+static void _sort_list_(List_t *self, Cctr_Pool_t *pool, _Sort_t_ *s)
+{
+    cctr_pool_run(pool, s->nthreads, _sort_relink_task_, s);
+    _list_skip_reset_(self);
+    self->head = _sort_node_(s, 0);
+    self->tail = _sort_node_(s, self->size - 1);
+    free(s->data);
+}
+
+/*
+ * Sort
+ */
+void array_sort(Array_t *self, Cctr_Pool_t *pool, Cctr_Cmp_t cmp, void *ctx)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    if (self->size < 2)
+        return;
+
+    _Sort_t_ s;
+    _sort_init_(&s, pool, self->data, self->size, self->dsize);
+    s.cmp = cmp;
+    s.ctx = ctx;
+    _sort_merge_sort_(&s, pool);
+    _sort_finish_(&s, pool);
+}
+
+void array_sort_key(Array_t *self, Cctr_Pool_t *pool, uint32_t offset, uint32_t ksize, uint32_t flags)
+{
+    assert(self != NULL);
+    assert(!(self->flags & CCTR_ARRAY_READONLY));
+    assert(offset + ksize <= self->dsize);
+    if (self->size < 2)
+        return;
+
+    _Sort_t_ s;
+    _sort_init_(&s, pool, self->data, self->size, self->dsize);
+    s.offset = offset;
+    s.ksize = ksize;
+    s.flags = flags;
+    _sort_radix_(&s, pool);
+    _sort_finish_(&s, pool);
+}
+
+void list_sort(List_t *self, Cctr_Pool_t *pool, Cctr_Cmp_t cmp, void *ctx)
+{
+    assert(self != NULL);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_SORT);
+    if (self->size < 2)
+        return;
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_SORT, self->size);
+
+    _Sort_t_ s;
+    _sort_init_(&s, pool, _sort_nodes_(self), self->size, sizeof(List_Node_t *));
+    s.indirect = 1;
+    s.cmp = cmp;
+    s.ctx = ctx;
+    _sort_merge_sort_(&s, pool);
+    _sort_finish_(&s, pool);
+    _sort_list_(self, pool, &s);
+}
+
+void list_sort_key(List_t *self, Cctr_Pool_t *pool, uint32_t offset, uint32_t ksize, uint32_t flags)
+{
+    assert(self != NULL);
+    assert(offset + ksize <= self->dsize);
+    CCTR_STATS_OP(&self->stats, CCTR_OP_SORT);
+    if (self->size < 2)
+        return;
+    CCTR_STATS_WALK(&self->stats, CCTR_OP_SORT, self->size);
+
+    _Sort_t_ s;
+    _sort_init_(&s, pool, _sort_pairs_(self, offset, ksize, flags), self->size, sizeof(_Sort_Pair_t_));
+    s.packed = 1;
+    s.ksize = ksize;
+    _sort_radix_(&s, pool);
+    _sort_finish_(&s, pool);
+    _sort_list_(self, pool, &s);
+}
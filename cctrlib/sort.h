@@ -0,0 +1,51 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include "list.h"
+#include "array.h"
+#include "pool.h"
+
+#pragma once
+
+/*
+ * Strcture
+ * Stable parallel sorts. The comparison sort sorts one run per thread and
+ * merges the runs pairwise, every merge split over all threads along the
+ * merge path. The key sort is an LSD radix sort on an integer key of ksize
+ * bytes at offset within the element, in native byte order, passes where
+ * every key shares the digit are skipped. A List_t is sorted as an array of
+ * node pointers (or of key and node pairs for the key sort) and relinked, the
+ * payloads stay where they are.
+ */
+typedef int (*Cctr_Cmp_t)(const void *a, const void *b, void *ctx);
+
+#define CCTR_SORT_SIGNED 0x1 // key is a two's complement integer
+
+/*
+ * Sort
+ * pool may be NULL to sort on the caller
+ */
+void array_sort(Array_t *self, Cctr_Pool_t *pool, Cctr_Cmp_t cmp, void *ctx);
+void array_sort_key(Array_t *self, Cctr_Pool_t *pool, uint32_t offset, uint32_t ksize, uint32_t flags);
+void list_sort(List_t *self, Cctr_Pool_t *pool, Cctr_Cmp_t cmp, void *ctx);
+void list_sort_key(List_t *self, Cctr_Pool_t *pool, uint32_t offset, uint32_t ksize, uint32_t flags);
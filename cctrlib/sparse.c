@@ -0,0 +1,214 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <assert.h>
+#include "sparse.h"
+
+#define _SPARSE_SLOTS_ (1u << CCTR_SPARSE_PAGE_BITS)
+#define _SPARSE_PAGES_ (1u << CCTR_SPARSE_TABLE_BITS)
+#define _SPARSE_DIR_(key) ((key) >> (CCTR_SPARSE_PAGE_BITS + CCTR_SPARSE_TABLE_BITS))
+#define _SPARSE_TABLE_(key) (((key) >> CCTR_SPARSE_PAGE_BITS) & (_SPARSE_PAGES_ - 1))
+#define _SPARSE_SLOT_(key) ((key) & (_SPARSE_SLOTS_ - 1))
+
+static inline int _sparse_present_(Sparse_Page_t *page, uint32_t slot)
+{
+    return (page->present[slot >> 6] >> (slot & 63)) & 1;
+}
+
+static void _sparse_free_table_(Sparse_t *self, Sparse_Table_t *table)
+{
+    for (uint32_t i = 0; table->count > 0 && i < _SPARSE_PAGES_; i++)
+        if (table->page[i] != NULL)
+        {
+            free(table->page[i]);
+            table->count--;
+            self->pages--;
+        }
+    free(table);
+}
+
+// ------------------------------------------------------------------
+Sparse_t *sparse_construct(uint32_t dsize)
+{
+    assert(dsize > 0);
+    Sparse_t *ret = (Sparse_t *)calloc(1, sizeof(Sparse_t));
+    assert(ret != NULL);
+    ret->dsize = dsize;
+    return ret;
+}
+
+void sparse_clear(Sparse_t *self)
+{
+    assert(self != NULL);
+    for (uint32_t d = 0; self->size > 0 && d < (1u << CCTR_SPARSE_DIR_BITS); d++)
+        if (self->dir[d] != NULL)
+        {
+            _sparse_free_table_(self, self->dir[d]);
+            self->dir[d] = NULL;
+        }
+    self->size = 0;
+}
+
+void sparse_destroy(Sparse_t *self)
+{
+    assert(self != NULL);
+    sparse_clear(self);
+    free(self);
+}
+
+void *sparse_set(Sparse_t *self, uint32_t key, const void *data)
+{
+    assert(self != NULL);
+    Sparse_Table_t **table = &self->dir[_SPARSE_DIR_(key)];
+    if (*table == NULL)
+    {
+        *table = (Sparse_Table_t *)calloc(1, sizeof(Sparse_Table_t));
+        assert(*table != NULL);
+    }
+    Sparse_Page_t **page = &(*table)->page[_SPARSE_TABLE_(key)];
+    if (*page == NULL)
+    {
+        // the values are left uninitialized, only the bitmap is cleared
+        *page = (Sparse_Page_t *)malloc(sizeof(Sparse_Page_t) + (uint64_t)_SPARSE_SLOTS_ * self->dsize);
+        assert(*page != NULL);
+        memset(*page, 0, sizeof(Sparse_Page_t));
+        (*table)->count++;
+        self->pages++;
+    }
+
+    uint32_t slot = _SPARSE_SLOT_(key);
+    if (!_sparse_present_(*page, slot))
+    {
+        (*page)->present[slot >> 6] |= 1ULL << (slot & 63);
+        (*page)->count++;
+        self->size++;
+    }
+    uint8_t *ret = (*page)->data + (uint64_t)slot * self->dsize;
+    if (data != NULL)
+        memcpy(ret, data, self->dsize);
+    else
+        memset(ret, 0, self->dsize);
+    return ret;
+}
+
+void *sparse_get(Sparse_t *self, uint32_t key)
+{
+    assert(self != NULL);
+    Sparse_Table_t *table = self->dir[_SPARSE_DIR_(key)];
+    if (table == NULL)
+        return NULL;
+    Sparse_Page_t *page = table->page[_SPARSE_TABLE_(key)];
+    uint32_t slot = _SPARSE_SLOT_(key);
+    if (page == NULL || !_sparse_present_(page, slot))
+        return NULL;
+    return page->data + (uint64_t)slot * self->dsize;
+}
+
+int sparse_contains(Sparse_t *self, uint32_t key)
+{
+    return sparse_get(self, key) != NULL;
+}
+
+int sparse_erase(Sparse_t *self, uint32_t key)
+{
+    assert(self != NULL);
+    Sparse_Table_t **table = &self->dir[_SPARSE_DIR_(key)];
+    if (*table == NULL)
+        return 0;
+    Sparse_Page_t **page = &(*table)->page[_SPARSE_TABLE_(key)];
+    uint32_t slot = _SPARSE_SLOT_(key);
+    if (*page == NULL || !_sparse_present_(*page, slot))
+        return 0;
+
+    (*page)->present[slot >> 6] &= ~(1ULL << (slot & 63));
+    self->size--;
+    if (--(*page)->count == 0)
+    {
+        free(*page);
+        *page = NULL;
+        self->pages--;
+        if (--(*table)->count == 0)
+        {
+            free(*table);
+            *table = NULL;
+        }
+    }
+    return 1;
+}
+
+void *sparse_next(Sparse_t *self, uint64_t *key)
+{
+    assert(self != NULL && key != NULL);
+    uint64_t k = *key;
+    while (k <= UINT32_MAX)
+    {
+        Sparse_Table_t *table = self->dir[_SPARSE_DIR_(k)];
+        if (table == NULL)
+        {
+            k = (_SPARSE_DIR_(k) + 1) << (CCTR_SPARSE_PAGE_BITS + CCTR_SPARSE_TABLE_BITS);
+            continue;
+        }
+        Sparse_Page_t *page = table->page[_SPARSE_TABLE_(k)];
+        uint64_t base = k & ~(uint64_t)(_SPARSE_SLOTS_ - 1);
+        if (page != NULL)
+        {
+            uint32_t slot = _SPARSE_SLOT_(k);
+            uint32_t w = slot >> 6;
+            uint64_t bits = page->present[w] & (~0ULL << (slot & 63));
+            while (bits == 0 && ++w < _SPARSE_SLOTS_ / 64)
+                bits = page->present[w];
+            if (bits != 0)
+            {
+                slot = w * 64 + (uint32_t)__builtin_ctzll(bits);
+                *key = base + slot;
+                return page->data + (uint64_t)slot * self->dsize;
+            }
+        }
+        k = base + _SPARSE_SLOTS_;
+    }
+    return NULL;
+}
+
+uint64_t sparse_for_each(Sparse_t *self, void (*fn)(uint32_t key, void *data, void *ctx), void *ctx)
+{
+    assert(self != NULL && fn != NULL);
+    uint64_t ret = 0;
+    for (uint32_t d = 0; ret < self->size && d < (1u << CCTR_SPARSE_DIR_BITS); d++)
+    {
+        Sparse_Table_t *table = self->dir[d];
+        for (uint32_t t = 0; table != NULL && t < _SPARSE_PAGES_; t++)
+        {
+            Sparse_Page_t *page = table->page[t];
+            if (page == NULL)
+                continue;
+            uint32_t base = (d << (CCTR_SPARSE_PAGE_BITS + CCTR_SPARSE_TABLE_BITS)) | (t << CCTR_SPARSE_PAGE_BITS);
+            for (uint32_t w = 0; w < _SPARSE_SLOTS_ / 64; w++)
+                for (uint64_t bits = page->present[w]; bits != 0; bits &= bits - 1)
+                {
+                    uint32_t slot = w * 64 + (uint32_t)__builtin_ctzll(bits);
+                    fn(base + slot, page->data + (uint64_t)slot * self->dsize, ctx);
+                    ret++;
+                }
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Values of dsize bytes addressed by a 32 bit key, for key spaces of which
+ * only a few slots are used. The key is split into a directory index, a table
+ * index and a slot in a page, like a page table: tables and pages are
+ * allocated when the first key in them is set and freed again when the last
+ * one is erased. A page keeps its values inline next to a bitmap of the used
+ * slots, which iteration scans a word at a time.
+ */
+#define CCTR_SPARSE_PAGE_BITS 10  // slots per page
+#define CCTR_SPARSE_TABLE_BITS 10 // pages per table
+#define CCTR_SPARSE_DIR_BITS (32 - CCTR_SPARSE_PAGE_BITS - CCTR_SPARSE_TABLE_BITS)
+
+typedef struct
+{
+    uint32_t count; // used slots
+    uint32_t reserved;
+    uint64_t present[(1 << CCTR_SPARSE_PAGE_BITS) / 64];
+    uint8_t data[]; // 1 << CCTR_SPARSE_PAGE_BITS values
+} Sparse_Page_t;
+
+typedef struct
+{
+    uint32_t count; // pages
+    Sparse_Page_t *page[1 << CCTR_SPARSE_TABLE_BITS];
+} Sparse_Table_t;
+
+typedef struct
+{
+    uint64_t size;
+    uint64_t pages;
+    uint32_t dsize;
+    Sparse_Table_t *dir[1 << CCTR_SPARSE_DIR_BITS];
+} Sparse_t;
+
+/*
+ * Construct & Desctruct
+ */
+Sparse_t *sparse_construct(uint32_t dsize);
+void sparse_clear(Sparse_t *self);
+void sparse_destroy(Sparse_t *self);
+
+/*
+ * Basic Usage, O(1)
+ * sparse_set copies data into the slot of key, a NULL data zeroes it, and
+ * returns the slot. sparse_get returns the slot of key or NULL when unset.
+ * sparse_erase returns 1 when key was set.
+ */
+void *sparse_set(Sparse_t *self, uint32_t key, const void *data);
+void *sparse_get(Sparse_t *self, uint32_t key);
+int sparse_contains(Sparse_t *self, uint32_t key);
+int sparse_erase(Sparse_t *self, uint32_t key);
+
+/*
+ * Iteration, in key order over the set keys only
+ * sparse_next returns the slot of the first set key >= *key and stores the
+ * key in *key, NULL when there is none:
+ *     for (uint64_t key = 0; (data = sparse_next(self, &key)) != NULL; key++)
+ * sparse_for_each returns the number of keys visited, fn must not set or
+ * erase keys.
+ */
+void *sparse_next(Sparse_t *self, uint64_t *key);
+uint64_t sparse_for_each(Sparse_t *self, void (*fn)(uint32_t key, void *data, void *ctx), void *ctx);
@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <pthread.h>
+#include <string.h>
+#include "reclaim.h"
+#include "stats.h"
+
+#ifdef CCTR_STATS
+
+static pthread_mutex_t _cctr_stats_lock_ = PTHREAD_MUTEX_INITIALIZER;
+static Cctr_Stats_t *_cctr_stats_head_ = NULL;
+
+static const char *_cctr_op_names_[CCTR_OP_COUNT] = {
+    "push_front",
+    "push_back",
+    "pop_front",
+    "pop_back",
+    "at",
+    "border",
+    "insert",
+    "erase",
+    "insert_list",
+    "copy",
+    "clear",
+    "find",
+    "remove",
+    "sort",
+    "compact",
+    "hash",
+    "compare",
+};
+
+const char *cctr_op_name(Cctr_Op_t op)
+{
+    return op < CCTR_OP_COUNT ? _cctr_op_names_[op] : "?";
+}
+
+void cctr_stats_register(Cctr_Stats_t *self, const char *type, const void *owner)
+{
+    memset(self, 0, sizeof(Cctr_Stats_t));
+    self->type = type;
+    self->owner = owner;
+
+    pthread_mutex_lock(&_cctr_stats_lock_);
+    self->next = _cctr_stats_head_;
+    if (_cctr_stats_head_ != NULL)
+        _cctr_stats_head_->prev = self;
+    _cctr_stats_head_ = self;
+    pthread_mutex_unlock(&_cctr_stats_lock_);
+}
+
+void cctr_stats_unregister(Cctr_Stats_t *self)
+{
+    pthread_mutex_lock(&_cctr_stats_lock_);
+    if (self->prev != NULL)
+        self->prev->next = self->next;
+    else if (_cctr_stats_head_ == self)
+        _cctr_stats_head_ = self->next;
+    if (self->next != NULL)
+        self->next->prev = self->prev;
+    self->prev = NULL;
+    self->next = NULL;
+    pthread_mutex_unlock(&_cctr_stats_lock_);
+}
+
+void cctr_stats_snapshot(const Cctr_Stats_t *self, Cctr_Stats_t *snapshot)
+{
+    *snapshot = *self;
+    snapshot->prev = NULL;
+    snapshot->next = NULL;
+}
+
+void cctr_stats_foreach(void (*fn)(const Cctr_Stats_t *stats, void *ctx), void *ctx)
+{
+    // containers must not be destroyed from fn, the registry is locked meanwhile
+    pthread_mutex_lock(&_cctr_stats_lock_);
+    for (Cctr_Stats_t *ptr = _cctr_stats_head_; ptr != NULL; ptr = ptr->next)
+    {
+        Cctr_Stats_t snapshot;
+        cctr_stats_snapshot(ptr, &snapshot);
+        fn(&snapshot, ctx);
+    }
+    pthread_mutex_unlock(&_cctr_stats_lock_);
+}
+
+void cctr_stats_print(const Cctr_Stats_t *self, FILE *out)
+{
+    fprintf(out, "%s %s@%p size_peak=%llu allocs=%llu frees=%llu bytes_live=%lld bytes_peak=%lld\n",
+            self->type, self->name != NULL ? self->name : "", self->owner,
+            (unsigned long long)self->size_peak, (unsigned long long)self->allocs,
+            (unsigned long long)self->frees, (long long)self->bytes_live, (long long)self->bytes_peak);
+    if (self->hops != 0)
+        fprintf(out, "  hops=%llu far=%llu (%.1f%%)\n", (unsigned long long)self->hops,
+                (unsigned long long)self->hops_far, 100.0 * (double)self->hops_far / (double)self->hops);
+
+    for (int op = 0; op < CCTR_OP_COUNT; op++)
+    {
+        if (self->ops[op] == 0)
+            continue;
+        fprintf(out, "  %-12s calls=%llu", cctr_op_name((Cctr_Op_t)op), (unsigned long long)self->ops[op]);
+        if (self->walked[op] != 0)
+            fprintf(out, " walked=%llu (%.1f/call)", (unsigned long long)self->walked[op],
+                    (double)self->walked[op] / (double)self->ops[op]);
+        fprintf(out, "\n");
+    }
+}
+
+static void _cctr_stats_print_(const Cctr_Stats_t *stats, void *ctx)
+{
+    cctr_stats_print(stats, (FILE *)ctx);
+}
+
+void cctr_stats_dump(FILE *out)
+{
+    cctr_stats_foreach(_cctr_stats_print_, out);
+    Cctr_Reclaim_Stats_t reclaim;
+    cctr_reclaim_stats(&reclaim);
+    if (reclaim.deferred != 0)
+        fprintf(out, "reclaim depth=%llu peak=%llu deferred=%llu reclaimed=%llu\n", (unsigned long long)reclaim.depth,
+                (unsigned long long)reclaim.peak, (unsigned long long)reclaim.deferred,
+                (unsigned long long)reclaim.reclaimed);
+    fflush(out);
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * Opt-in container instrumentation, compiled in with -DCCTR_STATS (make STATS=1).
+ * Without it every CCTR_STATS_* macro expands to nothing and the containers
+ * carry no extra member.
+ *
+ * Each instrumented container embeds a Cctr_Stats_t which registers itself in
+ * a global registry on construction. Counters are updated without locking, the
+ * same as the container itself, a dump from another thread reads them as they are.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#pragma once
+
+typedef enum
+{
+    CCTR_OP_PUSH_FRONT,
+    CCTR_OP_PUSH_BACK,
+    CCTR_OP_POP_FRONT,
+    CCTR_OP_POP_BACK,
+    CCTR_OP_AT,
+    CCTR_OP_BORDER,
+    CCTR_OP_INSERT,
+    CCTR_OP_ERASE,
+    CCTR_OP_INSERT_LIST,
+    CCTR_OP_COPY,
+    CCTR_OP_CLEAR,
+    CCTR_OP_FIND,
+    CCTR_OP_REMOVE,
+    CCTR_OP_SORT,
+    CCTR_OP_COMPACT,
+    CCTR_OP_HASH,
+    CCTR_OP_COMPARE,
+    CCTR_OP_COUNT
+} Cctr_Op_t;
+
+typedef struct Cctr_Stats_t
+{
+    const char *type;  // container type, e.g. "List_t"
+    const char *name;  // optional user label
+    const void *owner; // container address
+
+    uint64_t allocs;
+    uint64_t frees;
+    int64_t bytes_live;
+    int64_t bytes_peak;
+    uint64_t size_peak;
+
+    uint64_t ops[CCTR_OP_COUNT];
+    uint64_t walked[CCTR_OP_COUNT]; // nodes traversed by the op
+
+    // node to node steps of list_find since the last compaction, far ones land
+    // more than CCTR_STATS_FAR bytes away and likely miss the cache and the TLB
+    uint64_t hops;
+    uint64_t hops_far;
+
+    struct Cctr_Stats_t *prev; // registry
+    struct Cctr_Stats_t *next;
+} Cctr_Stats_t;
+
+#ifdef CCTR_STATS
+
+/*
+ * Registry
+ * cctr_stats_dump prints every live container and, once anything was
+ * deferred, the reclaim queue (reclaim.h)
+ */
+void cctr_stats_register(Cctr_Stats_t *self, const char *type, const void *owner);
+void cctr_stats_unregister(Cctr_Stats_t *self);
+void cctr_stats_snapshot(const Cctr_Stats_t *self, Cctr_Stats_t *snapshot);
+void cctr_stats_foreach(void (*fn)(const Cctr_Stats_t *stats, void *ctx), void *ctx);
+void cctr_stats_print(const Cctr_Stats_t *self, FILE *out);
+void cctr_stats_dump(FILE *out);
+const char *cctr_op_name(Cctr_Op_t op);
+
+/*
+ * Hooks
+ */
+#define CCTR_STATS_OP(stats, op) ((stats)->ops[op]++)
+#define CCTR_STATS_WALK(stats, op, nodes) ((stats)->walked[op] += (uint64_t)(nodes))
+#define CCTR_STATS_ALLOC(stats, count, bytes)                \
+    do                                                       \
+    {                                                        \
+        (stats)->allocs += (count);                          \
+        (stats)->bytes_live += (int64_t)(bytes);             \
+        if ((stats)->bytes_live > (stats)->bytes_peak)       \
+            (stats)->bytes_peak = (stats)->bytes_live;       \
+    } while (0)
+#define CCTR_STATS_FREE(stats, count, bytes)     \
+    do                                           \
+    {                                            \
+        (stats)->frees += (count);               \
+        (stats)->bytes_live -= (int64_t)(bytes); \
+    } while (0)
+#define CCTR_STATS_FAR 4096
+#define CCTR_STATS_HOP(stats, from, to)                         \
+    do                                                          \
+    {                                                           \
+        uintptr_t _a_ = (uintptr_t)(from);                      \
+        uintptr_t _b_ = (uintptr_t)(to);                        \
+        uintptr_t _d_ = _a_ > _b_ ? _a_ - _b_ : _b_ - _a_;      \
+        if (_a_ != 0 && _b_ != 0)                               \
+        {                                                       \
+            (stats)->hops++;                                    \
+            (stats)->hops_far += _d_ > CCTR_STATS_FAR;          \
+        }                                                       \
+    } while (0)
+#define CCTR_STATS_SIZE(stats, size)             \
+    do                                           \
+    {                                            \
+        if ((uint64_t)(size) > (stats)->size_peak) \
+            (stats)->size_peak = (size);         \
+    } while (0)
+
+#else
+
+#define CCTR_STATS_OP(stats, op) ((void)0)
+#define CCTR_STATS_WALK(stats, op, nodes) ((void)0)
+#define CCTR_STATS_ALLOC(stats, count, bytes) ((void)0)
+#define CCTR_STATS_FREE(stats, count, bytes) ((void)0)
+#define CCTR_STATS_HOP(stats, from, to) ((void)0)
+#define CCTR_STATS_SIZE(stats, size) ((void)0)
+
+#endif
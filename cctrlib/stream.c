@@ -0,0 +1,243 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "serialize.h"
+#include "stream.h"
+
+static int _stream_pwrite_(int fd, const void *buf, uint64_t len, uint64_t offset)
+{
+    const uint8_t *ptr = (const uint8_t *)buf;
+    while (len > 0)
+    {
+        ssize_t ret = pwrite(fd, ptr, len, (off_t)offset);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        ptr += ret;
+        len -= (uint64_t)ret;
+        offset += (uint64_t)ret;
+    }
+    return 0;
+}
+
+static int _stream_pread_(int fd, void *buf, uint64_t len, uint64_t offset)
+{
+    uint8_t *ptr = (uint8_t *)buf;
+    while (len > 0)
+    {
+        ssize_t ret = pread(fd, ptr, len, (off_t)offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+        {
+            if (ret == 0)
+                errno = EIO;
+            return -1;
+        }
+        ptr += ret;
+        len -= (uint64_t)ret;
+        offset += (uint64_t)ret;
+    }
+    return 0;
+}
+
+static int _stream_write_header_(Stream_t *self)
+{
+    Cctr_File_Header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CCTR_FILE_MAGIC;
+    header.version = CCTR_FILE_VERSION;
+    header.kind = CCTR_FILE_ARRAY;
+    header.endian = CCTR_FILE_ENDIAN;
+    header.dsize = self->dsize;
+    header.count = self->flushed;
+    header.header_size = sizeof(Cctr_File_Header_t);
+    return _stream_pwrite_(self->fd, &header, sizeof(header), 0);
+}
+
+static inline uint64_t _stream_offset_(Stream_t *self, uint64_t pos)
+{
+    return sizeof(Cctr_File_Header_t) + pos * self->dsize;
+}
+
+// ------------------------------------------------------------------
+Stream_t *stream_construct(uint32_t dsize, uint32_t chunk_len, const char *path)
+{
+    assert(dsize > 0);
+    assert(chunk_len > 0);
+
+    int fd;
+    if (path != NULL)
+        fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    else
+    {
+        char tmp[] = "/tmp/cctr_stream_XXXXXX";
+        fd = mkstemp(tmp);
+        if (fd >= 0)
+            unlink(tmp);
+    }
+    if (fd < 0)
+        return NULL;
+
+    Stream_t *ret = (Stream_t *)calloc(1, sizeof(Stream_t));
+    assert(ret != NULL);
+    ret->fd = fd;
+    ret->dsize = dsize;
+    ret->chunk_len = chunk_len;
+    ret->tail = (uint8_t *)malloc((uint64_t)chunk_len * dsize);
+    assert(ret->tail != NULL);
+
+    if (_stream_write_header_(ret) < 0)
+    {
+        stream_destroy(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+void stream_destroy(Stream_t *self)
+{
+    // records still in the tail are not written, call stream_flush first to keep them
+    assert(self != NULL);
+    close(self->fd);
+    free(self->tail);
+    free(self);
+}
+
+int stream_flush(Stream_t *self)
+{
+    assert(self != NULL);
+    uint64_t pending = self->size - self->flushed;
+    if (pending == 0)
+        return 0;
+
+    if (_stream_pwrite_(self->fd, self->tail, pending * self->dsize, _stream_offset_(self, self->flushed)) < 0)
+        return -1;
+    self->flushed = self->size;
+    return _stream_write_header_(self);
+}
+
+int stream_push_back(Stream_t *self, void *data)
+{
+    assert(self != NULL);
+    assert(data != NULL);
+
+    if (self->size - self->flushed == self->chunk_len && stream_flush(self) < 0)
+        return -1;
+
+    memcpy(self->tail + (self->size - self->flushed) * self->dsize, data, self->dsize);
+    self->size++;
+    return 0;
+}
+
+int stream_at(Stream_t *self, uint64_t pos, void *out)
+{
+    assert(self != NULL);
+    if (pos >= self->size)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+    if (pos >= self->flushed)
+    {
+        memcpy(out, self->tail + (pos - self->flushed) * self->dsize, self->dsize);
+        return 0;
+    }
+    return _stream_pread_(self->fd, out, self->dsize, _stream_offset_(self, pos));
+}
+
+// ------------------------------------------------------------------
+void stream_iter_begin(Stream_t *self, Stream_Iter_t *iter, uint64_t pos)
+{
+    assert(self != NULL);
+    assert(iter != NULL);
+    iter->stream = self;
+    iter->pos = pos;
+    iter->begin = pos;
+    iter->count = 0;
+    iter->buf = (uint8_t *)malloc((uint64_t)self->chunk_len * self->dsize);
+    assert(iter->buf != NULL);
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(self->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+void *stream_iter_next(Stream_Iter_t *iter)
+{
+    // NULL at the end or on a read error (errno set)
+    Stream_t *self = iter->stream;
+    if (iter->pos >= self->size)
+        return NULL;
+
+    if (iter->pos >= self->flushed)
+        return self->tail + (iter->pos++ - self->flushed) * self->dsize;
+
+    if (iter->pos >= iter->begin + iter->count || iter->pos < iter->begin)
+    {
+        // read ahead one chunk
+        uint64_t n = self->flushed - iter->pos;
+        if (n > self->chunk_len)
+            n = self->chunk_len;
+        if (_stream_pread_(self->fd, iter->buf, n * self->dsize, _stream_offset_(self, iter->pos)) < 0)
+            return NULL;
+        iter->begin = iter->pos;
+        iter->count = n;
+    }
+    return iter->buf + (iter->pos++ - iter->begin) * self->dsize;
+}
+
+void stream_iter_end(Stream_Iter_t *iter)
+{
+    free(iter->buf);
+    iter->buf = NULL;
+}
+
+// ---------------------------------------------------------------------------------------
+int64_t stream_find_data_range(Stream_t *self, void *data, uint32_t offset, uint32_t dsize)
+{
+    assert(self != NULL);
+    if ((offset + dsize) > self->dsize)
+        return -1;
+
+    Stream_Iter_t iter;
+    stream_iter_begin(self, &iter, 0);
+    int64_t ret = -1;
+    for (uint8_t *ptr; (ptr = (uint8_t *)stream_iter_next(&iter)) != NULL;)
+        if (!memcmp(data, ptr + offset, dsize))
+        {
+            ret = (int64_t)iter.pos - 1;
+            break;
+        }
+    stream_iter_end(&iter);
+    return ret;
+}
+
+int64_t stream_find(Stream_t *self, void *data)
+{
+    return stream_find_data_range(self, data, 0, self->dsize);
+}
@@ -0,0 +1,82 @@
+/*
+Copyright (c) 2022 Yee Yang Tan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#pragma once
+
+/*
+ * Strcture
+ * Append-only sequence which keeps at most chunk_len records in memory. Full
+ * chunks are appended to a container file (serialize.h format, the header
+ * count is updated on every flush), so the file can be read back with
+ * array_map / list_load. Memory use is bounded by the tail plus the read-ahead
+ * buffer of an iterator, whatever the number of records.
+ */
+typedef struct
+{
+    int fd;
+    uint64_t size;    // records in total
+    uint64_t flushed; // records in the file
+    uint32_t dsize;
+    uint32_t chunk_len; // records per chunk
+    uint8_t *tail;      // the size - flushed records not written yet
+} Stream_t;
+
+typedef struct
+{
+    Stream_t *stream;
+    uint64_t pos;   // position of the next record
+    uint64_t begin; // position of buf[0]
+    uint64_t count; // records in buf
+    uint8_t *buf;
+} Stream_Iter_t;
+
+/*
+ * Construct & Desctruct
+ * path == NULL creates an anonymous temporary file, otherwise path is truncated
+ */
+Stream_t *stream_construct(uint32_t dsize, uint32_t chunk_len, const char *path);
+void stream_destroy(Stream_t *self);
+
+/*
+ * Basic Usage, 0 on success and -1 with errno set when the file cannot be written / read
+ */
+int stream_push_back(Stream_t *self, void *data);
+int stream_flush(Stream_t *self);
+int stream_at(Stream_t *self, uint64_t pos, void *out);
+
+/*
+ * Iteration
+ */
+void stream_iter_begin(Stream_t *self, Stream_Iter_t *iter, uint64_t pos);
+void *stream_iter_next(Stream_Iter_t *iter);
+void stream_iter_end(Stream_Iter_t *iter);
+
+/*
+ * Searching, same semantics as list_find_data_range / list_find
+ */
+int64_t stream_find_data_range(Stream_t *self, void *data, uint32_t offset, uint32_t dsize);
+int64_t stream_find(Stream_t *self, void *data);
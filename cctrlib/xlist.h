@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include <assert.h>
 
+#include "block.h"
+
 #pragma once
 
 // ==============================================================
@@ -36,24 +38,58 @@ SOFTWARE.
 typedef struct Xlist_Node_t
 {
     void *data;
-    Xlist_Node_t *diff;
+    struct Xlist_Node_t *diff;  // prev ^ next
+    struct Cctr_Block_t *block; // NULL unless allocated by a batch
 } Xlist_Node_t;
 
-inline Xlist_Node_t *_xlist_node_construct_(void *data, uint32_t dsize)
+static inline Xlist_Node_t *_xlist_node_construct_(void *data, uint32_t dsize)
 {
     assert(data != NULL);
-    Xlist_Node_t *node = (Xlist_Node_t *)malloc(sizeof(Xlist_Node_t));
-    assert(node != NULL);
-    node->data = malloc(dsize);
-    assert(node->data != NULL);
+    void *node_data;
+    Xlist_Node_t *node = (Xlist_Node_t *)cctr_node_alloc(sizeof(Xlist_Node_t), dsize, &node_data);
+    node->data = node_data;
     memcpy(node->data, data, dsize);
+    node->block = NULL;
     return node;
 }
-inline void _xlist_node_destruct_(Xlist_Node_t *self)
+static inline void _xlist_node_destruct_(Xlist_Node_t *self, uint32_t dsize)
 {
     assert(self != NULL);
-    free(self->data);
-    free(self);
+    if (self->block != NULL)
+    {
+        cctr_block_release(self->block);
+        return;
+    }
+    cctr_node_free(self, self->data, dsize);
+}
+static inline Xlist_Node_t *_xlist_xor_ptr_(Xlist_Node_t *a, Xlist_Node_t *b)
+{
+    return (Xlist_Node_t *)((uintptr_t)a ^ (uintptr_t)b);
+}
+static inline Xlist_Node_t *_xlist_node_block_(void *array, uint64_t asize, uint32_t dsize, Xlist_Node_t **last)
+{
+    // links asize nodes carved from one block, in array order, returns the first one
+    // the diff of the first and last node only hold their inner neighbour
+    const uint64_t node_size = CCTR_ALIGN(sizeof(Xlist_Node_t));
+    const uint64_t stride = node_size + CCTR_ALIGN(dsize);
+    Cctr_Block_t *block = cctr_block_construct(asize, stride);
+
+    uint8_t *aptr = (uint8_t *)array;
+    Xlist_Node_t *prev = NULL;
+    Xlist_Node_t *node = NULL;
+    for (uint64_t i = 0; i < asize; i++)
+    {
+        node = (Xlist_Node_t *)cctr_block_at(block, stride, i);
+        Xlist_Node_t *next = i + 1 < asize ? (Xlist_Node_t *)cctr_block_at(block, stride, i + 1) : NULL;
+        node->data = (uint8_t *)node + node_size;
+        memcpy(node->data, aptr, dsize);
+        node->block = block;
+        node->diff = _xlist_xor_ptr_(prev, next);
+        prev = node;
+        aptr += dsize;
+    }
+    *last = node;
+    return (Xlist_Node_t *)cctr_block_at(block, stride, 0);
 }
 
 // ==============================================================
@@ -71,14 +107,14 @@ typedef struct
 /*
  * Construct & Desctruct
  */
-Xlist_t *xlist_construct(uint32_t dsize)
+static inline Xlist_t *xlist_construct(uint32_t dsize)
 {
     Xlist_t *ret = (Xlist_t *)calloc(1, sizeof(Xlist_t));
     assert(ret != NULL);
     ret->dsize = dsize;
     return ret;
 }
-void xlist_clear(Xlist_t *self)
+static inline void xlist_clear(Xlist_t *self)
 {
     assert(self != NULL);
     Xlist_Node_t *ptr = self->head;
@@ -87,38 +123,55 @@ void xlist_clear(Xlist_t *self)
     {
         Xlist_Node_t *next = _xlist_xor_ptr_(prev, ptr->diff);
         if (prev != NULL)
-            _xlist_node_destruct_(prev);
+            _xlist_node_destruct_(prev, self->dsize);
         prev = ptr;
         ptr = next;
     }
     if (prev != NULL)
-        _xlist_node_destruct_(prev);
+        _xlist_node_destruct_(prev, self->dsize);
 
     self->head = NULL;
     self->tail = NULL;
     self->size = 0;
 }
-void xlist_destroy(Xlist_t *self)
+static inline void xlist_destroy(Xlist_t *self)
 {
     xlist_clear(self);
     free(self);
 }
-
-Xlist_t *xlist_copy(Xlist_t *self)
+static inline void xlist_push_back(Xlist_t *self, void *data);
+static inline Xlist_t *xlist_copy(Xlist_t *self)
 {
     assert(self != NULL);
     Xlist_t *xlist = xlist_construct(self->dsize);
-    // ! implement it
+
+    Xlist_Node_t *prev = NULL;
+    for (Xlist_Node_t *ptr = self->head; ptr != NULL;)
+    {
+        xlist_push_back(xlist, ptr->data);
+        Xlist_Node_t *next = _xlist_xor_ptr_(prev, ptr->diff);
+        prev = ptr;
+        ptr = next;
+    }
+    return xlist;
 }
 
 /*
  * Basic Usage
  */
-inline Xlist_Node_t *_xlist_xor_ptr_(Xlist_Node_t *a, Xlist_Node_t *b)
+static inline void *xlist_front(Xlist_t *self)
 {
-    return (Xlist_Node_t *)((uintptr_t)a ^ (uintptr_t)b);
+    assert(self != NULL);
+    assert(self->head != NULL);
+    return self->head->data;
+}
+static inline void *xlist_back(Xlist_t *self)
+{
+    assert(self != NULL);
+    assert(self->tail != NULL);
+    return self->tail->data;
 }
-void xlist_push_front(Xlist_t *self, void *data)
+static inline void xlist_push_front(Xlist_t *self, void *data)
 {
     assert(self != NULL);
     assert(data != NULL);
@@ -135,7 +188,7 @@ void xlist_push_front(Xlist_t *self, void *data)
 
     self->size++;
 }
-void xlist_push_back(Xlist_t *self, void *data)
+static inline void xlist_push_back(Xlist_t *self, void *data)
 {
     assert(self != NULL);
     assert(data != NULL);
@@ -152,7 +205,7 @@ void xlist_push_back(Xlist_t *self, void *data)
 
     self->size++;
 }
-void xlist_pop_front(Xlist_t *self)
+static inline void xlist_pop_front(Xlist_t *self)
 {
     assert(self != NULL);
     if (self->head == NULL || self->size == 0)
@@ -163,13 +216,13 @@ void xlist_pop_front(Xlist_t *self)
     if (self->head != NULL)
         self->head->diff = _xlist_xor_ptr_(rmv, self->head->diff);
 
-    _xlist_node_destruct_(rmv);
+    _xlist_node_destruct_(rmv, self->dsize);
     self->size--;
 
     if (self->size == 0)
         self->tail = NULL;
 }
-void xlist_pop_back(Xlist_t *self)
+static inline void xlist_pop_back(Xlist_t *self)
 {
     assert(self != NULL);
     if (self->tail == NULL || self->size == 0)
@@ -180,9 +233,107 @@ void xlist_pop_back(Xlist_t *self)
     if (self->tail != NULL)
         self->tail->diff = _xlist_xor_ptr_(self->tail->diff, rmv);
 
-    _xlist_node_destruct_(rmv);
+    _xlist_node_destruct_(rmv, self->dsize);
     self->size--;
 
     if (self->size == 0)
         self->head = NULL;
-}
\ No newline at end of file
+}
+
+/*
+ * Batch, the nodes of one call come from one block
+ */
+static inline void xlist_push_front_n(Xlist_t *self, void *array, uint32_t asize)
+{
+    // array[0] becomes the front
+    assert(self != NULL);
+    if (asize == 0)
+        return;
+
+    Xlist_Node_t *last;
+    Xlist_Node_t *first = _xlist_node_block_(array, asize, self->dsize, &last);
+    if (self->head != NULL)
+    {
+        last->diff = _xlist_xor_ptr_(last->diff, self->head);
+        self->head->diff = _xlist_xor_ptr_(last, self->head->diff);
+    }
+    else
+        self->tail = last;
+    self->head = first;
+    self->size += asize;
+}
+static inline void xlist_push_back_n(Xlist_t *self, void *array, uint32_t asize)
+{
+    assert(self != NULL);
+    if (asize == 0)
+        return;
+
+    Xlist_Node_t *last;
+    Xlist_Node_t *first = _xlist_node_block_(array, asize, self->dsize, &last);
+    if (self->tail != NULL)
+    {
+        first->diff = _xlist_xor_ptr_(self->tail, first->diff);
+        self->tail->diff = _xlist_xor_ptr_(self->tail->diff, first);
+    }
+    else
+        self->head = first;
+    self->tail = last;
+    self->size += asize;
+}
+static inline uint32_t _xlist_pop_n_(Xlist_t *self, void *out, uint32_t n, int front)
+{
+    // walks n nodes from one end, copying to out and freeing, then relinks the new end once
+    if (n > self->size)
+        n = self->size;
+    if (n == 0)
+        return 0;
+
+    uint8_t *optr = (uint8_t *)out;
+    if (optr != NULL && !front)
+        optr += (uint64_t)(n - 1) * self->dsize; // from the back, out is still in list order
+
+    Xlist_Node_t *prev = NULL;
+    Xlist_Node_t *ptr = front ? self->head : self->tail;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Xlist_Node_t *next = _xlist_xor_ptr_(prev, ptr->diff);
+        if (optr != NULL)
+        {
+            memcpy(optr, ptr->data, self->dsize);
+            optr = front ? optr + self->dsize : optr - self->dsize;
+        }
+        if (prev != NULL)
+            _xlist_node_destruct_(prev, self->dsize);
+        prev = ptr;
+        ptr = next;
+    }
+
+    // ptr is the new end, its diff still refers to prev
+    if (ptr != NULL)
+        ptr->diff = _xlist_xor_ptr_(ptr->diff, prev);
+    _xlist_node_destruct_(prev, self->dsize);
+    if (front)
+        self->head = ptr;
+    else
+        self->tail = ptr;
+
+    self->size -= n;
+    if (self->size == 0)
+    {
+        self->head = NULL;
+        self->tail = NULL;
+    }
+    return n;
+}
+static inline uint32_t xlist_pop_front_n(Xlist_t *self, void *out, uint32_t n)
+{
+    // out receives the popped elements in list order, returns the number popped
+    assert(self != NULL);
+    return _xlist_pop_n_(self, out, n, 1);
+}
+static inline uint32_t xlist_pop_back_n(Xlist_t *self, void *out, uint32_t n)
+{
+    // out receives the popped elements in list order, returns the number popped
+    assert(self != NULL);
+    return _xlist_pop_n_(self, out, n, 0);
+}
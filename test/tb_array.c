@@ -0,0 +1,126 @@
+#include "tau/tau.h"
+#include "cctrlib/array.h"
+#include "cctrlib/hash.h"
+
+TEST(Array, push_back_pop_back)
+{
+    const uint32_t test_base = 0x33221100;
+    const uint32_t test_len = 100;
+
+    Array_t *test_array = array_construct(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        uint32_t tmp = test_base + i;
+        array_push_back(test_array, &tmp);
+    }
+
+    REQUIRE_EQ(test_len, test_array->size);
+    for (uint32_t i = 0; i < test_len; i++)
+        CHECK_EQ(test_base + i, *(uint32_t *)array_at(test_array, i));
+    CHECK(NULL == array_at(test_array, test_len));
+
+    while (test_array->size > 0)
+    {
+        CHECK_EQ(test_base + (uint32_t)test_array->size - 1, *(uint32_t *)array_back(test_array));
+        array_pop_back(test_array);
+    }
+
+    array_destroy(test_array);
+}
+
+TEST(Array, insert_erase_find)
+{
+    const uint32_t test_base = 0x33221100;
+    uint32_t init[4] = {test_base + 0, test_base + 3, test_base + 4, test_base + 5};
+    uint32_t mid[2] = {test_base + 1, test_base + 2};
+
+    Array_t *test_array = array_from_array(init, 4, sizeof(uint32_t));
+    array_insert_array(test_array, 1, mid, 2);
+    REQUIRE_EQ(6, test_array->size);
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        uint32_t key = test_base + i;
+        CHECK_EQ(i, array_find(test_array, &key));
+    }
+
+    array_erase(test_array, 0);
+    array_erase(test_array, test_array->size - 1);
+    CHECK_EQ(test_base + 1, *(uint32_t *)array_front(test_array));
+    CHECK_EQ(test_base + 4, *(uint32_t *)array_back(test_array));
+
+    uint8_t key = 0x33;
+    CHECK_EQ(0, array_find_data_range(test_array, &key, 3, 1));
+    key = 0x04;
+    CHECK_EQ(3, array_find_data_range(test_array, &key, 0, 1));
+
+    Array_t *cpy = array_copy(test_array);
+    CHECK_EQ(test_array->size, cpy->size);
+    CHECK_BUF_EQ(test_array->data, cpy->data, cpy->size * cpy->dsize);
+
+    array_destroy(cpy);
+    array_destroy(test_array);
+}
+
+TEST(Array, huge)
+{
+    // moves to a huge page mapping past 2 MB
+    const uint64_t test_len = 1000000;
+    Array_t *test_array = array_construct_huge(sizeof(uint64_t));
+    for (uint64_t i = 0; i < 1000; i++)
+        array_push_back(test_array, &i);
+    CHECK_FALSE(test_array->flags & CCTR_ARRAY_MAPPED);
+    for (uint64_t i = 1000; i < test_len; i++)
+        array_push_back(test_array, &i);
+    if (test_array->flags & CCTR_ARRAY_MAPPED)
+    {
+        CHECK_EQ(0, (uintptr_t)test_array->data % (2 << 20));
+        CHECK_EQ(test_array->map_size / sizeof(uint64_t), test_array->capacity);
+    }
+    for (uint64_t i = 0; i < test_len; i += 999)
+        REQUIRE_EQ(i, *(uint64_t *)array_at(test_array, i));
+    array_insert(test_array, 1, &(uint64_t){7});
+    CHECK_EQ(7, *(uint64_t *)array_at(test_array, 1));
+    CHECK_EQ(test_len - 1, *(uint64_t *)array_back(test_array));
+
+    // a copy keeps the huge page storage
+    Array_t *cpy = array_copy(test_array);
+    CHECK_TRUE(cpy->flags & CCTR_ARRAY_HUGE);
+    CHECK_EQ(test_array->flags & CCTR_ARRAY_MAPPED, cpy->flags & CCTR_ARRAY_MAPPED);
+    REQUIRE_EQ(test_array->size, cpy->size);
+    CHECK_TRUE(array_equal(test_array, cpy));
+    array_destroy(cpy);
+
+    array_clear(test_array);
+    CHECK_EQ(CCTR_ARRAY_HUGE, test_array->flags);
+    array_push_back(test_array, &(uint64_t){3});
+    CHECK_EQ(3, *(uint64_t *)array_front(test_array));
+    array_destroy(test_array);
+}
+
+TEST(Array, equal_compare_hash)
+{
+    const uint64_t test_len = 1000;
+    Array_t *test_array = array_construct(sizeof(uint64_t));
+    for (uint64_t i = 0; i < test_len; i++)
+        array_push_back(test_array, &i);
+    Array_t *cpy = array_copy(test_array);
+    CHECK_TRUE(array_equal(test_array, cpy));
+    CHECK_EQ(0, array_compare(test_array, cpy));
+    CHECK_EQ(array_hash(test_array), array_hash(cpy));
+
+    *(uint64_t *)array_at(cpy, 10) = 0;
+    CHECK_FALSE(array_equal(test_array, cpy));
+    CHECK_NE(array_hash(test_array), array_hash(cpy));
+    CHECK_EQ(1, array_compare(test_array, cpy));
+
+    // a prefix comes first
+    array_pop_back(test_array);
+    *(uint64_t *)array_at(cpy, 10) = 10;
+    CHECK_EQ(-1, array_compare(test_array, cpy));
+    CHECK_EQ(1, array_compare(cpy, test_array));
+
+    array_clear(cpy);
+    CHECK_EQ(cctr_hash(NULL, 0, CCTR_HASH_SEED), array_hash(cpy));
+    array_destroy(cpy);
+    array_destroy(test_array);
+}
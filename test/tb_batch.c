@@ -0,0 +1,129 @@
+#include "tau/tau.h"
+#include "cctrlib/list.h"
+#include "cctrlib/slist.h"
+#include "cctrlib/xlist.h"
+
+#define TB_BATCH_LEN 100
+
+static void _tb_fill_(uint32_t *array, uint32_t base, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+        array[i] = base + i;
+}
+
+TEST(Batch, list)
+{
+    uint32_t array[TB_BATCH_LEN];
+    uint32_t out[TB_BATCH_LEN];
+
+    List_t *test_list = list_init(sizeof(uint32_t));
+    _tb_fill_(array, 100, TB_BATCH_LEN);
+    list_push_back_n(test_list, array, TB_BATCH_LEN);
+    _tb_fill_(array, 0, TB_BATCH_LEN);
+    list_push_front_n(test_list, array, TB_BATCH_LEN);
+    uint32_t tmp = 200;
+    list_push_back(test_list, &tmp);
+
+    REQUIRE_EQ(2 * TB_BATCH_LEN + 1, test_list->size);
+    uint32_t i = 0;
+    for (List_Node_t *ptr = test_list->head; ptr != NULL; ptr = ptr->next, i++)
+    {
+        CHECK_EQ(i, *(uint32_t *)ptr->data);
+        if (ptr->next != NULL)
+            CHECK(ptr->next->prev == ptr);
+    }
+
+    // single pops and erase on batch nodes
+    list_pop_front(test_list);
+    list_erase(test_list, 50);
+    CHECK_EQ(2 * TB_BATCH_LEN - 1, test_list->size);
+
+    CHECK_EQ(10, list_pop_front_n(test_list, out, 10));
+    for (i = 0; i < 10; i++)
+        CHECK_EQ(i + 1, out[i]);
+    CHECK_EQ(10, list_pop_back_n(test_list, out, 10));
+    for (i = 0; i < 10; i++)
+        CHECK_EQ(191 + i, out[i]);
+    CHECK_EQ(190, *(uint32_t *)list_back(test_list));
+
+    uint32_t rest = test_list->size;
+    CHECK_EQ(rest, list_pop_back_n(test_list, NULL, 1000));
+    CHECK(NULL == test_list->head);
+    CHECK(NULL == test_list->tail);
+
+    list_destroy(test_list);
+}
+
+TEST(Batch, slist)
+{
+    uint32_t array[TB_BATCH_LEN];
+    uint32_t out[TB_BATCH_LEN];
+
+    Slist_t *test_list = slist_construct(sizeof(uint32_t));
+    _tb_fill_(array, 100, TB_BATCH_LEN);
+    slist_push_back_n(test_list, array, TB_BATCH_LEN);
+    _tb_fill_(array, 0, TB_BATCH_LEN);
+    slist_push_front_n(test_list, array, TB_BATCH_LEN);
+
+    REQUIRE_EQ(2 * TB_BATCH_LEN, test_list->size);
+    for (uint32_t i = 0; i < 2 * TB_BATCH_LEN; i++)
+        CHECK_EQ(i, *(uint32_t *)slist_at(test_list, i));
+    CHECK_EQ(199, *(uint32_t *)slist_back(test_list));
+
+    CHECK_EQ(5, slist_pop_front_n(test_list, out, 5));
+    CHECK_EQ(4, out[4]);
+    CHECK_EQ(5, slist_pop_back_n(test_list, out, 5));
+    CHECK_EQ(195, out[0]);
+    CHECK_EQ(194, *(uint32_t *)slist_back(test_list));
+    CHECK_EQ(5, *(uint32_t *)slist_front(test_list));
+
+    // the chain hand-over of slist_split_front keeps batch nodes alive
+    Slist_t *chain = slist_split_front(test_list, 50);
+    slist_destroy(test_list);
+    CHECK_EQ(54, *(uint32_t *)slist_back(chain));
+    slist_destroy(chain);
+}
+
+TEST(Batch, xlist)
+{
+    uint32_t array[TB_BATCH_LEN];
+    uint32_t out[TB_BATCH_LEN];
+
+    Xlist_t *test_list = xlist_construct(sizeof(uint32_t));
+    uint32_t tmp = 100;
+    xlist_push_back(test_list, &tmp);
+    _tb_fill_(array, 101, TB_BATCH_LEN);
+    xlist_push_back_n(test_list, array, TB_BATCH_LEN);
+    _tb_fill_(array, 0, TB_BATCH_LEN);
+    xlist_push_front_n(test_list, array, TB_BATCH_LEN);
+    REQUIRE_EQ(2 * TB_BATCH_LEN + 1, test_list->size);
+
+    Xlist_t *cpy = xlist_copy(test_list);
+    CHECK_EQ(test_list->size, cpy->size);
+
+    CHECK_EQ(TB_BATCH_LEN, xlist_pop_front_n(test_list, out, TB_BATCH_LEN));
+    for (uint32_t i = 0; i < TB_BATCH_LEN; i++)
+        CHECK_EQ(i, out[i]);
+    CHECK_EQ(100, *(uint32_t *)xlist_front(test_list));
+
+    CHECK_EQ(TB_BATCH_LEN, xlist_pop_back_n(test_list, out, TB_BATCH_LEN));
+    for (uint32_t i = 0; i < TB_BATCH_LEN; i++)
+        CHECK_EQ(101 + i, out[i]);
+    CHECK_EQ(1, test_list->size);
+    CHECK_EQ(100, *(uint32_t *)xlist_back(test_list));
+
+    // walk the copy from both ends
+    for (uint32_t lo = 0, hi = 2 * TB_BATCH_LEN; lo <= hi; lo++, hi--)
+    {
+        CHECK_EQ(lo, *(uint32_t *)xlist_front(cpy));
+        xlist_pop_front(cpy);
+        if (cpy->size == 0)
+            break;
+        CHECK_EQ(hi, *(uint32_t *)xlist_back(cpy));
+        xlist_pop_back(cpy);
+    }
+    CHECK_EQ(0, cpy->size);
+
+    xlist_destroy(cpy);
+    xlist_destroy(test_list);
+}
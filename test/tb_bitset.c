@@ -0,0 +1,169 @@
+#include <unistd.h>
+#include "tau/tau.h"
+#include "cctrlib/bitset.h"
+#include "cctrlib/serialize.h"
+
+static uint64_t _tb_bitset_rand_(uint64_t *seed)
+{
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *seed >> 17;
+}
+
+TEST(Bitset, bits)
+{
+    // random edits against one byte per bit, lengths off the word size
+    const uint64_t test_len = 100003;
+    uint8_t *model = (uint8_t *)calloc(test_len, 1);
+    uint64_t seed = 3;
+    Bitset_t *test_bitset = bitset_construct(test_len);
+    REQUIRE(test_bitset != NULL);
+    CHECK_EQ(0, bitset_count(test_bitset));
+    CHECK_EQ(test_len, bitset_next(test_bitset, 0));
+
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        uint64_t pos = _tb_bitset_rand_(&seed) % test_len;
+        switch (i % 4)
+        {
+        case 0:
+        case 1:
+            bitset_set(test_bitset, pos);
+            model[pos] = 1;
+            break;
+        case 2:
+            bitset_clear(test_bitset, pos);
+            model[pos] = 0;
+            break;
+        default:
+            bitset_flip(test_bitset, pos);
+            model[pos] ^= 1;
+        }
+    }
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        uint64_t lo = _tb_bitset_rand_(&seed) % test_len;
+        uint64_t hi = lo + _tb_bitset_rand_(&seed) % (i < 10 ? 70 : test_len - lo + 1);
+        hi = hi < test_len ? hi : test_len;
+        bitset_set_range(test_bitset, lo, hi, i % 2);
+        memset(model + lo, i % 2, hi - lo);
+    }
+
+    uint64_t ones = 0;
+    for (uint64_t pos = 0; pos < test_len; pos++)
+    {
+        REQUIRE_EQ(model[pos], bitset_test(test_bitset, pos));
+        ones += model[pos];
+    }
+    CHECK_EQ(ones, bitset_count(test_bitset));
+
+    // next visits every set bit, rank / select agree with the model
+    uint64_t k = 0;
+    for (uint64_t pos = bitset_next(test_bitset, 0); pos < test_len; pos = bitset_next(test_bitset, pos + 1))
+    {
+        REQUIRE_EQ(1, model[pos]);
+        REQUIRE_EQ(k, bitset_rank(test_bitset, pos));
+        REQUIRE_EQ(pos, bitset_select(test_bitset, k));
+        k++;
+    }
+    CHECK_EQ(ones, k);
+    CHECK_EQ(ones, bitset_rank(test_bitset, test_len));
+    CHECK_EQ(test_len, bitset_select(test_bitset, ones));
+
+    // the index is rebuilt after a change
+    uint64_t pos = bitset_select(test_bitset, 0);
+    bitset_clear(test_bitset, pos);
+    CHECK_EQ(ones - 1, bitset_count(test_bitset));
+    CHECK_EQ(0, bitset_rank(test_bitset, pos + 1));
+    CHECK_NE(pos, bitset_select(test_bitset, 0));
+
+    free(model);
+    bitset_destroy(test_bitset);
+}
+
+TEST(Bitset, bulk)
+{
+    const uint64_t test_len = 1000;
+    uint64_t seed = 5;
+    Bitset_t *a = bitset_construct(test_len);
+    Bitset_t *b = bitset_construct(test_len);
+    for (uint32_t i = 0; i < 600; i++)
+    {
+        bitset_set(a, _tb_bitset_rand_(&seed) % test_len);
+        bitset_set(b, _tb_bitset_rand_(&seed) % test_len);
+    }
+
+    Bitset_t *res[4];
+    for (int op = 0; op < 4; op++)
+        res[op] = bitset_copy(a);
+    bitset_and(res[0], b);
+    bitset_or(res[1], b);
+    bitset_xor(res[2], b);
+    bitset_andnot(res[3], b);
+    for (uint64_t pos = 0; pos < test_len; pos++)
+    {
+        int x = bitset_test(a, pos), y = bitset_test(b, pos);
+        REQUIRE_EQ(x & y, bitset_test(res[0], pos));
+        REQUIRE_EQ(x | y, bitset_test(res[1], pos));
+        REQUIRE_EQ(x ^ y, bitset_test(res[2], pos));
+        REQUIRE_EQ(x & !y, bitset_test(res[3], pos));
+    }
+    CHECK_EQ(bitset_count(res[1]), bitset_count(res[0]) + bitset_count(res[2]));
+    for (int op = 0; op < 4; op++)
+        bitset_destroy(res[op]);
+    bitset_destroy(a);
+    bitset_destroy(b);
+}
+
+TEST(Bitset, file)
+{
+    char path[] = "/tmp/tb_cctr_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+
+    const uint64_t test_len = 5000;
+    Bitset_t *test_bitset = bitset_create(path, test_len);
+    REQUIRE(test_bitset != NULL);
+    for (uint64_t pos = 0; pos < test_len; pos += 3)
+        bitset_set(test_bitset, pos);
+    CHECK_EQ(0, bitset_sync(test_bitset));
+    bitset_destroy(test_bitset);
+
+    test_bitset = bitset_open(path, 0);
+    REQUIRE(test_bitset != NULL);
+    CHECK_EQ(test_len, test_bitset->nbits);
+    CHECK_EQ((test_len + 2) / 3, bitset_count(test_bitset));
+    CHECK_EQ(3 * 100, bitset_select(test_bitset, 100));
+    bitset_destroy(test_bitset);
+
+    // the words read back as an array
+    Array_t *words = array_map(path);
+    REQUIRE(words != NULL);
+    CHECK_EQ((test_len + 63) / 64, words->size);
+    CHECK_EQ(0x9249249249249249ULL, *(uint64_t *)array_at(words, 0));
+    array_destroy(words);
+
+    // not a bitset
+    List_t *test_list = list_init(sizeof(uint64_t));
+    list_push_back(test_list, &(uint64_t){1});
+    REQUIRE_EQ(0, list_save(test_list, path));
+    CHECK(NULL == bitset_open(path, 1));
+    list_destroy(test_list);
+    unlink(path);
+}
+
+TEST(Bitset, sparse)
+{
+    // eight billion bits, only the pages written to are backed
+    const uint64_t test_len = 1ULL << 33;
+    Bitset_t *test_bitset = bitset_construct(test_len);
+    REQUIRE(test_bitset != NULL);
+    bitset_set(test_bitset, 7);
+    bitset_set(test_bitset, test_len - 1);
+    bitset_set_range(test_bitset, 1ULL << 32, (1ULL << 32) + 100, 1);
+    CHECK_EQ(7, bitset_next(test_bitset, 0));
+    CHECK_EQ(1ULL << 32, bitset_next(test_bitset, (1ULL << 32) - 64));
+    CHECK_EQ(test_len - 1, bitset_next(test_bitset, test_len - 4096));
+    CHECK_EQ(test_len, bitset_next(test_bitset, test_len));
+    bitset_destroy(test_bitset);
+}
@@ -0,0 +1,180 @@
+#include "tau/tau.h"
+#include "cctrlib/bset.h"
+
+static void _tb_bset_collect_(const void *key, void *value, void *ctx)
+{
+    Array_t *out = (Array_t *)ctx;
+    array_push_back(out, (void *)key);
+}
+
+static int _tb_bset_pair_cmp_(const void *a, const void *b, void *ctx)
+{
+    // two uint32_t, ordered by the second then the first
+    const uint32_t *x = (const uint32_t *)a;
+    const uint32_t *y = (const uint32_t *)b;
+    if (x[1] != y[1])
+        return x[1] < y[1] ? -1 : 1;
+    return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+static int _tb_bset_random_(uint32_t vsize)
+{
+    // random inserts and erases over a small key space against a table of present keys
+    const uint32_t test_range = 5000;
+    uint8_t present[5000] = {0};
+    uint8_t value[vsize + 1];
+    Bset_t *test_set = bset_construct(sizeof(uint32_t), vsize, NULL, NULL);
+    uint64_t seed = 7;
+    uint64_t size = 0;
+
+    for (uint32_t i = 0; i < 60000; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = (uint32_t)(seed >> 33);
+        // ascending runs now and then, they take the full leaf split
+        uint32_t key = r % 8 == 0 ? i % test_range : (r >> 3) % test_range;
+        if ((r >> 20) % 3 != 0)
+        {
+            memset(value, (uint8_t)key, vsize);
+            if (bset_insert(test_set, &key, value) != !present[key])
+                return 0;
+            size += !present[key];
+            present[key] = 1;
+        }
+        else
+        {
+            if (bset_erase(test_set, &key) != present[key])
+                return 0;
+            size -= present[key];
+            present[key] = 0;
+        }
+        if (size != test_set->size)
+            return 0;
+    }
+
+    Bset_Iter_t iter;
+    int valid = bset_first(test_set, &iter);
+    for (uint32_t key = 0; key < test_range; key++)
+    {
+        if (present[key] != bset_contains(test_set, &key))
+            return 0;
+        if (!present[key])
+            continue;
+        memset(value, (uint8_t)key, vsize);
+        if (!valid || key != *(const uint32_t *)bset_iter_key(test_set, &iter) ||
+            (vsize && memcmp(value, bset_iter_value(test_set, &iter), vsize)))
+            return 0;
+        valid = bset_next(test_set, &iter);
+    }
+    if (valid)
+        return 0;
+
+    // everything out again, the tree shrinks back to nothing
+    for (uint32_t key = 0; key < test_range; key++)
+        bset_erase(test_set, &key);
+    int ret = test_set->size == 0 && test_set->root == NULL && !bset_first(test_set, &iter);
+    bset_destroy(test_set);
+    return ret;
+}
+
+TEST(Bset, insert_erase)
+{
+    CHECK(_tb_bset_random_(0));
+    // 4 entries per leaf, a deep tree which rebalances all the time
+    CHECK(_tb_bset_random_(120));
+}
+
+TEST(Bset, bounds_range)
+{
+    // even keys 0, 2, .. from a bulk load, values are the halves
+    const uint32_t test_len = 10000;
+    uint64_t *keys = (uint64_t *)malloc(test_len * sizeof(uint64_t));
+    uint32_t *values = (uint32_t *)malloc(test_len * sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        keys[i] = 2 * (uint64_t)i;
+        values[i] = i;
+    }
+    Bset_t *test_map = bset_from_sorted(sizeof(uint64_t), sizeof(uint32_t), NULL, NULL, keys, values, test_len);
+    CHECK_EQ(test_len, test_map->size);
+
+    uint64_t key = 1234;
+    CHECK_EQ(617, *(uint32_t *)bset_find(test_map, &key));
+    key = 1235;
+    CHECK(NULL == bset_find(test_map, &key));
+
+    Bset_Iter_t iter;
+    CHECK(bset_lower_bound(test_map, &key, &iter));
+    CHECK_EQ(1236, *(const uint64_t *)bset_iter_key(test_map, &iter));
+    CHECK_EQ(618, *(uint32_t *)bset_iter_value(test_map, &iter));
+    key = 1236;
+    CHECK(bset_lower_bound(test_map, &key, &iter));
+    CHECK_EQ(1236, *(const uint64_t *)bset_iter_key(test_map, &iter));
+    CHECK(bset_upper_bound(test_map, &key, &iter));
+    CHECK_EQ(1238, *(const uint64_t *)bset_iter_key(test_map, &iter));
+    key = 2 * (uint64_t)(test_len - 1);
+    CHECK_FALSE(bset_upper_bound(test_map, &key, &iter));
+    CHECK(bset_lower_bound(test_map, &key, &iter));
+    CHECK_FALSE(bset_next(test_map, &iter));
+
+    // a key which exists is overwritten, not added
+    uint32_t value = 123456;
+    key = 100;
+    CHECK_FALSE(bset_insert(test_map, &key, &value));
+    CHECK_EQ(123456, *(uint32_t *)bset_find(test_map, &key));
+    key = 101;
+    CHECK(bset_insert(test_map, &key, NULL));
+    CHECK_EQ(0, *(uint32_t *)bset_find(test_map, &key));
+
+    Array_t *out = array_construct(sizeof(uint64_t));
+    uint64_t lo = 95;
+    uint64_t hi = 106;
+    CHECK_EQ(6, bset_range(test_map, &lo, &hi, _tb_bset_collect_, out));
+    uint64_t expect[] = {96, 98, 100, 101, 102, 104};
+    REQUIRE_EQ(6, out->size);
+    CHECK_BUF_EQ(expect, out->data, sizeof(expect));
+    array_clear(out);
+
+    CHECK_EQ(0, bset_range(test_map, &hi, &lo, _tb_bset_collect_, out));
+    CHECK_EQ(test_len + 1, bset_range(test_map, NULL, NULL, _tb_bset_collect_, out));
+    for (uint32_t i = 1; i < out->size; i++)
+        REQUIRE_LT(*(uint64_t *)array_at(out, i - 1), *(uint64_t *)array_at(out, i));
+    array_destroy(out);
+
+    bset_destroy(test_map);
+    free(keys);
+    free(values);
+}
+
+TEST(Bset, comparator)
+{
+    Bset_t *test_set = bset_construct(2 * sizeof(uint32_t), 0, _tb_bset_pair_cmp_, NULL);
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        uint32_t key[2] = {i, (i * 7919) % 100};
+        CHECK(bset_insert(test_set, key, NULL));
+    }
+    uint32_t key[2] = {0, 50};
+    Bset_Iter_t iter;
+    REQUIRE(bset_lower_bound(test_set, key, &iter));
+    const uint32_t *found = (const uint32_t *)bset_iter_key(test_set, &iter);
+    uint32_t first = 0;
+    while ((first * 7919) % 100 != 50)
+        first++;
+    CHECK_EQ(50, found[1]);
+    CHECK_EQ(first, found[0]);
+    uint32_t prev[2] = {found[0], found[1]};
+    while (bset_next(test_set, &iter))
+    {
+        found = (const uint32_t *)bset_iter_key(test_set, &iter);
+        REQUIRE_LT(_tb_bset_pair_cmp_(prev, found, NULL), 0);
+        memcpy(prev, found, sizeof(prev));
+    }
+    for (uint32_t i = 0; i < 3000; i += 2)
+    {
+        uint32_t key[2] = {i, (i * 7919) % 100};
+        CHECK(bset_erase(test_set, key));
+    }
+    CHECK_EQ(1500, test_set->size);
+    bset_destroy(test_set);
+}
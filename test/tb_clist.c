@@ -0,0 +1,199 @@
+#include <pthread.h>
+#include "tau/tau.h"
+#include "cctrlib/clist.h"
+#include "cctrlib/list.h"
+
+static int _tb_clist_equal_(Clist_t *clist, List_t *list)
+{
+    if (clist_size(clist) != list->size)
+        return 0;
+    uint32_t i = 0;
+    uint32_t tmp;
+    for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next, i++)
+        if (!clist_at(clist, i, &tmp) || memcmp(&tmp, ptr->data, sizeof(tmp)))
+            return 0;
+    return !clist_at(clist, i, &tmp);
+}
+
+static void _tb_clist_sum_(const void *data, void *ctx)
+{
+    *(uint64_t *)ctx += *(const uint32_t *)data;
+}
+
+TEST(Clist, list_ops)
+{
+    // the same random operations on a Clist_t and a List_t, one thread
+    Clist_t *test_clist = clist_construct(sizeof(uint32_t));
+    List_t *test_list = list_init(sizeof(uint32_t));
+    uint64_t seed = 5;
+    uint32_t out;
+
+    CHECK_FALSE(clist_pop_front(test_clist, &out));
+    CHECK_FALSE(clist_pop_back(test_clist, &out));
+    CHECK_FALSE(clist_erase(test_clist, 0, &out));
+    CHECK_FALSE(clist_insert(test_clist, 1, &out));
+
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = (uint32_t)(seed >> 33);
+        uint32_t op = r % 10;
+        uint32_t pos = test_list->size > 0 ? (r >> 4) % test_list->size : 0;
+
+        if (op < 3)
+        {
+            clist_push_back(test_clist, &i);
+            list_push_back(test_list, &i);
+        }
+        else if (op < 4)
+        {
+            clist_push_front(test_clist, &i);
+            list_push_front(test_list, &i);
+        }
+        else if (op < 6 && test_list->size > 0)
+        {
+            CHECK(clist_insert(test_clist, pos, &i));
+            list_insert(test_list, pos, &i);
+        }
+        else if (op < 7 && test_list->size > 0)
+        {
+            CHECK(clist_erase(test_clist, pos, &out));
+            CHECK_EQ(*(uint32_t *)list_at(test_list, pos), out);
+            list_erase(test_list, pos);
+        }
+        else if (op < 8 && test_list->size > 0)
+        {
+            CHECK(clist_pop_back(test_clist, &out));
+            CHECK_EQ(*(uint32_t *)list_back(test_list), out);
+            list_pop_back(test_list);
+        }
+        else if (op < 9 && test_list->size > 0)
+        {
+            uint32_t value = *(uint32_t *)list_at(test_list, pos);
+            CHECK_EQ(list_find(test_list, &value), clist_find(test_clist, &value));
+            CHECK(clist_remove(test_clist, &value));
+            list_erase(test_list, list_find(test_list, &value));
+        }
+        else if (test_list->size > 0)
+        {
+            CHECK(clist_pop_front(test_clist, &out));
+            CHECK_EQ(*(uint32_t *)list_front(test_list), out);
+            list_pop_front(test_list);
+        }
+    }
+    CHECK(_tb_clist_equal_(test_clist, test_list));
+    out = 0xFFFFFFFF;
+    CHECK_EQ(-1, clist_find(test_clist, &out));
+    CHECK_FALSE(clist_remove(test_clist, &out));
+    CHECK_FALSE(clist_insert(test_clist, test_list->size + 1, &out));
+    CHECK(clist_insert(test_clist, test_list->size, &out));
+    CHECK_EQ(test_list->size, clist_find(test_clist, &out));
+
+    clist_destroy(test_clist);
+    list_destroy(test_list);
+}
+
+typedef struct
+{
+    Clist_t *clist;
+    uint32_t id;
+    uint32_t count;
+    uint64_t sum;
+} Tb_Clist_Worker_t;
+
+static void *_tb_clist_writer_(void *arg)
+{
+    // pushes its own range at both ends and in the middle, then removes it again
+    Tb_Clist_Worker_t *worker = (Tb_Clist_Worker_t *)arg;
+    for (uint32_t i = 0; i < worker->count; i++)
+    {
+        uint32_t tmp = worker->id * worker->count + i;
+        if (i % 3 == 0)
+            clist_push_back(worker->clist, &tmp);
+        else if (i % 3 == 1)
+            clist_push_front(worker->clist, &tmp);
+        else
+            clist_insert(worker->clist, i % 64, &tmp);
+    }
+    for (uint32_t i = 0; i < worker->count; i++)
+    {
+        uint32_t tmp = worker->id * worker->count + i;
+        worker->sum += clist_remove(worker->clist, &tmp);
+    }
+    return NULL;
+}
+
+static void *_tb_clist_reader_(void *arg)
+{
+    Tb_Clist_Worker_t *worker = (Tb_Clist_Worker_t *)arg;
+    for (uint32_t i = 0; i < worker->count; i++)
+    {
+        uint32_t tmp = i;
+        worker->sum += clist_find(worker->clist, &tmp) >= 0;
+        clist_for_each(worker->clist, _tb_clist_sum_, &worker->sum);
+    }
+    return NULL;
+}
+
+static void *_tb_clist_popper_(void *arg)
+{
+    Tb_Clist_Worker_t *worker = (Tb_Clist_Worker_t *)arg;
+    uint32_t out;
+    while (worker->id & 1 ? clist_pop_back(worker->clist, &out) : clist_pop_front(worker->clist, &out))
+    {
+        worker->sum += out;
+        worker->count++;
+    }
+    return NULL;
+}
+
+TEST(Clist, threads)
+{
+    const uint32_t test_count = 300;
+    const uint32_t test_threads = 6;
+
+    Clist_t *test_clist = clist_construct(sizeof(uint32_t));
+    uint32_t keep = 0xFFFFFFFF;
+    clist_push_back(test_clist, &keep);
+
+    // writers on even ids, readers on odd ids
+    pthread_t threads[test_threads];
+    Tb_Clist_Worker_t workers[test_threads];
+    for (uint32_t t = 0; t < test_threads; t++)
+    {
+        workers[t] = (Tb_Clist_Worker_t){test_clist, t, test_count, 0};
+        pthread_create(&threads[t], NULL, t & 1 ? _tb_clist_reader_ : _tb_clist_writer_, &workers[t]);
+    }
+    for (uint32_t t = 0; t < test_threads; t++)
+    {
+        pthread_join(threads[t], NULL);
+        if (!(t & 1))
+            CHECK_EQ(test_count, workers[t].sum);
+    }
+    CHECK_EQ(1, clist_size(test_clist));
+    CHECK_EQ(0, clist_find(test_clist, &keep));
+
+    // both ends drained at once, every element comes out exactly once
+    const uint32_t test_len = 20000;
+    clist_pop_front(test_clist, NULL);
+    for (uint32_t i = 0; i < test_len; i++)
+        clist_push_back(test_clist, &i);
+    uint64_t sum = 0;
+    uint32_t count = 0;
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        workers[t] = (Tb_Clist_Worker_t){test_clist, t, 0, 0};
+        pthread_create(&threads[t], NULL, _tb_clist_popper_, &workers[t]);
+    }
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        pthread_join(threads[t], NULL);
+        sum += workers[t].sum;
+        count += workers[t].count;
+    }
+    CHECK_EQ(test_len, count);
+    CHECK_EQ((uint64_t)test_len * (test_len - 1) / 2, sum);
+    CHECK_EQ(0, clist_size(test_clist));
+
+    clist_destroy(test_clist);
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <unistd.h>
+#include "tau/tau.h"
+#include "cctrlib/dump.h"
+
+static char *_tb_dump_read_(FILE *file, uint64_t *len)
+{
+    // everything written to file so far, NUL terminated
+    int fd = fileno(file);
+    *len = (uint64_t)lseek(fd, 0, SEEK_END);
+    char *ret = (char *)malloc(*len + 1);
+    if (pread(fd, ret, *len, 0) != (ssize_t)*len)
+        *len = 0;
+    ret[*len] = '\0';
+    ftruncate(fd, 0);
+    lseek(fd, 0, SEEK_SET);
+    return ret;
+}
+
+static char *_tb_dump_csv_(uint64_t from, uint64_t to)
+{
+    // expected CSV of the elements {i, 3 * i} for i in [from, to)
+    char *ret = (char *)malloc((to - from) * 24 + 1);
+    char *ptr = ret;
+    *ptr = '\0';
+    for (uint64_t i = from; i < to; i++)
+        ptr += sprintf(ptr, "%lu,%lu\n", i, 3 * i);
+    return ret;
+}
+
+TEST(Dump, hex_raw_csv)
+{
+    const uint32_t test_len = 1000;
+    FILE *file = tmpfile();
+    REQUIRE(file != NULL);
+
+    List_t *test_list = list_init(sizeof(uint32_t[2]));
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        uint32_t data[2] = {i, 3 * i};
+        list_push_back(test_list, data);
+    }
+
+    // hex in memory order, numbered from the range start
+    Cctr_Dump_t dump;
+    cctr_dump_init(&dump, fileno(file), CCTR_DUMP_HEX, NULL, 0);
+    REQUIRE_EQ(0, list_dump(test_list, &dump, 700, 702));
+    REQUIRE_EQ(0, cctr_dump_close(&dump));
+    uint64_t len;
+    char *text = _tb_dump_read_(file, &len);
+    CHECK_STREQ("700: bc 02 00 00 34 08 00 00\n701: bd 02 00 00 37 08 00 00\n", text);
+    free(text);
+
+    // raw through a small buffer, a range from the back half
+    uint8_t buf[CCTR_DUMP_MIN_BUFFER];
+    cctr_dump_init(&dump, fileno(file), CCTR_DUMP_RAW, buf, sizeof(buf));
+    REQUIRE_EQ(0, list_dump(test_list, &dump, 600, UINT64_MAX));
+    REQUIRE_EQ(0, cctr_dump_close(&dump));
+    uint32_t *raw = (uint32_t *)_tb_dump_read_(file, &len);
+    REQUIRE_EQ((test_len - 600) * 8, len);
+    for (uint32_t i = 0; i < test_len - 600; i++)
+    {
+        CHECK_EQ(600 + i, raw[2 * i]);
+        CHECK_EQ(3 * (600 + i), raw[2 * i + 1]);
+    }
+    free(raw);
+
+    // csv, the list goes through the small buffer many times over
+    cctr_dump_init(&dump, fileno(file), CCTR_DUMP_CSV, buf, sizeof(buf));
+    dump.width = sizeof(uint32_t);
+    REQUIRE_EQ(0, list_dump(test_list, &dump, 0, UINT64_MAX));
+    REQUIRE_EQ(0, cctr_dump_close(&dump));
+    char *expect = _tb_dump_csv_(0, test_len);
+    text = _tb_dump_read_(file, &len);
+    CHECK_STREQ(expect, text);
+    free(expect);
+    free(text);
+
+    // an empty range writes nothing
+    cctr_dump_init(&dump, fileno(file), CCTR_DUMP_CSV, NULL, 0);
+    REQUIRE_EQ(0, list_dump(test_list, &dump, test_len, UINT64_MAX));
+    REQUIRE_EQ(0, cctr_dump_close(&dump));
+    text = _tb_dump_read_(file, &len);
+    CHECK_EQ(0, len);
+    free(text);
+
+    // csv of 8 byte fields and of single bytes, hex of an element wider than a chunk
+    uint64_t wide[2] = {UINT64_MAX, 12345678901234};
+    uint8_t odd[3] = {0, 9, 255};
+    uint8_t big[100];
+    for (uint32_t i = 0; i < sizeof(big); i++)
+        big[i] = i;
+    cctr_dump_init(&dump, fileno(file), CCTR_DUMP_CSV, buf, sizeof(buf));
+    cctr_dump_elements(&dump, wide, 1, sizeof(wide));
+    cctr_dump_elements(&dump, odd, 1, sizeof(odd));
+    dump.mode = CCTR_DUMP_HEX;
+    cctr_dump_elements(&dump, big, 1, sizeof(big));
+    REQUIRE_EQ(0, cctr_dump_close(&dump));
+    text = _tb_dump_read_(file, &len);
+    char line[512] = "18446744073709551615,12345678901234\n0,9,255\n2:";
+    for (uint32_t i = 0; i < sizeof(big); i++)
+        sprintf(line + strlen(line), " %02x", i);
+    strcat(line, "\n");
+    CHECK_STREQ(line, text);
+    free(text);
+
+    // a write error sticks
+    cctr_dump_init(&dump, -1, CCTR_DUMP_HEX, buf, sizeof(buf));
+    cctr_dump_elements(&dump, big, 1, sizeof(big));
+    CHECK_EQ(-1, cctr_dump_flush(&dump));
+    CHECK_EQ(-1, cctr_dump_elements(&dump, big, 1, sizeof(big)));
+    CHECK_EQ(-1, cctr_dump_close(&dump));
+
+    list_destroy(test_list);
+    fclose(file);
+}
+
+TEST(Dump, containers)
+{
+    const uint32_t test_len = 3000;
+    const uint64_t from = 1234;
+    const uint64_t to = 2345;
+    FILE *file = tmpfile();
+    REQUIRE(file != NULL);
+    char *expect = _tb_dump_csv_(from, to);
+
+    uint32_t(*all)[2] = malloc(sizeof(uint32_t[2]) * test_len);
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        all[i][0] = i;
+        all[i][1] = 3 * i;
+    }
+
+    Slist_t *test_slist = slist_construct(sizeof(uint32_t[2]));
+    Xlist_t *test_xlist = xlist_construct(sizeof(uint32_t[2]));
+    Array_t *test_array = array_construct(sizeof(uint32_t[2]));
+    Plist_t *test_plist = plist_construct(sizeof(uint32_t[2]));
+    Clist_t *test_clist = clist_construct(sizeof(uint32_t[2]));
+    Gap_t *test_gap = gap_construct(sizeof(uint32_t[2]));
+    Rope_t *test_rope = rope_construct(sizeof(uint32_t[2]));
+    Stream_t *test_stream = stream_construct(sizeof(uint32_t[2]), 64, NULL);
+    REQUIRE(test_stream != NULL);
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        slist_push_back(test_slist, all[i]);
+        xlist_push_back(test_xlist, all[i]);
+        array_push_back(test_array, all[i]);
+        plist_push_back(test_plist, all[i]);
+        clist_push_back(test_clist, all[i]);
+        stream_push_back(test_stream, all[i]);
+    }
+    // the gap sits inside the range, the rope is built in several inserts
+    gap_insert(test_gap, all, test_len);
+    gap_move(test_gap, 2000);
+    rope_insert(test_rope, 0, all[1000], test_len - 1000);
+    rope_insert(test_rope, 0, all, 1000);
+
+    int (*dumps[])(void *, Cctr_Dump_t *, uint64_t, uint64_t) = {
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))slist_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))xlist_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))array_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))plist_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))clist_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))gap_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))rope_dump,
+        (int (*)(void *, Cctr_Dump_t *, uint64_t, uint64_t))stream_dump,
+    };
+    void *selves[] = {test_slist, test_xlist, test_array, test_plist, test_clist, test_gap, test_rope, test_stream};
+    for (uint32_t k = 0; k < sizeof(selves) / sizeof(selves[0]); k++)
+    {
+        Cctr_Dump_t dump;
+        cctr_dump_init(&dump, fileno(file), CCTR_DUMP_CSV, NULL, 0);
+        dump.width = sizeof(uint32_t);
+        REQUIRE_EQ(0, dumps[k](selves[k], &dump, from, to));
+        REQUIRE_EQ(0, cctr_dump_close(&dump));
+        uint64_t len;
+        char *text = _tb_dump_read_(file, &len);
+        CHECK_STREQ(expect, text);
+        free(text);
+    }
+
+    slist_destroy(test_slist);
+    xlist_destroy(test_xlist);
+    array_destroy(test_array);
+    plist_destroy(test_plist);
+    clist_destroy(test_clist);
+    gap_destroy(test_gap);
+    rope_destroy(test_rope);
+    stream_destroy(test_stream);
+    free(all);
+    free(expect);
+    fclose(file);
+}
@@ -0,0 +1,79 @@
+#include "tau/tau.h"
+#include "cctrlib/gap.h"
+
+TEST(Gap, edits)
+{
+    // random cursor moves and edits against a plain buffer
+    const uint32_t test_cap = 20000;
+    uint8_t *model = (uint8_t *)malloc(test_cap);
+    uint8_t *out = (uint8_t *)malloc(test_cap);
+    uint8_t run[64];
+    uint64_t size = 0, cursor = 0;
+    uint64_t seed = 13;
+    Gap_t *test_gap = gap_construct(1);
+
+    CHECK_EQ(0, gap_size(test_gap));
+    CHECK(NULL == gap_at(test_gap, 0));
+    gap_export(test_gap, out);
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = (uint32_t)(seed >> 33);
+        uint32_t n = (r >> 8) % 64;
+        if (r % 4 == 0)
+        {
+            cursor = size ? (r >> 16) % (size + 1) : 0;
+            gap_move(test_gap, cursor);
+        }
+        else if (r % 4 == 1 && size + n <= test_cap)
+        {
+            for (uint32_t k = 0; k < n; k++)
+                run[k] = (uint8_t)(i + k);
+            gap_insert(test_gap, run, n);
+            memmove(model + cursor + n, model + cursor, size - cursor);
+            memcpy(model + cursor, run, n);
+            size += n;
+            cursor += n;
+        }
+        else if (r % 4 == 2)
+        {
+            n = n < size - cursor ? n : (uint32_t)(size - cursor);
+            gap_erase(test_gap, n);
+            memmove(model + cursor, model + cursor + n, size - cursor - n);
+            size -= n;
+        }
+        else
+        {
+            n = n < cursor ? n : (uint32_t)cursor;
+            gap_backspace(test_gap, n);
+            memmove(model + cursor - n, model + cursor, size - cursor);
+            size -= n;
+            cursor -= n;
+        }
+        REQUIRE_EQ(size, gap_size(test_gap));
+        REQUIRE_EQ(cursor, test_gap->cursor);
+    }
+
+    gap_export(test_gap, out);
+    CHECK_BUF_EQ(model, out, size);
+    for (uint64_t pos = 0; pos < size; pos += 7)
+        REQUIRE_EQ(model[pos], *(uint8_t *)gap_at(test_gap, pos));
+    CHECK(NULL == gap_at(test_gap, size));
+    gap_destroy(test_gap);
+
+    // wider elements, built from an array
+    uint64_t wide[100];
+    for (uint32_t i = 0; i < 100; i++)
+        wide[i] = 1000 + i;
+    test_gap = gap_from_array(wide, 100, sizeof(uint64_t));
+    gap_move(test_gap, 50);
+    gap_insert(test_gap, wide, 3);
+    CHECK_EQ(103, gap_size(test_gap));
+    CHECK_EQ(1049, *(uint64_t *)gap_at(test_gap, 49));
+    CHECK_EQ(1000, *(uint64_t *)gap_at(test_gap, 50));
+    CHECK_EQ(1050, *(uint64_t *)gap_at(test_gap, 53));
+    CHECK_EQ(1099, *(uint64_t *)gap_at(test_gap, 102));
+    gap_destroy(test_gap);
+    free(model);
+    free(out);
+}
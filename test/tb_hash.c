@@ -0,0 +1,46 @@
+#include "tau/tau.h"
+#include "cctrlib/hash.h"
+
+TEST(Hash, streaming)
+{
+    // any split of the input gives the one call value
+    uint8_t data[1000];
+    for (uint32_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t)(i * 31 + 7);
+    for (uint32_t len = 0; len <= sizeof(data); len += len < 200 ? 1 : 97)
+    {
+        uint64_t expect = cctr_hash(data, len, CCTR_HASH_SEED);
+        for (uint32_t piece = 1; piece <= 130; piece += 13)
+        {
+            Cctr_Hash_t hash;
+            cctr_hash_init(&hash, CCTR_HASH_SEED);
+            for (uint32_t i = 0; i < len; i += piece)
+                cctr_hash_update(&hash, data + i, len - i < piece ? len - i : piece);
+            REQUIRE_EQ(expect, cctr_hash_final(&hash));
+        }
+    }
+}
+
+TEST(Hash, spread)
+{
+    // length, seed and every single bit flip change the value
+    uint8_t data[200] = {0};
+    uint64_t base = cctr_hash(data, sizeof(data), CCTR_HASH_SEED);
+    CHECK_NE(base, cctr_hash(data, sizeof(data), CCTR_HASH_SEED + 1));
+    CHECK_NE(base, cctr_hash(data, sizeof(data) - 1, CCTR_HASH_SEED));
+    CHECK_NE(cctr_hash(data, 0, CCTR_HASH_SEED), cctr_hash(data, 1, CCTR_HASH_SEED));
+
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < sizeof(data) * 8; i++)
+    {
+        data[i / 8] ^= 1 << (i % 8);
+        uint64_t h = cctr_hash(data, sizeof(data), CCTR_HASH_SEED);
+        data[i / 8] ^= 1 << (i % 8);
+        REQUIRE_NE(base, h);
+        bits += __builtin_popcountll(base ^ h);
+    }
+    // about half of the output bits flip on average
+    double avg = (double)bits / (sizeof(data) * 8);
+    CHECK_GT(avg, 28);
+    CHECK_LT(avg, 36);
+}
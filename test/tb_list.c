@@ -1,5 +1,7 @@
 #include "tau/tau.h"
 #include "cctrlib/list.h"
+#include "cctrlib/hash.h"
+#include "cctrlib/huge.h"
 
 TAU_MAIN()
 
@@ -181,4 +183,341 @@ TEST(List, insert_check_at)
         uint32_t tmp = test_base + i;
         list_push_back(test_list, &tmp);
     }
-}
\ No newline at end of file
+}
+
+static int _tb_is_odd_(void *data, void *ctx)
+{
+    (void)ctx;
+    return *(uint32_t *)data & 1;
+}
+
+TEST(List, remove_if_remove_value)
+{
+    const uint32_t test_len = 100;
+
+    List_t *test_list = list_init(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+        list_push_back(test_list, &i);
+
+    CHECK_EQ(test_len / 2, list_remove_if(test_list, _tb_is_odd_, NULL));
+    REQUIRE_EQ(test_len / 2, test_list->size);
+    uint32_t i = 0;
+    for (List_Node_t *ptr = test_list->head; ptr != NULL; ptr = ptr->next, i += 2)
+    {
+        CHECK_EQ(i, *(uint32_t *)ptr->data);
+        CHECK(ptr->prev == NULL || ptr->prev->next == ptr);
+    }
+    CHECK_EQ(test_len - 2, *(uint32_t *)list_back(test_list));
+
+    uint32_t tmp = 0;
+    CHECK_EQ(1, list_remove_value(test_list, &tmp));
+    tmp = test_len - 2;
+    CHECK_EQ(1, list_remove_value(test_list, &tmp));
+    CHECK_EQ(0, list_remove_value(test_list, &tmp));
+    CHECK_EQ(2, *(uint32_t *)list_front(test_list));
+    CHECK_EQ(test_len - 4, *(uint32_t *)list_back(test_list));
+    CHECK_EQ(test_len / 2 - 2, test_list->size);
+
+    list_destroy(test_list);
+}
+
+TEST(List, erase_range_unique)
+{
+    const uint32_t test_len = 20;
+
+    List_t *test_list = list_init(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        uint32_t tmp = i / 4;
+        list_push_back(test_list, &tmp);
+    }
+
+    CHECK_EQ(test_len - test_len / 4, list_unique(test_list));
+    REQUIRE_EQ(test_len / 4, test_list->size);
+    for (uint32_t i = 0; i < test_len / 4; i++)
+        CHECK_EQ(i, *(uint32_t *)list_at(test_list, i));
+
+    // [1, 3) then the last two through negative positions
+    CHECK_EQ(2, list_erase_range(test_list, 1, 3));
+    CHECK_EQ(3, *(uint32_t *)list_at(test_list, 1));
+    CHECK_EQ(2, list_erase_range(test_list, -2, test_list->size));
+    CHECK_EQ(1, test_list->size);
+    CHECK_EQ(0, *(uint32_t *)list_back(test_list));
+    CHECK_EQ(0, list_erase_range(test_list, 1, 0));
+    CHECK_EQ(1, list_erase_range(test_list, -5, 5));
+    CHECK(NULL == test_list->head);
+    CHECK(NULL == test_list->tail);
+
+    list_destroy(test_list);
+}
+
+TEST(List, compact)
+{
+    const uint32_t test_len = 100;
+
+    // churned list: single nodes, a batch and erased holes
+    List_t *test_list = list_init(sizeof(uint64_t));
+    uint64_t array[test_len];
+    for (uint64_t i = 0; i < test_len; i++)
+        array[i] = i;
+    list_push_back_n(test_list, array, test_len / 2);
+    for (uint64_t i = test_len / 2; i < test_len; i++)
+        list_insert(test_list, i % 2 ? test_list->size : 0, &i);
+    for (uint32_t i = 0; i < 10; i++)
+        list_erase(test_list, i * 5);
+
+    uint32_t len = test_list->size;
+    uint64_t expect[test_len];
+    for (uint32_t i = 0; i < len; i++)
+        expect[i] = *(uint64_t *)list_at(test_list, i);
+
+    list_compact(test_list);
+    REQUIRE_EQ(len, test_list->size);
+    CHECK(NULL == test_list->head->prev);
+    CHECK(NULL == test_list->tail->next);
+    uint32_t i = 0;
+    for (List_Node_t *ptr = test_list->head; ptr != NULL; ptr = ptr->next, i++)
+    {
+        CHECK_EQ(expect[i], *(uint64_t *)ptr->data);
+        // nodes follow each other in memory, payload inline
+        CHECK((uint8_t *)ptr->data > (uint8_t *)ptr);
+        if (ptr->next != NULL)
+        {
+            CHECK(ptr->next->prev == ptr);
+            CHECK((uint8_t *)ptr->next > (uint8_t *)ptr->data);
+            CHECK((uint8_t *)ptr->next - (uint8_t *)ptr->data < 64);
+        }
+    }
+    CHECK_EQ(len, i);
+
+    // the compacted list keeps working
+    uint64_t tmp = 1000;
+    list_insert(test_list, 3, &tmp);
+    list_erase(test_list, 0);
+    list_pop_back(test_list);
+    CHECK_EQ(1000, *(uint64_t *)list_at(test_list, 2));
+    CHECK_EQ(len - 1, test_list->size);
+
+    list_clear(test_list);
+    list_compact(test_list);
+    CHECK_EQ(0, test_list->size);
+    list_destroy(test_list);
+}
+
+TEST(List, long_traversal)
+{
+    // long enough for the skip array of make PREFETCH=1, which every change has to drop
+    const uint32_t test_len = 10000;
+
+    List_t *test_list = list_init(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+        list_push_back(test_list, &i);
+
+    // list_at and the first search walk, the second search on the same list builds the array
+    CHECK_EQ(5, *(uint32_t *)list_at(test_list, 5));
+    uint32_t key = 9000;
+    CHECK_EQ(9000, list_find(test_list, &key));
+#ifdef CCTR_PREFETCH
+    CHECK(NULL == test_list->skip);
+#endif
+    CHECK_EQ(9000, list_find(test_list, &key));
+#ifdef CCTR_PREFETCH
+    CHECK(NULL != test_list->skip);
+#endif
+    CHECK_EQ(test_len - 1, *(uint32_t *)list_at(test_list, -1));
+    CHECK_EQ(5, *(uint32_t *)list_at(test_list, 5));
+
+    list_erase(test_list, 100);
+#ifdef CCTR_PREFETCH
+    CHECK(NULL == test_list->skip);
+#endif
+    CHECK_EQ(8999, list_find(test_list, &key));
+    CHECK_EQ(101, *(uint32_t *)list_at(test_list, 100));
+#ifdef CCTR_PREFETCH
+    CHECK(NULL == test_list->skip);
+#endif
+
+    // changed between searches, no array is built for it
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        list_push_back(test_list, &i);
+        CHECK_EQ(8999, list_find(test_list, &key));
+    }
+#ifdef CCTR_PREFETCH
+    CHECK(NULL == test_list->skip);
+#endif
+    CHECK_EQ(4, list_pop_back_n(test_list, NULL, 4));
+
+    key = 100000;
+    list_insert(test_list, 3, &key);
+    CHECK_EQ(3, list_find_data_range(test_list, &key, 0, sizeof(key)));
+    CHECK_EQ(3, list_find(test_list, &key));
+    list_push_front(test_list, &key);
+    CHECK_EQ(0, list_find(test_list, &key));
+    CHECK_EQ(0, list_find_data_range(test_list, &key, 0, sizeof(key)));
+    list_pop_front(test_list);
+    CHECK_EQ(test_len - 1, *(uint32_t *)list_back(test_list));
+    CHECK_EQ(test_len - 1, *(uint32_t *)list_at(test_list, -1));
+    uint32_t missing = test_len;
+    CHECK_EQ(-1, list_find_data_range(test_list, &missing, 0, sizeof(missing)));
+
+    List_t *test_copy = list_copy(test_list);
+    REQUIRE_EQ(test_list->size, test_copy->size);
+    for (uint32_t i = 0; i < test_copy->size; i += 997)
+        CHECK_EQ(*(uint32_t *)list_at(test_list, i), *(uint32_t *)list_at(test_copy, i));
+    list_destroy(test_copy);
+
+    list_remove_value(test_list, &key);
+    CHECK_EQ(-1, list_find(test_list, &key));
+    list_clear(test_list);
+    CHECK(NULL == list_at(test_list, 0));
+    list_destroy(test_list);
+}
+
+TEST(List, small_payload)
+{
+    // up to 8 bytes the payload sits behind its node in the same allocation
+    List_t *test_small = list_init(sizeof(uint64_t));
+    List_t *test_large = list_init(2 * sizeof(uint64_t));
+    uint64_t tmp[2] = {0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        list_push_back(test_small, tmp);
+        list_push_front(test_large, tmp);
+    }
+    uint64_t other[2] = {tmp[1], tmp[0]};
+    list_insert(test_small, 1, &tmp[1]);
+    list_insert(test_large, 1, other);
+
+    for (List_Node_t *ptr = test_small->head; ptr != NULL; ptr = ptr->next)
+        CHECK((uint8_t *)ptr->data == (uint8_t *)ptr + sizeof(List_Node_t));
+    for (List_Node_t *ptr = test_large->head; ptr != NULL; ptr = ptr->next)
+        CHECK((uint8_t *)ptr->data != (uint8_t *)ptr + sizeof(List_Node_t));
+    CHECK_EQ(tmp[0], *(uint64_t *)list_front(test_small));
+    CHECK_EQ(tmp[1], *(uint64_t *)list_at(test_small, 1));
+    CHECK_EQ(1, list_find(test_small, &tmp[1]));
+    CHECK_BUF_EQ(other, list_at(test_large, 1), sizeof(other));
+
+    list_erase(test_small, 1);
+    list_pop_front(test_small);
+    CHECK_EQ(-1, list_find(test_small, &tmp[1]));
+    CHECK_EQ(2, test_small->size);
+    list_destroy(test_small);
+    list_destroy(test_large);
+}
+
+TEST(List, huge)
+{
+    // 24 byte payloads in slots of 2 MB regions, past one region
+    const uint32_t test_len = 100000;
+    uint64_t tmp[3];
+    List_t *test_list = list_init_huge(sizeof(tmp));
+    REQUIRE(test_list->huge != NULL);
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        tmp[0] = tmp[1] = tmp[2] = i;
+        list_push_back(test_list, tmp);
+    }
+    CHECK((uint8_t *)test_list->head->data == (uint8_t *)test_list->head + CCTR_ALIGN(sizeof(List_Node_t)));
+    if (test_list->head->block->map_size != 0)
+        CHECK_EQ(0, (uintptr_t)test_list->head->block % CCTR_HUGE_PAGE);
+    CHECK(test_list->head->block != test_list->tail->block);
+
+    // batches, lists of both kinds spliced in, erases and a compaction
+    uint64_t batch[3 * 4] = {0};
+    list_push_front_n(test_list, batch, 4);
+    List_t *plain = list_init(sizeof(tmp));
+    tmp[0] = tmp[1] = tmp[2] = 7;
+    list_push_back(plain, tmp);
+    list_insert_list(test_list, 4, plain);
+    List_t *cpy = list_copy(test_list);
+    CHECK(cpy->huge != NULL);
+    list_insert_list(test_list, 0, cpy);
+    list_destroy(cpy);
+    list_destroy(plain);
+    list_erase_range(test_list, 0, test_len + 5);
+    CHECK_EQ(test_len + 5, test_list->size);
+    for (uint32_t i = 0; i < 1000; i++)
+        list_erase(test_list, 4 * i);
+    list_compact(test_list);
+
+    CHECK_EQ(test_len + 5 - 1000, test_list->size);
+    CHECK_EQ(7, *(uint64_t *)list_at(test_list, 3));
+    CHECK_EQ(test_len - 1, *(uint64_t *)list_back(test_list));
+    uint64_t key[3] = {test_len - 10, test_len - 10, test_len - 10};
+    CHECK_EQ(test_len + 5 - 1000 - 10, list_find(test_list, key));
+    list_clear(test_list);
+    list_push_back(test_list, tmp);
+    CHECK_EQ(7, *(uint64_t *)list_front(test_list));
+    list_destroy(test_list);
+}
+
+TEST(List, equal_compare_hash)
+{
+    const uint32_t test_len = 10000;
+    List_t *test_list = list_init(sizeof(uint32_t));
+    uint32_t *test_arr = (uint32_t *)malloc(test_len * sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        test_arr[i] = i * 2654435761u;
+        list_push_back(test_list, &test_arr[i]);
+    }
+    List_t *cpy = list_from_array(test_arr, test_len, sizeof(uint32_t));
+    CHECK_TRUE(list_equal(test_list, cpy));
+    CHECK_EQ(0, list_compare(test_list, cpy));
+    CHECK_EQ(0, list_compare(test_list, test_list));
+
+    // the payloads back to back, whichever way they are stored
+    uint64_t hash = list_hash(test_list);
+    CHECK_EQ(cctr_hash(test_arr, test_len * sizeof(uint32_t), CCTR_HASH_SEED), hash);
+    CHECK_EQ(hash, list_hash(cpy));
+
+    // unchanged while the version stays, O(1) on a second call
+    uint64_t version = test_list->version;
+    CHECK_EQ(hash, list_hash(test_list));
+    CHECK_EQ(version, test_list->version);
+    List_t *cpy2 = list_copy(test_list);
+    CHECK_EQ(cpy2->version, cpy2->hash_version);
+    CHECK_EQ(hash, list_hash(cpy2));
+
+    // a changed element, memcmp order decides
+    uint32_t big = UINT32_MAX;
+    list_erase(cpy, 5000);
+    list_insert(cpy, 5000, &big);
+    CHECK_FALSE(list_equal(test_list, cpy));
+    CHECK_NE(hash, list_hash(cpy));
+    CHECK_EQ(-1, list_compare(test_list, cpy));
+    CHECK_EQ(1, list_compare(cpy, test_list));
+    // both hashes current and different, no walk needed
+    CHECK_FALSE(list_equal(cpy, test_list));
+
+    // a shorter list with the same prefix comes first
+    list_pop_back(cpy2);
+    CHECK_NE(cpy2->version, cpy2->hash_version);
+    CHECK_FALSE(list_equal(test_list, cpy2));
+    CHECK_EQ(1, list_compare(test_list, cpy2));
+    CHECK_EQ(-1, list_compare(cpy2, test_list));
+    CHECK_EQ(cctr_hash(test_arr, (test_len - 1) * sizeof(uint32_t), CCTR_HASH_SEED), list_hash(cpy2));
+
+    // writes in place are announced with list_touch
+    *(uint32_t *)list_at(test_list, 3) += 1;
+    CHECK_EQ(hash, list_hash(test_list));
+    list_touch(test_list);
+    CHECK_NE(hash, list_hash(test_list));
+    *(uint32_t *)list_at(test_list, 3) -= 1;
+    list_touch(test_list);
+    CHECK_EQ(hash, list_hash(test_list));
+
+    // empty lists
+    list_clear(cpy);
+    list_clear(cpy2);
+    CHECK_TRUE(list_equal(cpy, cpy2));
+    CHECK_EQ(0, list_compare(cpy, cpy2));
+    CHECK_EQ(-1, list_compare(cpy, test_list));
+    CHECK_EQ(cctr_hash(NULL, 0, CCTR_HASH_SEED), list_hash(cpy));
+
+    list_destroy(cpy2);
+    list_destroy(cpy);
+    list_destroy(test_list);
+    free(test_arr);
+}
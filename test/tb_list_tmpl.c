@@ -0,0 +1,81 @@
+#include "tau/tau.h"
+
+#define CCTR_T uint32_t
+#include "cctrlib/list_tmpl.h"
+
+typedef struct
+{
+    uint32_t key;
+    uint8_t value[12];
+} Tb_Pair_t;
+
+#define CCTR_T Tb_Pair_t
+#define CCTR_EQ(a, b) ((a).key == (b).key)
+#include "cctrlib/list_tmpl.h"
+
+TEST(List_tmpl, push_pop_at)
+{
+    const uint32_t test_base = 0x33221100;
+    const uint32_t test_len = 10;
+
+    List_uint32_t *test_list = list_uint32_t_init();
+    for (uint32_t i = 0; i < test_len; i++)
+        list_uint32_t_push_back(test_list, test_base + i);
+
+    REQUIRE_EQ(test_len, test_list->size);
+    for (int32_t i = 0; i < (int32_t)test_len; i++)
+    {
+        CHECK_EQ(test_base + i, *list_uint32_t_at(test_list, i));
+        CHECK_EQ(test_base + test_len - 1 - i, *list_uint32_t_at(test_list, -1 - i));
+    }
+    CHECK(NULL == list_uint32_t_at(test_list, test_len));
+
+    list_uint32_t_pop_front(test_list);
+    list_uint32_t_pop_back(test_list);
+    CHECK_EQ(test_base + 1, *list_uint32_t_front(test_list));
+    CHECK_EQ(test_base + test_len - 2, *list_uint32_t_back(test_list));
+
+    list_uint32_t_destroy(test_list);
+}
+
+TEST(List_tmpl, insert_erase_find)
+{
+    const uint32_t test_base = 0x33221100;
+
+    List_uint32_t *test_list = list_uint32_t_init();
+    list_uint32_t_insert(test_list, 0, test_base + 3);
+    list_uint32_t_insert(test_list, 0, test_base + 0);
+    list_uint32_t_insert(test_list, 1, test_base + 1);
+    list_uint32_t_insert(test_list, -1, test_base + 2);
+    list_uint32_t_insert(test_list, test_list->size, test_base + 4);
+
+    REQUIRE_EQ(5, test_list->size);
+    for (uint32_t i = 0; i < 5; i++)
+        CHECK_EQ((int32_t)i, list_uint32_t_find(test_list, test_base + i));
+    CHECK_EQ(-1, list_uint32_t_find(test_list, test_base + 5));
+
+    list_uint32_t_erase(test_list, 2);
+    list_uint32_t_erase(test_list, -1);
+    list_uint32_t_erase(test_list, 0);
+    CHECK_EQ(2, test_list->size);
+    CHECK_EQ(test_base + 1, *list_uint32_t_front(test_list));
+    CHECK_EQ(test_base + 3, *list_uint32_t_back(test_list));
+
+    List_uint32_t *cpy = list_uint32_t_copy(test_list);
+    CHECK_EQ(1, list_uint32_t_find(cpy, test_base + 3));
+
+    list_uint32_t_destroy(cpy);
+    list_uint32_t_destroy(test_list);
+}
+
+TEST(List_tmpl, struct_type)
+{
+    Tb_Pair_t pairs[3] = {{1, {0}}, {2, {0}}, {3, {0}}};
+    List_Tb_Pair_t *test_list = list_Tb_Pair_t_from_array(pairs, 3);
+
+    Tb_Pair_t key = {3, {0xff}};
+    CHECK_EQ(2, list_Tb_Pair_t_find(test_list, key));
+    CHECK_EQ(2, list_Tb_Pair_t_at(test_list, 1)->key);
+
+    list_Tb_Pair_t_destroy(test_list);
+}
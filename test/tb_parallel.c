@@ -0,0 +1,146 @@
+#include "tau/tau.h"
+#include "cctrlib/parallel.h"
+
+#define TB_PAR_LEN 10007
+
+static int _tb_is_odd_(void *data, void *ctx)
+{
+    return (*(uint32_t *)data & 1) != 0;
+}
+
+static int _tb_is_equal_(void *data, void *ctx)
+{
+    return *(uint32_t *)data == *(uint32_t *)ctx;
+}
+
+static void _tb_double_(void *data, void *ctx)
+{
+    *(uint32_t *)data *= 2;
+}
+
+static void _tb_sum_(void *acc, void *data, void *ctx)
+{
+    *(uint64_t *)acc += *(uint32_t *)data;
+}
+
+static void _tb_hit_(void *ctx, uint32_t task)
+{
+    __atomic_fetch_add(&((uint32_t *)ctx)[task], 1, __ATOMIC_RELAXED);
+}
+
+static void _tb_combine_(void *acc, void *part, void *ctx)
+{
+    *(uint64_t *)acc += *(uint64_t *)part;
+}
+
+TEST(Parallel, pool_run)
+{
+    Cctr_Pool_t *test_pool = cctr_pool_construct(3);
+    CHECK_EQ(4, cctr_pool_concurrency(test_pool));
+
+    // every task runs exactly once, over several jobs on the same pool
+    uint32_t hits[100];
+    for (uint32_t round = 0; round < 50; round++)
+    {
+        memset(hits, 0, sizeof(hits));
+        cctr_pool_run(test_pool, 1 + round * 2, _tb_hit_, hits);
+        for (uint32_t i = 0; i < 100; i++)
+            CHECK_EQ(i < 1 + round * 2 ? 1 : 0, hits[i]);
+    }
+    cctr_pool_destroy(test_pool);
+
+    // without workers everything runs on the caller
+    memset(hits, 0, sizeof(hits));
+    cctr_pool_run(NULL, 10, _tb_hit_, hits);
+    CHECK_EQ(1, hits[9]);
+}
+
+TEST(Parallel, list)
+{
+    List_t *test_list = list_init(sizeof(uint32_t));
+    uint64_t test_sum = 0;
+    for (uint32_t i = 0; i < TB_PAR_LEN; i++)
+    {
+        list_push_back(test_list, &i);
+        test_sum += i;
+    }
+    Cctr_Pool_t *test_pool = cctr_pool_construct(3);
+
+    // with and without a prebuilt index, and on the caller only
+    List_Index_t *test_index = list_index_build(test_list, 13);
+    REQUIRE_EQ(13, test_index->count);
+    CHECK(test_index->start[0] == test_list->head);
+    CHECK_EQ(TB_PAR_LEN * 12 / 13, *(uint32_t *)test_index->start[12]->data);
+
+    CHECK_EQ(TB_PAR_LEN / 2, list_par_count(test_list, test_index, test_pool, _tb_is_odd_, NULL));
+    CHECK_EQ(TB_PAR_LEN / 2, list_par_count(test_list, NULL, test_pool, _tb_is_odd_, NULL));
+    CHECK_EQ(TB_PAR_LEN / 2, list_par_count(test_list, NULL, NULL, _tb_is_odd_, NULL));
+
+    uint64_t sum = 0;
+    list_par_reduce(test_list, test_index, test_pool, &sum, sizeof(sum), _tb_sum_, _tb_combine_, NULL);
+    CHECK_EQ(test_sum, sum);
+
+    // the first match wins even if a later segment finds one sooner
+    uint32_t target = 9000;
+    CHECK_EQ(9000, list_par_find_first(test_list, test_index, test_pool, _tb_is_equal_, &target));
+    *(uint32_t *)list_at(test_list, 9500) = 100;
+    target = 100;
+    CHECK_EQ(100, list_par_find_first(test_list, test_index, test_pool, _tb_is_equal_, &target));
+    target = TB_PAR_LEN;
+    CHECK_EQ(-1, list_par_find_first(test_list, test_index, test_pool, _tb_is_equal_, &target));
+
+    list_par_for_each(test_list, test_index, test_pool, _tb_double_, NULL);
+    CHECK_EQ(0, list_par_count(test_list, test_index, test_pool, _tb_is_odd_, NULL));
+    CHECK_EQ(2 * 9000, *(uint32_t *)list_at(test_list, 9000));
+
+    // as many erased as inserted, the same size but freed start nodes, the stale index is not walked
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        uint32_t odd = 2 * i + 1;
+        list_pop_front(test_list);
+        list_push_back(test_list, &odd);
+    }
+    REQUIRE_EQ(test_index->size, test_list->size);
+    CHECK_EQ(100, list_par_count(test_list, test_index, test_pool, _tb_is_odd_, NULL));
+
+    list_index_destroy(test_index);
+
+    // empty list
+    List_t *test_empty = list_init(sizeof(uint32_t));
+    CHECK_EQ(0, list_par_count(test_empty, NULL, test_pool, _tb_is_odd_, NULL));
+    CHECK_EQ(-1, list_par_find_first(test_empty, NULL, test_pool, _tb_is_equal_, &target));
+    list_destroy(test_empty);
+
+    cctr_pool_destroy(test_pool);
+    list_destroy(test_list);
+}
+
+TEST(Parallel, array)
+{
+    Array_t *test_array = array_construct(sizeof(uint32_t));
+    uint64_t test_sum = 0;
+    for (uint32_t i = 0; i < TB_PAR_LEN; i++)
+    {
+        array_push_back(test_array, &i);
+        test_sum += i;
+    }
+    Cctr_Pool_t *test_pool = cctr_pool_construct(3);
+
+    CHECK_EQ(TB_PAR_LEN / 2, array_par_count(test_array, test_pool, _tb_is_odd_, NULL));
+
+    uint64_t sum = 0;
+    array_par_reduce(test_array, test_pool, &sum, sizeof(sum), _tb_sum_, _tb_combine_, NULL);
+    CHECK_EQ(test_sum, sum);
+
+    uint32_t target = 7;
+    CHECK_EQ(7, array_par_find_first(test_array, test_pool, _tb_is_equal_, &target));
+    *(uint32_t *)array_at(test_array, TB_PAR_LEN - 1) = 7;
+    CHECK_EQ(7, array_par_find_first(test_array, test_pool, _tb_is_equal_, &target));
+
+    array_par_for_each(test_array, test_pool, _tb_double_, NULL);
+    CHECK_EQ(0, array_par_count(test_array, test_pool, _tb_is_odd_, NULL));
+    CHECK_EQ(2 * 100, *(uint32_t *)array_at(test_array, 100));
+
+    cctr_pool_destroy(test_pool);
+    array_destroy(test_array);
+}
@@ -0,0 +1,182 @@
+#include <pthread.h>
+#include "tau/tau.h"
+#include "cctrlib/plist.h"
+
+static void _tb_plist_sum_(const void *data, void *ctx)
+{
+    *(uint64_t *)ctx += *(const uint32_t *)data;
+}
+
+static int _tb_plist_equal_(Plist_t *plist, List_t *list)
+{
+    // compares through plist_at, the ranks are checked on the way
+    if (plist->size != list->size)
+        return 0;
+    uint64_t i = 0;
+    for (List_Node_t *ptr = list->head; ptr != NULL; ptr = ptr->next, i++)
+        if (memcmp(plist_at(plist, i), ptr->data, plist->dsize))
+            return 0;
+    return plist_at(plist, i) == NULL;
+}
+
+TEST(Plist, list_ops)
+{
+    // the same random operations on a Plist_t and a List_t
+    Plist_t *test_plist = plist_construct(sizeof(uint32_t));
+    List_t *test_list = list_init(sizeof(uint32_t));
+    uint64_t seed = 3;
+
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = (uint32_t)(seed >> 33);
+        uint32_t op = r % 10;
+        uint64_t pos = test_list->size > 0 ? (r >> 4) % test_list->size : 0;
+
+        if (op < 3)
+        {
+            plist_push_back(test_plist, &i);
+            list_push_back(test_list, &i);
+        }
+        else if (op < 4)
+        {
+            plist_push_front(test_plist, &i);
+            list_push_front(test_list, &i);
+        }
+        else if (op < 6 && test_list->size > 0)
+        {
+            plist_insert(test_plist, pos, &i);
+            list_insert(test_list, pos, &i);
+        }
+        else if (op < 8 && test_list->size > 0)
+        {
+            plist_erase(test_plist, pos);
+            list_erase(test_list, pos);
+        }
+        else if (op < 9 && test_list->size > 0)
+        {
+            plist_set(test_plist, pos, &i);
+            *(uint32_t *)list_at(test_list, pos) = i;
+        }
+        else
+        {
+            plist_pop_front(test_plist);
+            list_pop_front(test_list);
+        }
+    }
+    CHECK(_tb_plist_equal_(test_plist, test_list));
+
+    List_t *test_copy = plist_to_list(test_plist);
+    Plist_t *test_back = plist_from_list(test_copy);
+    CHECK(_tb_plist_equal_(test_back, test_list));
+    plist_destroy(test_back);
+    list_destroy(test_copy);
+
+    while (test_plist->size > 0)
+        plist_pop_back(test_plist);
+    CHECK(NULL == test_plist->root);
+    CHECK(NULL == plist_at(test_plist, 0));
+
+    plist_destroy(test_plist);
+    list_destroy(test_list);
+}
+
+TEST(Plist, snapshot)
+{
+    const uint32_t test_len = 10000;
+
+    Plist_t *test_plist = plist_construct(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+        plist_push_back(test_plist, &i);
+
+    Plist_t *test_snap = plist_snapshot(test_plist);
+    CHECK(test_snap->root == test_plist->root);
+    CHECK_EQ(2, test_plist->root->refs);
+
+    // a change copies its path only, the rest stays shared
+    uint32_t tmp = 123456;
+    plist_set(test_plist, 10, &tmp);
+    CHECK(test_snap->root != test_plist->root);
+    CHECK_EQ(10, *(const uint32_t *)plist_at(test_snap, 10));
+    CHECK_EQ(123456, *(const uint32_t *)plist_at(test_plist, 10));
+    CHECK(plist_at(test_snap, 9000) == plist_at(test_plist, 9000));
+    CHECK(plist_at(test_snap, 10) != plist_at(test_plist, 10));
+
+    plist_insert(test_plist, 5000, &tmp);
+    plist_erase(test_plist, 0);
+    plist_push_front(test_plist, &tmp);
+    plist_pop_back(test_plist);
+    CHECK_EQ(test_len, test_snap->size);
+    CHECK_EQ(test_len, test_plist->size);
+    for (uint32_t i = 0; i < test_len; i++)
+        REQUIRE_EQ(i, *(const uint32_t *)plist_at(test_snap, i));
+    CHECK_EQ(123456, *(const uint32_t *)plist_at(test_plist, 0));
+    CHECK_EQ(123456, *(const uint32_t *)plist_at(test_plist, 10));
+    CHECK_EQ(123456, *(const uint32_t *)plist_at(test_plist, 5000));
+    CHECK_EQ(test_len - 2, *(const uint32_t *)plist_at(test_plist, test_len - 1));
+
+    // the original outlives its snapshot and the other way round
+    plist_destroy(test_plist);
+    uint64_t sum = 0;
+    plist_for_each(test_snap, _tb_plist_sum_, &sum);
+    CHECK_EQ((uint64_t)test_len * (test_len - 1) / 2, sum);
+    Plist_t *test_snap2 = plist_snapshot(test_snap);
+    plist_destroy(test_snap);
+    plist_pop_front(test_snap2);
+    CHECK_EQ(1, *(const uint32_t *)plist_at(test_snap2, 0));
+    plist_destroy(test_snap2);
+}
+
+typedef struct
+{
+    Plist_t *snap;
+    uint64_t sum;
+} Tb_Plist_Reader_t;
+
+static void *_tb_plist_reader_(void *arg)
+{
+    Tb_Plist_Reader_t *reader = (Tb_Plist_Reader_t *)arg;
+    for (uint32_t round = 0; round < 20; round++)
+    {
+        reader->sum = 0;
+        plist_for_each(reader->snap, _tb_plist_sum_, &reader->sum);
+    }
+    plist_destroy(reader->snap);
+    return NULL;
+}
+
+TEST(Plist, threads)
+{
+    const uint32_t test_len = 5000;
+    const uint32_t test_readers = 4;
+
+    Plist_t *test_plist = plist_construct(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+        plist_push_back(test_plist, &i);
+
+    // every reader gets its own snapshot while the writer keeps changing the list
+    pthread_t threads[test_readers];
+    Tb_Plist_Reader_t readers[test_readers];
+    uint64_t expect[test_readers];
+    for (uint32_t t = 0; t < test_readers; t++)
+    {
+        readers[t].snap = plist_snapshot(test_plist);
+        expect[t] = 0;
+        plist_for_each(readers[t].snap, _tb_plist_sum_, &expect[t]);
+        pthread_create(&threads[t], NULL, _tb_plist_reader_, &readers[t]);
+
+        for (uint32_t i = 0; i < 500; i++)
+        {
+            uint32_t tmp = i;
+            plist_set(test_plist, (i * 7919) % test_len, &tmp);
+            plist_push_back(test_plist, &tmp);
+            plist_erase(test_plist, 0);
+        }
+    }
+    for (uint32_t t = 0; t < test_readers; t++)
+    {
+        pthread_join(threads[t], NULL);
+        CHECK_EQ(expect[t], readers[t].sum);
+    }
+    plist_destroy(test_plist);
+}
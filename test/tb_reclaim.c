@@ -0,0 +1,193 @@
+#include <pthread.h>
+#include <unistd.h>
+#include "tau/tau.h"
+#include "cctrlib/huge.h"
+#include "cctrlib/list.h"
+#include "cctrlib/reclaim.h"
+
+static uint64_t _tb_depth_(void)
+{
+    Cctr_Reclaim_Stats_t stats;
+    cctr_reclaim_stats(&stats);
+    return stats.depth;
+}
+
+TEST(Reclaim, list_defer)
+{
+    const uint32_t test_len = 1000;
+    cctr_reclaim(UINT64_MAX);
+    Cctr_Reclaim_Stats_t before;
+    cctr_reclaim_stats(&before);
+    REQUIRE_EQ(0, before.depth);
+
+    // payloads apart from the node and inside it
+    for (uint32_t dsize = 4; dsize <= 64; dsize += 60)
+    {
+        List_t *test_list = list_init(dsize);
+        list_defer_free(test_list, 1);
+        uint8_t data[64] = {0};
+        for (uint32_t i = 0; i < test_len; i++)
+        {
+            data[0] = (uint8_t)i;
+            list_push_back(test_list, data);
+        }
+        list_pop_front(test_list);
+        list_pop_back(test_list);
+        list_erase(test_list, 10);
+        CHECK_EQ(12, *(uint8_t *)list_at(test_list, 10));
+
+        // staged in the list until there are CCTR_RECLAIM_STAGE
+        CHECK_EQ(0, _tb_depth_());
+        CHECK_EQ(3, test_list->defer->count);
+        list_defer_free(test_list, 0);
+        CHECK_EQ(3, _tb_depth_());
+        list_defer_free(test_list, 1);
+
+        // in bounded steps
+        CHECK_EQ(2, cctr_reclaim(2));
+        CHECK_EQ(1, _tb_depth_());
+        CHECK_EQ(1, cctr_reclaim(100));
+        CHECK_EQ(0, cctr_reclaim(100));
+
+        CHECK_EQ(CCTR_RECLAIM_STAGE, list_pop_front_n(test_list, NULL, CCTR_RECLAIM_STAGE));
+        CHECK_EQ(CCTR_RECLAIM_STAGE, _tb_depth_());
+        CHECK_EQ(CCTR_RECLAIM_STAGE, cctr_reclaim(UINT64_MAX));
+
+        List_t *cpy = list_copy(test_list);
+        CHECK_TRUE(cpy->defer != NULL);
+        list_destroy(cpy);
+        list_destroy(test_list);
+        CHECK_EQ(2 * (test_len - 3 - CCTR_RECLAIM_STAGE), _tb_depth_());
+        CHECK_EQ(2 * (test_len - 3 - CCTR_RECLAIM_STAGE), cctr_reclaim(UINT64_MAX));
+    }
+
+    Cctr_Reclaim_Stats_t after;
+    cctr_reclaim_stats(&after);
+    CHECK_EQ(0, after.depth);
+    CHECK_EQ(after.deferred - before.deferred, after.reclaimed - before.reclaimed);
+    CHECK_GE(after.peak, 2 * (test_len - 3 - CCTR_RECLAIM_STAGE));
+}
+
+TEST(Reclaim, blocks)
+{
+    // a block of a batch is queued with its last node only
+    const uint32_t test_len = 100;
+    uint64_t arr[100];
+    for (uint32_t i = 0; i < test_len; i++)
+        arr[i] = i;
+    cctr_reclaim(UINT64_MAX);
+
+    List_t *test_list = list_init(sizeof(uint64_t));
+    list_defer_free(test_list, 1);
+    list_push_back_n(test_list, arr, test_len);
+    list_push_back(test_list, &arr[5]);
+    CHECK_EQ(test_len - 1, list_pop_front_n(test_list, NULL, test_len - 1));
+    CHECK_EQ(0, test_list->defer->count);
+    list_pop_front(test_list);
+    CHECK_EQ(1, test_list->defer->count);
+    list_clear(test_list);
+    CHECK_EQ(2, _tb_depth_());
+    list_destroy(test_list);
+    CHECK_EQ(2, cctr_reclaim(UINT64_MAX));
+
+    // huge page regions, the one the arena holds goes with destroy
+    List_t *huge_list = list_init_huge(sizeof(uint64_t));
+    list_defer_free(huge_list, 1);
+    for (uint32_t i = 0; i < 200000; i++)
+        list_push_back(huge_list, &(uint64_t){i});
+    uint64_t regions = 200000 / ((CCTR_HUGE_REGION - CCTR_BLOCK_HEADER) / huge_list->huge->stride) + 1;
+    list_destroy(huge_list);
+    CHECK_EQ(regions, _tb_depth_());
+    CHECK_EQ(regions, cctr_reclaim(UINT64_MAX));
+}
+
+static void *_tb_reclaim_task_(void *arg)
+{
+    List_t *list = (List_t *)arg;
+    for (uint32_t round = 0; round < 20; round++)
+    {
+        for (uint64_t i = 0; i < 5000; i++)
+            list_push_back(list, &i);
+        while (list->size > 100)
+            list_pop_front(list);
+        list_clear(list);
+    }
+    return NULL;
+}
+
+TEST(Reclaim, thread)
+{
+    cctr_reclaim(UINT64_MAX);
+    REQUIRE_EQ(0, cctr_reclaim_start(1000, 100));
+    CHECK_EQ(-1, cctr_reclaim_start(1000, 100));
+
+    // two threads queue while the reclaimer releases
+    List_t *lists[2];
+    pthread_t threads[2];
+    for (int t = 0; t < 2; t++)
+    {
+        lists[t] = list_init(sizeof(uint64_t));
+        list_defer_free(lists[t], 1);
+        REQUIRE_EQ(0, pthread_create(&threads[t], NULL, _tb_reclaim_task_, lists[t]));
+    }
+    for (int t = 0; t < 2; t++)
+    {
+        pthread_join(threads[t], NULL);
+        list_destroy(lists[t]);
+    }
+    for (int i = 0; i < 1000 && _tb_depth_() > 0; i++)
+        usleep(1000);
+    CHECK_EQ(0, _tb_depth_());
+    cctr_reclaim_stop();
+    CHECK_EQ(0, _tb_depth_());
+}
+
+static void *_tb_start_task_(void *arg)
+{
+    *(int *)arg = cctr_reclaim_start(1000, 100);
+    return NULL;
+}
+
+TEST(Reclaim, start_race)
+{
+    // of concurrent starts exactly one gets the thread, which stop joins
+    int ret[8];
+    pthread_t threads[8];
+    for (int t = 0; t < 8; t++)
+        REQUIRE_EQ(0, pthread_create(&threads[t], NULL, _tb_start_task_, &ret[t]));
+    int started = 0;
+    for (int t = 0; t < 8; t++)
+    {
+        pthread_join(threads[t], NULL);
+        started += ret[t] == 0;
+    }
+    CHECK_EQ(1, started);
+    cctr_reclaim_stop();
+    REQUIRE_EQ(0, cctr_reclaim_start(1000, 100));
+    cctr_reclaim_stop();
+}
+
+static void *_tb_start_stop_task_(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < 50; i++)
+    {
+        cctr_reclaim_start(1000, 10);
+        cctr_reclaim_stop();
+    }
+    return NULL;
+}
+
+TEST(Reclaim, start_stop_race)
+{
+    // starts and stops interleaved from four threads, every thread started is joined
+    pthread_t threads[4];
+    for (int t = 0; t < 4; t++)
+        REQUIRE_EQ(0, pthread_create(&threads[t], NULL, _tb_start_stop_task_, NULL));
+    for (int t = 0; t < 4; t++)
+        pthread_join(threads[t], NULL);
+    cctr_reclaim_stop();
+    REQUIRE_EQ(0, cctr_reclaim_start(1000, 10));
+    cctr_reclaim_stop();
+    CHECK_EQ(0, _tb_depth_());
+}
@@ -0,0 +1,105 @@
+#include "tau/tau.h"
+#include "cctrlib/rope.h"
+
+typedef struct
+{
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+} Tb_Rope_Elem_t;
+
+static int _tb_rope_depth_ok_(Rope_Node_t *node, int depth, int *leaf_depth)
+{
+    // every leaf at the same depth, sizes add up
+    if (node->leaf)
+    {
+        if (*leaf_depth < 0)
+            *leaf_depth = depth;
+        return *leaf_depth == depth && node->size == node->count && node->count > 0;
+    }
+    uint64_t size = 0;
+    for (uint32_t i = 0; i < node->count; i++)
+    {
+        if (!_tb_rope_depth_ok_(node->child[i], depth + 1, leaf_depth))
+            return 0;
+        size += node->child[i]->size;
+    }
+    return size == node->size && node->count > 0;
+}
+
+TEST(Rope, edits)
+{
+    // random run inserts and erases at random places against a plain buffer
+    const uint32_t test_cap = 100000;
+    const uint32_t ds = sizeof(Tb_Rope_Elem_t);
+    Tb_Rope_Elem_t *model = (Tb_Rope_Elem_t *)malloc(test_cap * ds);
+    Tb_Rope_Elem_t *out = (Tb_Rope_Elem_t *)malloc(test_cap * ds);
+    Tb_Rope_Elem_t run[300];
+    uint64_t size = 0;
+    uint64_t seed = 17;
+    Rope_t *test_rope = rope_construct(ds);
+
+    for (uint32_t i = 0; i < 4000; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = (uint32_t)(seed >> 33);
+        uint64_t pos = size ? (r >> 9) % (size + 1) : 0;
+        uint32_t n = (r >> 1) % 300;
+        if (r % 5 < 3 && size + n <= test_cap)
+        {
+            for (uint32_t k = 0; k < n; k++)
+                run[k] = (Tb_Rope_Elem_t){i, k, i ^ k};
+            rope_insert(test_rope, pos, run, n);
+            memmove(model + pos + n, model + pos, (size - pos) * ds);
+            memcpy(model + pos, run, (uint64_t)n * ds);
+            size += n;
+        }
+        else
+        {
+            n = n < size - pos ? n : (uint32_t)(size - pos);
+            rope_erase(test_rope, pos, n);
+            memmove(model + pos, model + pos + n, (size - pos - n) * ds);
+            size -= n;
+        }
+        REQUIRE_EQ(size, test_rope->size);
+    }
+    int leaf_depth = -1;
+    REQUIRE(test_rope->root != NULL);
+    CHECK(_tb_rope_depth_ok_(test_rope->root, 0, &leaf_depth));
+
+    rope_export(test_rope, out);
+    CHECK_BUF_EQ(model, out, size * ds);
+    for (uint64_t pos = 0; pos < size; pos += 101)
+        REQUIRE_BUF_EQ(model + pos, rope_at(test_rope, pos), ds);
+    CHECK(NULL == rope_at(test_rope, size));
+    rope_copy_out(test_rope, size / 3, size / 2, out);
+    CHECK_BUF_EQ(model + size / 3, out, size / 2 * ds);
+
+    rope_erase(test_rope, 0, size);
+    CHECK(NULL == test_rope->root);
+    rope_destroy(test_rope);
+    free(model);
+    free(out);
+}
+
+TEST(Rope, append_fills_leaves)
+{
+    uint8_t text[10000];
+    for (uint32_t i = 0; i < sizeof(text); i++)
+        text[i] = (uint8_t)(i * 31);
+    Rope_t *test_rope = rope_construct(1);
+    for (uint32_t i = 0; i < sizeof(text); i += 100)
+        rope_insert(test_rope, test_rope->size, text + i, 100);
+    CHECK_EQ(sizeof(text), test_rope->size);
+
+    // full leaves of 1024 bytes, only the last one partly empty
+    REQUIRE(!test_rope->root->leaf);
+    CHECK_EQ(10, test_rope->root->count);
+    for (uint32_t i = 0; i + 1 < test_rope->root->count; i++)
+        CHECK_EQ(test_rope->leaf_cap, test_rope->root->child[i]->count);
+
+    uint8_t out[sizeof(text)];
+    rope_export(test_rope, out);
+    CHECK_BUF_EQ(text, out, sizeof(text));
+    rope_destroy(test_rope);
+}
@@ -0,0 +1,116 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "tau/tau.h"
+#include "cctrlib/serialize.h"
+
+static void _tb_tmp_path_(char *path)
+{
+    strcpy(path, "/tmp/tb_cctr_XXXXXX");
+    int fd = mkstemp(path);
+    close(fd);
+}
+
+TEST(Serialize, list_save_load)
+{
+    const uint32_t test_len = 1000;
+    char path[32];
+    _tb_tmp_path_(path);
+
+    List_t *test_list = list_init(sizeof(uint64_t));
+    for (uint64_t i = 0; i < test_len; i++)
+    {
+        uint64_t tmp = 0x7766554433221100 + i;
+        list_push_back(test_list, &tmp);
+    }
+    REQUIRE_EQ(0, list_save(test_list, path));
+
+    List_t *loaded = list_load(path);
+    REQUIRE(loaded != NULL);
+    REQUIRE_EQ(test_len, loaded->size);
+    CHECK_EQ(sizeof(uint64_t), loaded->dsize);
+    for (List_Node_t *a = test_list->head, *b = loaded->head; a != NULL; a = a->next, b = b->next)
+        CHECK_EQ(*(uint64_t *)a->data, *(uint64_t *)b->data);
+
+    // the same file read as a contiguous array
+    Array_t *array = array_load(path);
+    REQUIRE(array != NULL);
+    CHECK_EQ(test_len, array->size);
+    CHECK_EQ(0x7766554433221100 + test_len - 1, *(uint64_t *)array_back(array));
+
+    array_destroy(array);
+    list_destroy(loaded);
+    list_destroy(test_list);
+    unlink(path);
+}
+
+TEST(Serialize, array_map_promote)
+{
+    const uint32_t test_len = 5000;
+    char path[32];
+    _tb_tmp_path_(path);
+
+    Array_t *test_array = array_construct(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+        array_push_back(test_array, &i);
+    REQUIRE_EQ(0, array_save(test_array, path));
+
+    Array_t *view = array_map(path);
+    REQUIRE(view != NULL);
+    CHECK(view->flags & CCTR_ARRAY_READONLY);
+    REQUIRE_EQ(test_len, view->size);
+    CHECK_BUF_EQ(test_array->data, view->data, test_len * sizeof(uint32_t));
+    CHECK_EQ(0, (uintptr_t)view->data % 64);
+
+    uint32_t key = 4321;
+    CHECK_EQ(4321, array_find(view, &key));
+
+    // writes after promote stay private to the mapping
+    array_promote(view);
+    *(uint32_t *)array_at(view, 0) = 0xdeadbeef;
+    array_push_back(view, &key);
+    CHECK_EQ(test_len + 1, view->size);
+    CHECK_EQ(0xdeadbeef, *(uint32_t *)array_front(view));
+    CHECK_FALSE(view->flags & CCTR_ARRAY_MAPPED);
+
+    Array_t *again = array_map(path);
+    REQUIRE(again != NULL);
+    CHECK_EQ(0, *(uint32_t *)array_front(again));
+
+    array_destroy(again);
+    array_destroy(view);
+    array_destroy(test_array);
+    unlink(path);
+}
+
+TEST(Serialize, reject_invalid)
+{
+    char path[32];
+    _tb_tmp_path_(path);
+
+    FILE *fp = fopen(path, "wb");
+    fputs("not a container file, but long enough to hold a header ..........", fp);
+    fclose(fp);
+
+    CHECK(NULL == list_load(path));
+    CHECK(NULL == array_map(path));
+    CHECK(NULL == array_load("/nonexistent/cctr"));
+
+    // a valid file with more elements than a List_t counts, the payload a hole
+    Array_t *test_array = array_construct(sizeof(uint8_t));
+    REQUIRE_EQ(0, array_save(test_array, path));
+    int fd = open(path, O_RDWR);
+    REQUIRE(fd >= 0);
+    Cctr_File_Header_t header;
+    REQUIRE_EQ(sizeof(header), pread(fd, &header, sizeof(header), 0));
+    header.count = (uint64_t)UINT32_MAX + 1;
+    REQUIRE_EQ(sizeof(header), pwrite(fd, &header, sizeof(header), 0));
+    REQUIRE_EQ(0, ftruncate(fd, (off_t)(header.header_size + header.count)));
+    close(fd);
+    errno = 0;
+    CHECK(NULL == list_load(path));
+    CHECK_EQ(EINVAL, errno);
+    array_destroy(test_array);
+
+    unlink(path);
+}
@@ -0,0 +1,185 @@
+#include "tau/tau.h"
+#include "cctrlib/setop.h"
+
+#define TB_SETOP_RANGE 4096
+
+// a random sorted set of about n keys below TB_SETOP_RANGE, in a table and as dsize byte integers
+static uint64_t _tb_setop_make_(uint8_t *table, void *out, uint32_t dsize, uint32_t n, uint64_t *seed)
+{
+    memset(table, 0, TB_SETOP_RANGE);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        table[(*seed >> 33) % (dsize == 1 ? 256 : TB_SETOP_RANGE)] = 1;
+    }
+    uint64_t ret = 0;
+    for (uint64_t key = 0; key < TB_SETOP_RANGE; key++)
+        if (table[key])
+            memcpy((uint8_t *)out + ret++ * dsize, &key, dsize); // little endian
+    return ret;
+}
+
+static int _tb_setop_check_(const void *out, uint64_t n, uint32_t dsize, const uint8_t *ta, const uint8_t *tb, int op)
+{
+    uint64_t i = 0;
+    for (uint64_t key = 0; key < TB_SETOP_RANGE; key++)
+    {
+        int keep = op == 0 ? ta[key] | tb[key] : op == 1 ? ta[key] & tb[key] : op == 2 ? ta[key] & !tb[key] : ta[key] ^ tb[key];
+        if (!keep)
+            continue;
+        uint64_t got = 0;
+        if (i >= n)
+            return 0;
+        memcpy(&got, (const uint8_t *)out + i++ * dsize, dsize);
+        if (got != key)
+            return 0;
+    }
+    return i == n;
+}
+
+static int _tb_setop_cmp_(const void *a, const void *b, void *ctx)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+TEST(Setop, buffers)
+{
+    typedef uint64_t (*op_t)(void *, const void *, uint64_t, const void *, uint64_t, uint32_t, Cctr_Cmp_t, void *);
+    op_t ops[] = {cctr_set_union, cctr_set_intersection, cctr_set_difference, cctr_set_symmetric_difference};
+    const uint32_t sizes[][2] = {{0, 0}, {0, 50}, {50, 0}, {1, 1}, {300, 400}, {2000, 2000}, {3000, 20}, {15, 3000}, {4000, 4000}};
+    const uint32_t dsizes[] = {1, 2, 4, 8};
+    uint8_t ta[TB_SETOP_RANGE], tb[TB_SETOP_RANGE];
+    uint64_t *a = (uint64_t *)malloc(TB_SETOP_RANGE * sizeof(uint64_t));
+    uint64_t *b = (uint64_t *)malloc(TB_SETOP_RANGE * sizeof(uint64_t));
+    uint64_t *out = (uint64_t *)malloc(2 * TB_SETOP_RANGE * sizeof(uint64_t));
+    uint64_t seed = 11;
+
+    // every size pair for every integer width and through a comparator, the last pass
+    for (uint32_t d = 0; d < 5; d++)
+        for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            uint32_t dsize = d < 4 ? dsizes[d] : sizeof(uint64_t);
+            Cctr_Cmp_t cmp = d < 4 ? NULL : _tb_setop_cmp_;
+            uint64_t na = _tb_setop_make_(ta, a, dsize, sizes[s][0], &seed);
+            uint64_t nb = _tb_setop_make_(tb, b, dsize, sizes[s][1], &seed);
+            for (int op = 0; op < 4; op++)
+            {
+                uint64_t n = ops[op](out, a, na, b, nb, dsize, cmp, NULL);
+                REQUIRE(_tb_setop_check_(out, n, dsize, ta, tb, op));
+            }
+        }
+    free(a);
+    free(b);
+    free(out);
+}
+
+TEST(Setop, exact_bound)
+{
+    typedef uint64_t (*op_t)(void *, const void *, uint64_t, const void *, uint64_t, uint32_t, Cctr_Cmp_t, void *);
+    op_t ops[] = {cctr_set_union, cctr_set_intersection, cctr_set_difference, cctr_set_symmetric_difference};
+    const uint32_t sizes[][2] = {{8, 4}, {4, 8}, {1, 1}, {300, 400}, {2000, 2000}, {3000, 20}, {15, 3000}, {4000, 4000}};
+    const uint32_t dsizes[] = {1, 2, 4, 8};
+    uint8_t ta[TB_SETOP_RANGE], tb[TB_SETOP_RANGE];
+    uint64_t *a = (uint64_t *)malloc(TB_SETOP_RANGE * sizeof(uint64_t));
+    uint64_t *b = (uint64_t *)malloc(TB_SETOP_RANGE * sizeof(uint64_t));
+    uint64_t seed = 23;
+
+    // b inside a, every element of b matches before a runs out
+    uint32_t sa[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint32_t sb[4] = {4, 5, 6, 7};
+    uint32_t *out = (uint32_t *)malloc(4 * sizeof(uint32_t));
+    REQUIRE_EQ(4, cctr_set_intersection(out, sa, 8, sb, 4, sizeof(uint32_t), NULL, NULL));
+    for (uint32_t i = 0; i < 4; i++)
+        CHECK_EQ(sb[i], out[i]);
+    free(out);
+
+    // an output of exactly the documented room, one heap block each so an overrun is caught
+    for (uint32_t d = 0; d < 4; d++)
+        for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            uint32_t dsize = dsizes[d];
+            uint64_t na = _tb_setop_make_(ta, a, dsize, sizes[s][0], &seed);
+            uint64_t nb = _tb_setop_make_(tb, b, dsize, sizes[s][1], &seed);
+            uint64_t bound[] = {na + nb, na < nb ? na : nb, na, na + nb};
+            for (int op = 0; op < 4; op++)
+            {
+                uint8_t *exact = (uint8_t *)malloc(bound[op] * dsize + (bound[op] == 0));
+                uint64_t n = ops[op](exact, a, na, b, nb, dsize, NULL, NULL);
+                CHECK_LE(n, bound[op]);
+                REQUIRE(_tb_setop_check_(exact, n, dsize, ta, tb, op));
+                free(exact);
+            }
+        }
+
+    // the containers size their buffers from the same bounds
+    List_t *la = list_from_array(sa, 8, sizeof(uint32_t));
+    List_t *lb = list_from_array(sb, 4, sizeof(uint32_t));
+    List_t *ldst = list_init(sizeof(uint32_t));
+    list_set_intersection(ldst, la, lb, NULL, NULL);
+    REQUIRE_EQ(4, ldst->size);
+    CHECK_EQ(7, *(uint32_t *)list_back(ldst));
+    list_destroy(la);
+    list_destroy(lb);
+    list_destroy(ldst);
+    free(a);
+    free(b);
+}
+
+TEST(Setop, containers)
+{
+    Array_t *a = array_construct(sizeof(uint32_t));
+    Array_t *b = array_construct(sizeof(uint32_t));
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        uint32_t tmp = 3 * i;
+        array_push_back(a, &tmp);
+        tmp = 5 * i;
+        array_push_back(b, &tmp);
+    }
+
+    // appended behind what dst holds already
+    Array_t *dst = array_construct(sizeof(uint32_t));
+    uint32_t marker = 0xFFFFFFFF;
+    array_push_back(dst, &marker);
+    array_set_intersection(dst, a, b, NULL, NULL);
+    REQUIRE_EQ(1 + 200, dst->size);
+    CHECK_EQ(marker, *(uint32_t *)array_at(dst, 0));
+    for (uint32_t i = 0; i < 200; i++)
+        REQUIRE_EQ(15 * i, *(uint32_t *)array_at(dst, i + 1));
+    array_clear(dst);
+    array_set_union(dst, a, b, NULL, NULL);
+    CHECK_EQ(1000 + 1000 - 200, dst->size);
+    array_clear(dst);
+    array_set_difference(dst, a, b, NULL, NULL);
+    CHECK_EQ(800, dst->size);
+    array_clear(dst);
+    array_set_symmetric_difference(dst, a, b, NULL, NULL);
+    CHECK_EQ(1600, dst->size);
+
+    List_t *la = list_from_array(a->data, (uint32_t)a->size, sizeof(uint32_t));
+    List_t *lb = list_from_array(b->data, (uint32_t)b->size, sizeof(uint32_t));
+    List_t *ldst = list_init(sizeof(uint32_t));
+    list_set_intersection(ldst, la, lb, NULL, NULL);
+    REQUIRE_EQ(200, ldst->size);
+    CHECK_EQ(15 * 199, *(uint32_t *)list_back(ldst));
+    list_set_difference(ldst, la, lb, NULL, NULL);
+    CHECK_EQ(1000, ldst->size);
+    CHECK_EQ(3, *(uint32_t *)list_at(ldst, 200));
+    list_clear(ldst);
+    list_set_symmetric_difference(ldst, la, lb, NULL, NULL);
+    CHECK_EQ(1600, ldst->size);
+    list_clear(ldst);
+    list_set_union(ldst, la, lb, NULL, NULL);
+    REQUIRE_EQ(1800, ldst->size);
+    for (List_Node_t *ptr = ldst->head; ptr->next != NULL; ptr = ptr->next)
+        REQUIRE_LT(*(uint32_t *)ptr->data, *(uint32_t *)ptr->next->data);
+
+    list_destroy(la);
+    list_destroy(lb);
+    list_destroy(ldst);
+    array_destroy(a);
+    array_destroy(b);
+    array_destroy(dst);
+}
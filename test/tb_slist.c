@@ -0,0 +1,183 @@
+#include "tau/tau.h"
+#include "cctrlib/slist.h"
+
+static Slist_t *_tb_slist_fill_(uint32_t base, uint32_t len)
+{
+    Slist_t *ret = slist_construct(sizeof(uint32_t));
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint32_t tmp = base + i;
+        slist_push_back(ret, &tmp);
+    }
+    return ret;
+}
+
+TEST(Slist, insert_after_erase_after)
+{
+    const uint32_t test_base = 0x33221100;
+    const uint32_t test_len = 10;
+
+    Slist_t *test_list = _tb_slist_fill_(test_base, test_len);
+
+    // erase every odd element while walking once
+    for (Slist_Node_t *ptr = slist_begin(test_list); ptr != NULL; ptr = slist_next(ptr))
+        slist_erase_after(test_list, ptr);
+
+    CHECK_EQ(test_len / 2, test_list->size);
+    for (uint32_t i = 0; i < test_len / 2; i++)
+        CHECK_EQ(test_base + 2 * i, *(uint32_t *)slist_at(test_list, i));
+    CHECK_EQ(test_base + test_len - 2, *(uint32_t *)slist_back(test_list));
+
+    // put them back
+    for (Slist_Node_t *ptr = slist_begin(test_list); ptr != NULL; ptr = slist_next(ptr))
+    {
+        uint32_t tmp = *(uint32_t *)ptr->data + 1;
+        ptr = slist_insert_after(test_list, ptr, &tmp);
+    }
+
+    CHECK_EQ(test_len, test_list->size);
+    for (uint32_t i = 0; i < test_len; i++)
+        CHECK_EQ(test_base + i, *(uint32_t *)slist_at(test_list, i));
+    CHECK_EQ(test_base + test_len - 1, *(uint32_t *)slist_back(test_list));
+
+    // NULL refers to the position before head
+    slist_erase_after(test_list, NULL);
+    CHECK_EQ(test_base + 1, *(uint32_t *)slist_front(test_list));
+
+    slist_destroy(test_list);
+}
+
+TEST(Slist, insert_erase)
+{
+    const uint32_t test_base = 0x33221100;
+
+    Slist_t *test_list = slist_construct(sizeof(uint32_t));
+
+    uint32_t tmp = test_base + 1;
+    slist_insert(test_list, 0, &tmp);
+    tmp = test_base + 3;
+    slist_insert(test_list, 1, &tmp);
+    tmp = test_base + 0;
+    slist_insert(test_list, 0, &tmp);
+    tmp = test_base + 2;
+    slist_insert(test_list, 2, &tmp);
+
+    REQUIRE_EQ(4, test_list->size);
+    for (uint32_t i = 0; i < 4; i++)
+        CHECK_EQ(test_base + i, *(uint32_t *)slist_at(test_list, i));
+    CHECK(NULL == slist_at(test_list, 4));
+
+    slist_erase(test_list, 3);
+    CHECK_EQ(test_base + 2, *(uint32_t *)slist_back(test_list));
+    slist_erase(test_list, 1);
+    slist_erase(test_list, 0);
+    CHECK_EQ(1, test_list->size);
+    CHECK_EQ(test_base + 2, *(uint32_t *)slist_front(test_list));
+    slist_erase(test_list, 0);
+    CHECK(NULL == test_list->head);
+    CHECK(NULL == test_list->tail);
+
+    slist_destroy(test_list);
+}
+
+TEST(Slist, splice_reverse)
+{
+    const uint32_t test_base = 0x33221100;
+    const uint32_t test_len = 10;
+
+    Slist_t *test_list = _tb_slist_fill_(test_base, test_len / 2);
+    Slist_t *object = _tb_slist_fill_(test_base + test_len / 2, test_len / 2);
+
+    slist_splice(test_list, object);
+    CHECK_EQ(0, object->size);
+    CHECK(NULL == object->head);
+    REQUIRE_EQ(test_len, test_list->size);
+
+    slist_reverse(test_list);
+    uint32_t i = test_len;
+    for (Slist_Node_t *ptr = slist_begin(test_list); ptr != NULL; ptr = slist_next(ptr))
+        CHECK_EQ(test_base + --i, *(uint32_t *)ptr->data);
+    CHECK_EQ(test_base, *(uint32_t *)slist_back(test_list));
+
+    // splice onto an empty list takes over head and tail
+    slist_splice(object, test_list);
+    CHECK_EQ(test_len, object->size);
+    CHECK_EQ(test_base, *(uint32_t *)slist_back(object));
+
+    slist_destroy(test_list);
+    slist_destroy(object);
+}
+
+TEST(Slist, pop_front_n)
+{
+    const uint32_t test_base = 0x33221100;
+    const uint32_t test_len = 10;
+
+    Slist_t *test_list = _tb_slist_fill_(test_base, test_len);
+
+    Slist_t *chain = slist_split_front(test_list, 3);
+    CHECK_EQ(3, chain->size);
+    CHECK_EQ(test_len - 3, test_list->size);
+    CHECK_EQ(test_base + 2, *(uint32_t *)slist_back(chain));
+    CHECK(NULL == chain->tail->next);
+    CHECK_EQ(test_base + 3, *(uint32_t *)slist_front(test_list));
+    slist_destroy(chain);
+
+    chain = slist_split_front(test_list, test_len);
+    CHECK_EQ(test_len - 3, chain->size);
+    CHECK_EQ(0, test_list->size);
+    CHECK(NULL == test_list->tail);
+    slist_destroy(chain);
+
+    slist_destroy(test_list);
+}
+
+TEST(Slist, copy)
+{
+    Slist_t *test_list = _tb_slist_fill_(0x33221100, 1);
+    Slist_t *cpy = slist_copy(test_list);
+    CHECK_EQ(1, cpy->size);
+    CHECK(cpy->head == cpy->tail);
+    CHECK_EQ(0x33221100, *(uint32_t *)slist_back(cpy));
+    slist_destroy(cpy);
+    slist_destroy(test_list);
+}
+
+TEST(Slist, small_payload)
+{
+    // up to 8 bytes the payload sits behind its node in the same allocation
+    Slist_t *test_list = _tb_slist_fill_(0, 4);
+    for (Slist_Node_t *ptr = test_list->head; ptr != NULL; ptr = ptr->next)
+        CHECK((uint8_t *)ptr->data == (uint8_t *)ptr + sizeof(Slist_Node_t));
+    CHECK_EQ(2, *(uint32_t *)slist_at(test_list, 2));
+    slist_pop_front(test_list);
+    CHECK_EQ(1, *(uint32_t *)slist_front(test_list));
+    slist_destroy(test_list);
+}
+
+TEST(Slist, huge)
+{
+    const uint32_t test_len = 200000;
+    Slist_t *test_list = slist_construct_huge(sizeof(uint32_t));
+    REQUIRE(test_list->huge != NULL);
+    for (uint32_t i = 0; i < test_len; i++)
+        slist_push_back(test_list, &i);
+    CHECK(test_list->head->block != test_list->tail->block);
+    uint32_t batch[3] = {10, 11, 12};
+    slist_push_front_n(test_list, batch, 3);
+    CHECK(test_list->head->block == test_list->head->next->block);
+    CHECK_EQ(11, *(uint32_t *)slist_at(test_list, 1));
+    CHECK_EQ(test_len - 1, *(uint32_t *)slist_back(test_list));
+
+    Slist_t *cpy = slist_copy(test_list);
+    CHECK(cpy->huge != NULL);
+    Slist_t *all = slist_split_front(cpy, cpy->size);
+    CHECK(all->huge == NULL);
+    CHECK_EQ(test_len + 3, all->size);
+    CHECK_EQ(5, *(uint32_t *)slist_at(all, 8));
+    slist_push_back(cpy, &batch[0]);
+    CHECK_EQ(10, *(uint32_t *)slist_front(cpy));
+    slist_destroy(all);
+    slist_destroy(cpy);
+    slist_destroy(test_list);
+}
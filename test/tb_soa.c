@@ -0,0 +1,140 @@
+#include "tau/tau.h"
+#include "cctrlib/soa.h"
+
+typedef struct
+{
+    uint64_t id;
+    uint32_t key;
+    uint16_t kind;
+    uint8_t flag;
+    uint8_t pad;
+    uint8_t name[12];
+} Tb_Row_t;
+
+static const Soa_Field_t _tb_fields_[] = {
+    {offsetof(Tb_Row_t, id), sizeof(uint64_t)},
+    {offsetof(Tb_Row_t, key), sizeof(uint32_t)},
+    {offsetof(Tb_Row_t, kind), sizeof(uint16_t)},
+    {offsetof(Tb_Row_t, flag), sizeof(uint8_t)},
+    {offsetof(Tb_Row_t, name), 12},
+};
+
+static Tb_Row_t _tb_row_(uint64_t i)
+{
+    Tb_Row_t row;
+    memset(&row, 0, sizeof(row));
+    row.id = i;
+    row.key = (uint32_t)(i % 97);
+    row.kind = (uint16_t)(i % 5);
+    row.flag = (uint8_t)(i % 3 == 0);
+    memcpy(row.name, "row-", 4);
+    row.name[4] = (uint8_t)('a' + i % 26);
+    return row;
+}
+
+TEST(Soa, push_gather_erase)
+{
+    const uint64_t test_len = 1000;
+    Soa_t *test_soa = soa_construct(sizeof(Tb_Row_t), _tb_fields_, 5);
+    for (uint64_t i = 0; i < test_len; i++)
+    {
+        Tb_Row_t row = _tb_row_(i);
+        row.pad = 0xff; // outside every field like the tail padding, gathered as zero
+        soa_push_back(test_soa, &row);
+    }
+    CHECK_EQ(test_len, test_soa->size);
+    CHECK_EQ(sizeof(Tb_Row_t) - 27, test_soa->gaps);
+    for (uint32_t i = 0; i < test_soa->nfields; i++)
+        CHECK_EQ(0, (uintptr_t)soa_column(test_soa, i) % CCTR_SOA_ALIGN);
+
+    Tb_Row_t row;
+    for (uint64_t i = 0; i < test_len; i++)
+    {
+        Tb_Row_t expect = _tb_row_(i);
+        soa_gather(test_soa, i, &row);
+        REQUIRE_BUF_EQ(&expect, &row, sizeof(row));
+    }
+    CHECK_EQ(7 % 97, *(uint32_t *)soa_field(test_soa, 1, 7));
+
+    // every column moves the same way
+    soa_erase(test_soa, 0);
+    soa_erase_range(test_soa, 100, 200);
+    soa_pop_back(test_soa);
+    CHECK_EQ(test_len - 102, test_soa->size);
+    for (uint64_t i = 0; i < test_soa->size; i++)
+    {
+        Tb_Row_t expect = _tb_row_(i < 100 ? i + 1 : i + 101);
+        soa_gather(test_soa, i, &row);
+        REQUIRE_BUF_EQ(&expect, &row, sizeof(row));
+    }
+
+    // batch append and overwrite
+    Tb_Row_t batch[300];
+    for (uint64_t i = 0; i < 300; i++)
+        batch[i] = _tb_row_(5000 + i);
+    soa_push_back_n(test_soa, batch, 300);
+    CHECK_EQ(test_len - 102 + 300, test_soa->size);
+    soa_gather(test_soa, test_soa->size - 1, &row);
+    CHECK_BUF_EQ(&batch[299], &row, sizeof(row));
+    soa_set(test_soa, 3, &batch[0]);
+    soa_gather(test_soa, 3, &row);
+    CHECK_BUF_EQ(&batch[0], &row, sizeof(row));
+
+    soa_clear(test_soa);
+    CHECK_EQ(0, test_soa->size);
+    soa_destroy(test_soa);
+}
+
+TEST(Soa, find_count_filter)
+{
+    // lengths around the 64 byte rounds, every field size
+    for (uint64_t test_len = 0; test_len < 300; test_len += 37)
+    {
+        List_t *test_list = list_init(sizeof(Tb_Row_t));
+        for (uint64_t i = 0; i < test_len; i++)
+        {
+            Tb_Row_t row = _tb_row_(i);
+            list_push_back(test_list, &row);
+        }
+        Soa_t *test_soa = soa_from_list(test_list, _tb_fields_, 5);
+        REQUIRE_EQ(test_len, test_soa->size);
+        uint64_t *rows = (uint64_t *)malloc((test_len + 1) * sizeof(uint64_t));
+
+        for (uint64_t probe = 0; probe < 30; probe++)
+        {
+            Tb_Row_t value = _tb_row_(probe);
+            for (uint32_t f = 0; f < 5; f++)
+            {
+                const uint8_t *v = (const uint8_t *)&value + _tb_fields_[f].offset;
+                // against list_find_data_range and a plain walk
+                int64_t first = -1;
+                uint64_t count = 0;
+                uint64_t last = 0;
+                for (uint64_t i = 0; i < test_len; i++)
+                {
+                    Tb_Row_t row = _tb_row_(i);
+                    if (!memcmp((uint8_t *)&row + _tb_fields_[f].offset, v, _tb_fields_[f].size))
+                    {
+                        first = first < 0 ? (int64_t)i : first;
+                        count++;
+                        last = i;
+                    }
+                }
+                REQUIRE_EQ(first, soa_find(test_soa, f, v, 0));
+                REQUIRE_EQ(first, (int64_t)list_find_data_range(test_list, (void *)v, _tb_fields_[f].offset, _tb_fields_[f].size));
+                REQUIRE_EQ(count, soa_count(test_soa, f, v));
+                REQUIRE_EQ(count, soa_filter(test_soa, f, v, rows));
+                for (uint64_t i = 1; i < count; i++)
+                    REQUIRE_LT(rows[i - 1], rows[i]);
+                if (count > 0)
+                {
+                    CHECK_EQ(last, rows[count - 1]);
+                    CHECK_EQ(count > 1 ? (int64_t)rows[1] : -1, soa_find(test_soa, f, v, rows[0] + 1));
+                }
+            }
+        }
+        free(rows);
+        soa_destroy(test_soa);
+        list_destroy(test_list);
+    }
+}
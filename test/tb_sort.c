@@ -0,0 +1,146 @@
+#include "tau/tau.h"
+#include "cctrlib/sort.h"
+
+typedef struct
+{
+    int32_t key;
+    uint32_t seq; // input position, to check stability
+} Tb_Record_t;
+
+static int _tb_cmp_record_(const void *a, const void *b, void *ctx)
+{
+    int32_t ka = ((const Tb_Record_t *)a)->key;
+    int32_t kb = ((const Tb_Record_t *)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+static int _tb_cmp_uint64_(const void *a, const void *b, void *ctx)
+{
+    uint64_t ka = *(const uint64_t *)a;
+    uint64_t kb = *(const uint64_t *)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static uint64_t _tb_rand_(uint64_t *state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 33;
+}
+
+static void _tb_check_records_(Tb_Record_t *records, uint64_t len)
+{
+    for (uint64_t i = 1; i < len; i++)
+    {
+        REQUIRE_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key)
+            REQUIRE_LT(records[i - 1].seq, records[i].seq);
+    }
+}
+
+TEST(Sort, array)
+{
+    const uint32_t test_lens[] = {0, 1, 2, 15, 17, 100, 1000, 10007};
+    Cctr_Pool_t *test_pool = cctr_pool_construct(4);
+    uint64_t seed = 1;
+
+    for (uint32_t l = 0; l < sizeof(test_lens) / sizeof(test_lens[0]); l++)
+        for (int by_key = 0; by_key < 2; by_key++)
+            for (int threaded = 0; threaded < 2; threaded++)
+            {
+                Array_t *test_array = array_construct(sizeof(Tb_Record_t));
+                for (uint32_t i = 0; i < test_lens[l]; i++)
+                {
+                    // few distinct keys, negative ones included
+                    Tb_Record_t tmp = {(int32_t)(_tb_rand_(&seed) % 200) - 100, i};
+                    array_push_back(test_array, &tmp);
+                }
+
+                if (by_key)
+                    array_sort_key(test_array, threaded ? test_pool : NULL, 0, sizeof(int32_t), CCTR_SORT_SIGNED);
+                else
+                    array_sort(test_array, threaded ? test_pool : NULL, _tb_cmp_record_, NULL);
+
+                CHECK_EQ(test_lens[l], test_array->size);
+                _tb_check_records_((Tb_Record_t *)test_array->data, test_array->size);
+                array_destroy(test_array);
+            }
+
+    // unsigned 64 bit keys, upper bytes shared so radix passes are skipped
+    Array_t *test_array = array_construct(sizeof(uint64_t));
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        uint64_t tmp = 0x1122334400000000ULL | _tb_rand_(&seed) % 100000;
+        array_push_back(test_array, &tmp);
+    }
+    Array_t *test_copy = array_copy(test_array);
+    array_sort_key(test_array, test_pool, 0, sizeof(uint64_t), 0);
+    array_sort(test_copy, test_pool, _tb_cmp_uint64_, NULL);
+    CHECK_EQ(0, memcmp(test_array->data, test_copy->data, 5000 * sizeof(uint64_t)));
+    for (uint32_t i = 1; i < 5000; i++)
+        REQUIRE_LE(*(uint64_t *)array_at(test_array, i - 1), *(uint64_t *)array_at(test_array, i));
+    array_destroy(test_copy);
+    array_destroy(test_array);
+
+    cctr_pool_destroy(test_pool);
+}
+
+TEST(Sort, list)
+{
+    const uint32_t test_len = 5003;
+    Cctr_Pool_t *test_pool = cctr_pool_construct(3);
+    uint64_t seed = 7;
+
+    for (int by_key = 0; by_key < 2; by_key++)
+    {
+        List_t *test_list = list_init(sizeof(Tb_Record_t));
+        for (uint32_t i = 0; i < test_len; i++)
+        {
+            Tb_Record_t tmp = {(int32_t)(_tb_rand_(&seed) % 1000) - 500, i};
+            list_push_back(test_list, &tmp);
+        }
+        void *test_front = test_list->head->data;
+
+        if (by_key)
+            list_sort_key(test_list, test_pool, 0, sizeof(int32_t), CCTR_SORT_SIGNED);
+        else
+            list_sort(test_list, test_pool, _tb_cmp_record_, NULL);
+
+        // nodes are relinked, payloads stay where they were
+        REQUIRE_EQ(test_len, test_list->size);
+        CHECK(test_list->head->prev == NULL);
+        CHECK(test_list->tail->next == NULL);
+        int found = 0;
+        uint32_t count = 0;
+        for (List_Node_t *ptr = test_list->head; ptr != NULL; ptr = ptr->next, count++)
+        {
+            found |= ptr->data == test_front;
+            if (ptr->next != NULL)
+            {
+                REQUIRE(ptr->next->prev == ptr);
+                Tb_Record_t *a = (Tb_Record_t *)ptr->data;
+                Tb_Record_t *b = (Tb_Record_t *)ptr->next->data;
+                REQUIRE_LE(a->key, b->key);
+                if (a->key == b->key)
+                    REQUIRE_LT(a->seq, b->seq);
+            }
+        }
+        CHECK_EQ(test_len, count);
+        CHECK(found);
+        CHECK(test_list->tail->data == list_back(test_list));
+        list_destroy(test_list);
+    }
+
+    // short lists
+    List_t *test_list = list_init(sizeof(Tb_Record_t));
+    list_sort(test_list, test_pool, _tb_cmp_record_, NULL);
+    Tb_Record_t tmp = {5, 0};
+    list_push_back(test_list, &tmp);
+    tmp.key = -5;
+    list_push_back(test_list, &tmp);
+    list_sort_key(test_list, NULL, 0, sizeof(int32_t), CCTR_SORT_SIGNED);
+    CHECK_EQ(-5, ((Tb_Record_t *)list_front(test_list))->key);
+    CHECK_EQ(5, ((Tb_Record_t *)list_back(test_list))->key);
+    list_destroy(test_list);
+
+    cctr_pool_destroy(test_pool);
+}
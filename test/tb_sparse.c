@@ -0,0 +1,141 @@
+#include "tau/tau.h"
+#include "cctrlib/sparse.h"
+
+typedef struct
+{
+    uint64_t sum;
+    uint64_t last;
+    uint32_t ordered;
+} Tb_Sparse_Visit_t;
+
+static void _tb_sparse_visit_(uint32_t key, void *data, void *ctx)
+{
+    Tb_Sparse_Visit_t *visit = (Tb_Sparse_Visit_t *)ctx;
+    visit->ordered &= visit->sum == 0 || key > visit->last;
+    visit->sum += *(uint64_t *)data;
+    visit->last = key;
+}
+
+TEST(Sparse, set_get_erase)
+{
+    // keys from a small pool spread over the whole key space, the pool is the model
+    const uint32_t test_len = 3000;
+    uint32_t *keys = (uint32_t *)malloc(test_len * sizeof(uint32_t));
+    uint64_t *values = (uint64_t *)calloc(test_len, sizeof(uint64_t));
+    uint8_t *used = (uint8_t *)calloc(test_len, 1);
+    uint64_t seed = 11;
+    const uint32_t edges[] = {0, 1, 1023, 1024, UINT32_MAX, UINT32_MAX - 1, 1u << 20, 1u << 31};
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        int dup = 1;
+        while (dup)
+        {
+            // edges first, then clusters next to spread keys
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            if (i < 8)
+                keys[i] = edges[i];
+            else if (i % 3 == 0)
+                keys[i] = keys[i - 1] + 1 + (uint32_t)(seed >> 61);
+            else
+                keys[i] = (uint32_t)(seed >> 32);
+            dup = 0;
+            for (uint32_t j = 0; j < i && !dup; j++)
+                dup = keys[j] == keys[i];
+        }
+    }
+    Sparse_t *test_sparse = sparse_construct(sizeof(uint64_t));
+    CHECK(NULL == sparse_get(test_sparse, 0));
+    CHECK_EQ(0, sparse_erase(test_sparse, UINT32_MAX));
+
+    uint64_t size = 0;
+    for (uint32_t round = 0; round < 20000; round++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t i = (uint32_t)(seed >> 33) % test_len;
+        if ((seed >> 20) % 3)
+        {
+            values[i] = seed;
+            sparse_set(test_sparse, keys[i], &values[i]);
+            size += !used[i];
+            used[i] = 1;
+        }
+        else
+        {
+            REQUIRE_EQ(used[i], sparse_erase(test_sparse, keys[i]));
+            size -= used[i];
+            used[i] = 0;
+        }
+        REQUIRE_EQ(size, test_sparse->size);
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        uint64_t *data = (uint64_t *)sparse_get(test_sparse, keys[i]);
+        if (used[i])
+        {
+            REQUIRE(data != NULL);
+            REQUIRE_EQ(values[i], *data);
+            sum += values[i];
+        }
+        else
+            REQUIRE(data == NULL);
+    }
+
+    // both iterations see every set key once in order
+    Tb_Sparse_Visit_t visit = {0, 0, 1};
+    CHECK_EQ(size, sparse_for_each(test_sparse, _tb_sparse_visit_, &visit));
+    CHECK_EQ(sum, visit.sum);
+    CHECK(visit.ordered);
+    uint64_t n = 0, next_sum = 0, prev = 0;
+    void *data;
+    for (uint64_t key = 0; (data = sparse_next(test_sparse, &key)) != NULL; key++)
+    {
+        REQUIRE(n == 0 || key > prev);
+        REQUIRE(data == sparse_get(test_sparse, (uint32_t)key));
+        next_sum += *(uint64_t *)data;
+        prev = key;
+        n++;
+    }
+    CHECK_EQ(size, n);
+    CHECK_EQ(sum, next_sum);
+
+    // pages are freed with their last key
+    for (uint32_t i = 0; i < test_len; i++)
+        if (used[i])
+            sparse_erase(test_sparse, keys[i]);
+    CHECK_EQ(0, test_sparse->size);
+    CHECK_EQ(0, test_sparse->pages);
+    for (uint32_t d = 0; d < (1u << CCTR_SPARSE_DIR_BITS); d++)
+        REQUIRE(NULL == test_sparse->dir[d]);
+
+    free(keys);
+    free(values);
+    free(used);
+    sparse_destroy(test_sparse);
+}
+
+TEST(Sparse, pages)
+{
+    Sparse_t *test_sparse = sparse_construct(3);
+    uint8_t *slot = (uint8_t *)sparse_set(test_sparse, 5000, NULL);
+    CHECK_EQ(0, slot[0] | slot[1] | slot[2]);
+    sparse_set(test_sparse, 5000 + 1, "abc");
+    sparse_set(test_sparse, 5000 + 2000, "def");
+    CHECK_EQ(3, test_sparse->size);
+    CHECK_EQ(2, test_sparse->pages);
+    CHECK_BUF_EQ("abc", sparse_get(test_sparse, 5001), 3);
+
+    uint64_t key = 5002;
+    CHECK_BUF_EQ("def", sparse_next(test_sparse, &key), 3);
+    CHECK_EQ(7000, key);
+    key = 7001;
+    CHECK(NULL == sparse_next(test_sparse, &key));
+
+    sparse_erase(test_sparse, 7000);
+    CHECK_EQ(1, test_sparse->pages);
+    sparse_clear(test_sparse);
+    CHECK_EQ(0, test_sparse->pages);
+    CHECK(NULL == sparse_get(test_sparse, 5000));
+    sparse_destroy(test_sparse);
+}
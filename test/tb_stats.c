@@ -0,0 +1,113 @@
+#include "tau/tau.h"
+#include "cctrlib/list.h"
+
+// only built in with make STATS=1
+#ifdef CCTR_STATS
+
+static void _tb_count_(const Cctr_Stats_t *stats, void *ctx)
+{
+    (void)stats;
+    (*(uint32_t *)ctx)++;
+}
+
+TEST(Stats, list_counters)
+{
+    const uint32_t test_len = 10;
+
+    List_t *test_list = list_init(sizeof(uint32_t));
+    for (uint32_t i = 0; i < test_len; i++)
+        list_push_back(test_list, &i);
+
+    uint32_t key = 7;
+    CHECK_EQ(7, list_find(test_list, &key));
+    CHECK(NULL != list_at(test_list, 5));
+    list_pop_front(test_list);
+
+    Cctr_Stats_t snapshot;
+    list_stats(test_list, &snapshot);
+    CHECK_EQ(test_len, snapshot.ops[CCTR_OP_PUSH_BACK]);
+    CHECK_EQ(test_len, snapshot.allocs); // payloads of up to 8 bytes live in the node
+    CHECK_EQ(1, snapshot.frees);
+    CHECK_EQ(test_len, snapshot.size_peak);
+    CHECK_EQ(8, snapshot.walked[CCTR_OP_FIND]);
+    CHECK_EQ(5, snapshot.walked[CCTR_OP_AT]);
+    CHECK_EQ((int64_t)((test_len - 1) * (sizeof(List_Node_t) + sizeof(uint32_t))), snapshot.bytes_live);
+    CHECK(NULL == snapshot.next);
+
+    uint32_t before = 0;
+    cctr_stats_foreach(_tb_count_, &before);
+
+    List_t *cpy = list_copy(test_list);
+    list_insert_list(test_list, 3, cpy);
+    CHECK_EQ(2 * (test_len - 1), test_list->size);
+    list_stats(test_list, &snapshot);
+    CHECK_EQ(2 * (test_len - 1), snapshot.size_peak);
+    CHECK_EQ(test_len + (test_len - 1), snapshot.allocs); // the moved nodes count one allocation each too
+
+    uint32_t after = 0;
+    cctr_stats_foreach(_tb_count_, &after);
+    CHECK_EQ(before + 1, after);
+
+    list_clear(test_list);
+    list_stats(test_list, &snapshot);
+    CHECK_EQ(snapshot.allocs, snapshot.frees);
+    list_destroy(cpy);
+    list_destroy(test_list);
+
+    after = 0;
+    cctr_stats_foreach(_tb_count_, &after);
+    CHECK_EQ(before - 1, after);
+}
+
+static uint32_t _tb_far_hops_(List_t *list)
+{
+    uint32_t ret = 0;
+    for (List_Node_t *ptr = list->head; ptr->next != NULL; ptr = ptr->next)
+    {
+        uintptr_t a = (uintptr_t)ptr;
+        uintptr_t b = (uintptr_t)ptr->next;
+        ret += (a > b ? a - b : b - a) > CCTR_STATS_FAR;
+    }
+    return ret;
+}
+
+TEST(Stats, compact_auto)
+{
+    const uint32_t test_len = 4096;
+
+    // inserted at scattered positions, list order is far from allocation order
+    List_t *test_list = list_init(sizeof(uint32_t));
+    uint32_t tmp = 0;
+    list_push_back(test_list, &tmp);
+    for (uint32_t i = 1; i < test_len; i++)
+        list_insert(test_list, (int64_t)((i * 2654435761u) % (test_list->size + 1)), &i);
+    list_compact_auto(test_list, 0.5);
+
+    uint32_t far = _tb_far_hops_(test_list);
+    REQUIRE_GT(far, test_len / 2);
+
+    uint32_t key = test_len;
+    CHECK_EQ(-1, list_find(test_list, &key));
+    Cctr_Stats_t snapshot;
+    list_stats(test_list, &snapshot);
+    CHECK_EQ(test_len - 1, snapshot.hops);
+    CHECK_EQ(far, snapshot.hops_far);
+    CHECK_EQ(0, snapshot.ops[CCTR_OP_COMPACT]);
+
+    // the second walk crosses the size, the list gets compacted
+    CHECK_EQ(-1, list_find(test_list, &key));
+    list_stats(test_list, &snapshot);
+    CHECK_EQ(1, snapshot.ops[CCTR_OP_COMPACT]);
+    CHECK_EQ(0, snapshot.hops);
+    CHECK_EQ(0, _tb_far_hops_(test_list));
+
+    key = *(uint32_t *)list_at(test_list, 10);
+    CHECK_EQ(10, list_find(test_list, &key));
+    list_stats(test_list, &snapshot);
+    CHECK_EQ(10, snapshot.hops);
+    CHECK_EQ(0, snapshot.hops_far);
+
+    list_destroy(test_list);
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include <unistd.h>
+#include "tau/tau.h"
+#include "cctrlib/serialize.h"
+#include "cctrlib/stream.h"
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t key;
+    uint64_t payload;
+} Tb_Record_t;
+
+TEST(Stream, push_back_iterate_find)
+{
+    const uint32_t test_len = 10000;
+    const uint32_t chunk_len = 64;
+
+    Stream_t *test_stream = stream_construct(sizeof(Tb_Record_t), chunk_len, NULL);
+    REQUIRE(test_stream != NULL);
+    for (uint32_t i = 0; i < test_len; i++)
+    {
+        Tb_Record_t rec = {i, i * 7, 0x7766554433221100 + i};
+        REQUIRE_EQ(0, stream_push_back(test_stream, &rec));
+    }
+    CHECK_EQ(test_len, test_stream->size);
+    CHECK_LE(test_stream->size - test_stream->flushed, chunk_len);
+
+    Stream_Iter_t iter;
+    stream_iter_begin(test_stream, &iter, 0);
+    uint32_t i = 0;
+    for (Tb_Record_t *rec; (rec = (Tb_Record_t *)stream_iter_next(&iter)) != NULL; i++)
+        CHECK_EQ(i, rec->id);
+    stream_iter_end(&iter);
+    CHECK_EQ(test_len, i);
+
+    uint32_t key = 7 * 5000;
+    CHECK_EQ(5000, stream_find_data_range(test_stream, &key, sizeof(uint32_t), sizeof(uint32_t)));
+    key = test_len - 1; // in the tail
+    CHECK_EQ(test_len - 1, stream_find_data_range(test_stream, &key, 0, sizeof(uint32_t)));
+    key = 3;
+    CHECK_EQ(-1, stream_find_data_range(test_stream, &key, sizeof(uint32_t), sizeof(uint32_t)));
+
+    Tb_Record_t rec;
+    REQUIRE_EQ(0, stream_at(test_stream, 1234, &rec));
+    CHECK_EQ(0x7766554433221100 + 1234, rec.payload);
+    CHECK_EQ(-1, stream_at(test_stream, test_len, &rec));
+
+    stream_destroy(test_stream);
+}
+
+TEST(Stream, file_is_container_file)
+{
+    const uint32_t test_len = 1000;
+    char path[] = "/tmp/tb_cctr_stream_XXXXXX";
+    close(mkstemp(path));
+
+    Stream_t *test_stream = stream_construct(sizeof(uint32_t), 100, path);
+    REQUIRE(test_stream != NULL);
+    for (uint32_t i = 0; i < test_len; i++)
+        stream_push_back(test_stream, &i);
+    REQUIRE_EQ(0, stream_flush(test_stream));
+    stream_destroy(test_stream);
+
+    Array_t *view = array_map(path);
+    REQUIRE(view != NULL);
+    REQUIRE_EQ(test_len, view->size);
+    for (uint32_t i = 0; i < test_len; i++)
+        CHECK_EQ(i, *(uint32_t *)array_at(view, i));
+
+    array_destroy(view);
+    unlink(path);
+}